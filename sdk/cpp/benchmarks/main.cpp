@@ -0,0 +1,4 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#define CATCH_CONFIG_MAIN
+#include "catch2/catch.hpp"
@@ -0,0 +1,77 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <chrono>
+#include <thread>
+
+#include "catch2/catch.hpp"
+#include "httplib.h"
+#include "touca/client/detail/client.hpp"
+
+/**
+ * Local stand-in for the Touca server that accepts submissions after a
+ * fixed delay, to mimic the time the server takes to process them.
+ */
+struct StandInServer {
+  explicit StandInServer(const std::chrono::milliseconds delay) {
+    server.Post("/client/signin",
+                [](const httplib::Request&, httplib::Response& res) {
+                  res.set_content(R"({"token":"some-token"})",
+                                  "application/json");
+                });
+    server.Post("/client/submit",
+                [delay](const httplib::Request&, httplib::Response& res) {
+                  std::this_thread::sleep_for(delay);
+                  res.status = 204;
+                });
+    port = server.bind_to_any_port("127.0.0.1");
+    thread = std::thread([this]() { server.listen_after_bind(); });
+    while (!server.is_running()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  ~StandInServer() {
+    server.stop();
+    thread.join();
+  }
+
+  std::string url() const {
+    return "http://127.0.0.1:" + std::to_string(port) +
+           "/@/some-team/some-suite/1.0";
+  }
+
+  httplib::Server server;
+  std::thread thread;
+  int port = -1;
+};
+
+/**
+ * Submits results of 100 testcases, in groups of 10, to a server that
+ * takes 5 ms to process each group.
+ */
+static bool post_testcases(touca::ClientImpl& client) {
+  for (auto i = 0u; i < 100u; ++i) {
+    client.declare_testcase(std::to_string(i));
+    client.check("some-key", touca::data_point::number_unsigned(i));
+  }
+  return client.post();
+}
+
+TEST_CASE("submitting test results") {
+  StandInServer server(std::chrono::milliseconds(5));
+
+  for (const auto max_inflight : {1u, 4u}) {
+    touca::ClientOptions options;
+    options.api_url = server.url();
+    options.api_key = "some-key";
+    options.testcases = {"0"};
+    options.max_inflight = max_inflight;
+    touca::ClientImpl client;
+    REQUIRE(client.configure(options));
+
+    BENCHMARK("100 testcases, " + std::to_string(max_inflight) +
+              " connections") {
+      return post_testcases(client);
+    };
+  }
+}
@@ -0,0 +1,73 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/runner/runner.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/runner/detail/helpers.hpp"
+#include "touca/touca.hpp"
+
+/**
+ * Runs the test framework with a workflow that does nothing, so that the
+ * measured time is the overhead of the framework itself. Divide the
+ * reported mean by `testcase_count` to get the overhead per testcase.
+ */
+struct EmptyRun {
+  EmptyRun(const unsigned testcase_count) {
+    for (auto i = 0u; i < testcase_count; ++i) {
+      testcases += (i ? "," : "") + std::to_string(i);
+    }
+    touca::workflow("empty_workflow", [](const std::string&) {});
+  }
+
+  ~EmptyRun() { touca::reset_test_runner(); }
+
+  int call_with(const std::vector<std::string>& extra) {
+    std::vector<std::string> args = {"--offline",
+                                     "-r",
+                                     "1.0",
+                                     "-o",
+                                     outputDir.path.string(),
+                                     "--team",
+                                     "some-team",
+                                     "--suite",
+                                     "some-suite",
+                                     "--testcase",
+                                     testcases,
+                                     "--skip-logs",
+                                     "--colored-output=false"};
+    args.insert(args.end(), extra.begin(), extra.end());
+    std::vector<char*> argv;
+    argv.push_back((char*)"myapp");
+    for (const auto& arg : args) {
+      argv.push_back((char*)arg.data());
+    }
+    argv.push_back(nullptr);
+    touca::OutputCapturer capturer;
+    capturer.start_capture();
+    const auto exit_status = touca::run(argv.size() - 1, argv.data());
+    capturer.stop_capture();
+    return exit_status;
+  }
+
+  TmpFile outputDir;
+  std::string testcases;
+};
+
+TEST_CASE("runner overhead per empty testcase") {
+  constexpr auto testcase_count = 100u;
+  EmptyRun run(testcase_count);
+
+  BENCHMARK("100 testcases, fresh output directory") {
+    touca::filesystem::remove_all(run.outputDir.path);
+    return run.call_with({});
+  };
+
+  BENCHMARK("100 testcases, existing output directory") {
+    return run.call_with({"--overwrite"});
+  };
+
+  BENCHMARK("100 testcases, all skipped") {
+    return run.call_with({});
+  };
+}
@@ -10,6 +10,7 @@ usage: $(basename "$0") [ -h | --long-options]
   --with-tests              include client library unittests in build
   --with-cli                include client-side utility application in build
   --with-examples           include sample regression test tool in build
+  --with-benchmarks         include performance benchmarks in build
   --without-framework       exclude regression test framework
   --all                     include all components
 
@@ -206,6 +207,7 @@ build_build () {
         -DTOUCA_BUILD_TESTS="$(cmake_option "with-tests")"
         -DTOUCA_BUILD_CLI="$(cmake_option "with-cli")"
         -DTOUCA_BUILD_EXAMPLES="$(cmake_option "with-examples")"
+        -DTOUCA_BUILD_BENCHMARKS="$(cmake_option "with-benchmarks")"
         -DTOUCA_BUILD_FRAMEWORK="$(cmake_option "with-framework")"
         -DTOUCA_ENABLE_COVERAGE="$(cmake_option "with-coverage")"
     )
@@ -328,16 +330,23 @@ build_schema () {
     check_prerequisite_commands "flatc"
     local dir_root
     dir_root="$(dirname "$(dirname "${TOUCA_CLIENT_ROOT_DIR}")")"
-    local file_schema="${dir_root}/config/flatbuffers/touca.fbs"
     local dir_out="${TOUCA_CLIENT_ROOT_DIR}/include/touca/impl/"
-    if [ ! -f "$file_schema" ]; then
-        log_error "schema file does not exit: ${file_schema}"
-    fi
-    flatc --cpp --scoped-enums -o "$dir_out" "$file_schema"
-    mv "$dir_out/touca_generated.h" "$dir_out/schema.hpp"
-    log_info "regenerated flatbuffers code based on schema file"
-    clang-format -i "$dir_out/schema.hpp" \
-        --style="{Language: Cpp, BasedOnStyle: Google, DerivePointerAlignment: false, PointerAlignment: Left}"
+    local name
+    for name in touca comparison; do
+        local file_schema="${dir_root}/config/flatbuffers/${name}.fbs"
+        local file_out="${dir_out}/schema.hpp"
+        if [ "$name" != "touca" ]; then
+            file_out="${dir_out}/${name}_schema.hpp"
+        fi
+        if [ ! -f "$file_schema" ]; then
+            log_error "schema file does not exit: ${file_schema}"
+        fi
+        flatc --cpp --scoped-enums -o "$dir_out" "$file_schema"
+        mv "$dir_out/${name}_generated.h" "$file_out"
+        clang-format -i "$file_out" \
+            --style="{Language: Cpp, BasedOnStyle: Google, DerivePointerAlignment: false, PointerAlignment: Left}"
+    done
+    log_info "regenerated flatbuffers code based on schema files"
 }
 
 build_test () {
@@ -365,6 +374,7 @@ declare -A BUILD_OPTIONS=(
     ["with-tests"]=0
     ["with-cli"]=0
     ["with-examples"]=0
+    ["with-benchmarks"]=0
     ["with-framework"]=1
     ["with-coverage"]=0
 )
@@ -429,6 +439,9 @@ for arg in "$@"; do
         "--with-examples")
             BUILD_OPTIONS["with-examples"]=1
             ;;
+        "--with-benchmarks")
+            BUILD_OPTIONS["with-benchmarks"]=1
+            ;;
         "--with-framework") # deprecated (included for backward compatibility)
             BUILD_OPTIONS["with-framework"]=1
             ;;
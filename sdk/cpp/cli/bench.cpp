@@ -0,0 +1,251 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cxxopts.hpp"
+#include "touca/cli/operations.hpp"
+#include "touca/cli/server.hpp"
+#include "touca/core/platform.hpp"
+#include "touca/core/testcase.hpp"
+#include "touca/core/utils.hpp"
+
+/**
+ * @return CPU time in seconds spent by the calling thread, or a negative
+ *         value if it cannot be measured on this platform
+ */
+static double thread_cpu_time() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return -1.0;
+  }
+  return static_cast<double>(ts.tv_sec) +
+         static_cast<double>(ts.tv_nsec) / 1e9;
+#else
+  return -1.0;
+#endif
+}
+
+/**
+ * @return value at the given quantile of a sorted list, by nearest rank
+ */
+static double percentile(const std::vector<double>& sorted, const double q) {
+  const auto rank = static_cast<std::size_t>(
+      std::ceil(q * static_cast<double>(sorted.size())));
+  return sorted.at(rank == 0u ? 0u : rank - 1u);
+}
+
+/**
+ * Synthesizes a value of the given shape whose content depends on the
+ * testcase and the key, so that values do not compress trivially.
+ */
+static touca::data_point make_value(const std::string& shape,
+                                    const unsigned size, const unsigned seed) {
+  if (shape == "string") {
+    std::string value(size, 'a');
+    for (auto i = 0u; i < size; ++i) {
+      value[i] = static_cast<char>('a' + (seed + i * 7u) % 26u);
+    }
+    return touca::data_point::string(std::move(value));
+  }
+  if (shape == "array") {
+    touca::array value;
+    for (auto i = 0u; i < size; ++i) {
+      value.add(seed + i);
+    }
+    return value;
+  }
+  if (shape == "object") {
+    touca::object value("bench");
+    for (auto i = 0u; i < size; ++i) {
+      value.add(touca::detail::format("field-{}", i), seed + i);
+    }
+    return value;
+  }
+  return touca::data_point::number_double(seed * 0.5);
+}
+
+bool BenchSubmitOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=bench-submit");
+  // clang-format off
+    options.add_options("main")
+        ("api-url", "URL to the server API, if not the local stand-in server started by this command", cxxopts::value<std::string>())
+        ("api-key", "API key to authenticate to the server", cxxopts::value<std::string>()->default_value("bench-key"))
+        ("dir", "directory to store results in, if the local stand-in server is used", cxxopts::value<std::string>())
+        ("testcases", "number of testcases to submit", cxxopts::value<unsigned>()->default_value("1000"))
+        ("keys", "number of results captured for each testcase", cxxopts::value<unsigned>()->default_value("10"))
+        ("shape", "shape of captured values: number, string, array or object", cxxopts::value<std::string>()->default_value("number"))
+        ("size", "length of strings and number of elements of arrays and objects", cxxopts::value<unsigned>()->default_value("16"))
+        ("batch", "number of testcases submitted in each request", cxxopts::value<unsigned>()->default_value("10"))
+        ("concurrency", "number of requests in flight at the same time", cxxopts::value<unsigned>()->default_value("1"));
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (result.count("api-url")) {
+    _api_url = result["api-url"].as<std::string>();
+  }
+  if (result.count("dir")) {
+    _dir = result["dir"].as<std::string>();
+  }
+  _api_key = result["api-key"].as<std::string>();
+  _testcases = result["testcases"].as<unsigned>();
+  _keys = result["keys"].as<unsigned>();
+  _shape = result["shape"].as<std::string>();
+  _size = result["size"].as<unsigned>();
+  _batch = result["batch"].as<unsigned>();
+  _concurrency = result["concurrency"].as<unsigned>();
+  const auto& shapes = {"number", "string", "array", "object"};
+  if (std::find(shapes.begin(), shapes.end(), _shape) == shapes.end()) {
+    touca::print_error(
+        "value of option \"--shape\" must be one of \"number\", \"string\", "
+        "\"array\" or \"object\"\n");
+    return false;
+  }
+  if (_testcases == 0u || _batch == 0u || _concurrency == 0u) {
+    touca::print_error(
+        "values of options \"--testcases\", \"--batch\" and "
+        "\"--concurrency\" must be positive\n");
+    return false;
+  }
+  return true;
+}
+
+bool BenchSubmitOperation::run_impl() const {
+  // unless given a server, submit to a local stand-in server whose
+  // results are discarded once the benchmark is complete.
+  std::unique_ptr<touca::SubmissionServer> server;
+  touca::filesystem::path tmp_dir;
+  auto api_url = _api_url;
+  if (api_url.empty()) {
+    touca::SubmissionServer::Options server_options;
+    if (_dir.empty()) {
+      tmp_dir = touca::filesystem::temp_directory_path() /
+                touca::detail::format("touca_bench_{}", std::random_device{}());
+    }
+    server_options.dir = _dir.empty() ? tmp_dir : _dir;
+    server_options.api_key = _api_key;
+    server.reset(new touca::SubmissionServer(server_options));
+    server->start();
+    api_url = server->url();
+  }
+  const auto& cleanup = [&server, &tmp_dir]() {
+    server.reset();
+    if (!tmp_dir.empty()) {
+      std::error_code ec;
+      touca::filesystem::remove_all(tmp_dir, ec);
+    }
+  };
+
+  // results are submitted to the suite and version in the URL, if any
+  touca::ApiUrl api(api_url);
+  if (api._team.empty() || api._suite.empty() || api._revision.empty()) {
+    api._team = "bench-team";
+    api._suite = "bench-suite";
+    api._revision = "1.0";
+  }
+  touca::TransportOptions transport;
+  transport.max_inflight = _concurrency;
+  touca::Platform platform(api, transport);
+  if (!platform.auth(_api_key)) {
+    touca::print_error("failed to authenticate: {}\n", platform.get_error());
+    cleanup();
+    return false;
+  }
+
+  // testcases are synthesized ahead of time so that only serializing and
+  // submitting them is measured.
+  std::vector<std::vector<touca::Testcase>> batches;
+  for (auto i = 0u; i < _testcases; ++i) {
+    if (i % _batch == 0u) {
+      batches.emplace_back();
+      batches.back().reserve(_batch);
+    }
+    touca::Testcase testcase(api._team, api._suite, api._revision,
+                             touca::detail::format("case-{}", i));
+    for (auto j = 0u; j < _keys; ++j) {
+      testcase.check(touca::detail::format("key-{}", j),
+                     make_value(_shape, _size, i * _keys + j));
+    }
+    batches.back().push_back(std::move(testcase));
+  }
+
+  std::vector<double> latencies(batches.size());
+  std::vector<std::size_t> sizes(batches.size());
+  std::vector<double> cpu_times(_concurrency);
+  std::vector<std::string> errors;
+  std::mutex errors_mutex;
+  std::atomic<std::size_t> next{0u};
+  const auto& work = [&](const unsigned index) {
+    const auto cpu_start = thread_cpu_time();
+    for (auto i = next++; i < batches.size(); i = next++) {
+      const auto& buffer = touca::Testcase::serialize(batches[i]);
+      const std::string content(buffer.begin(), buffer.end());
+      const auto& begin = std::chrono::steady_clock::now();
+      const auto& failures = platform.submit(content);
+      latencies[i] = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+      sizes[i] = content.size();
+      if (!failures.empty()) {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        errors.insert(errors.end(), failures.begin(), failures.end());
+      }
+    }
+    const auto cpu_end = thread_cpu_time();
+    cpu_times[index] = cpu_start < 0.0 ? -1.0 : cpu_end - cpu_start;
+  };
+
+  const auto& start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < _concurrency; ++i) {
+    threads.emplace_back(work, i);
+  }
+  work(0u);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  cleanup();
+
+  for (const auto& err : errors) {
+    touca::print_error("{}\n", err);
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto megabytes =
+      static_cast<double>(std::accumulate(sizes.begin(), sizes.end(),
+                                          std::size_t{0u})) /
+      1048576.0;
+  fmt::print(stdout,
+             "submitted {} testcases ({:.1f} MB) in {} requests over {} "
+             "connections in {:.2f} s\n",
+             _testcases, megabytes, batches.size(), _concurrency, seconds);
+  fmt::print(stdout, "throughput:  {:.0f} testcases/s, {:.1f} MB/s\n",
+             _testcases / seconds, megabytes / seconds);
+  fmt::print(stdout,
+             "latency:     p50 {:.1f} ms, p99 {:.1f} ms, max {:.1f} ms\n",
+             percentile(latencies, 0.5), percentile(latencies, 0.99),
+             latencies.back());
+  if (std::all_of(cpu_times.begin(), cpu_times.end(),
+                  [](const double value) { return value >= 0.0; })) {
+    const auto cpu =
+        std::accumulate(cpu_times.begin(), cpu_times.end(), 0.0);
+    fmt::print(stdout, "client cpu:  {:.2f} s, {:.3f} ms per testcase\n", cpu,
+               cpu * 1000.0 / _testcases);
+  }
+  return errors.empty();
+}
@@ -1,19 +1,57 @@
 // Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
 #include <unordered_map>
 
 #include "cxxopts.hpp"
 #include "touca/cli/operations.hpp"
-#include "touca/core/filesystem.hpp"
+#include "touca/cli/resultdir.hpp"
 #include "touca/cli/resultfile.hpp"
+#include "touca/core/filesystem.hpp"
 #include "touca/core/utils.hpp"
 
+/**
+ * Completes the comparison output, ending json output with a newline.
+ */
+static bool finish(touca::ComparisonWriter& writer, std::ostream& out,
+                   const touca::ComparisonWriter::Format format) {
+  writer.close();
+  if (format == touca::ComparisonWriter::Format::json) {
+    out << '\n';
+  }
+  return static_cast<bool>(out.flush());
+}
+
+static void print_summary(std::FILE* file,
+                          const touca::ComparisonSummary& summary) {
+  for (const auto& error : summary.errors) {
+    touca::print_error("failed to compare testcase {}\n", error);
+  }
+  fmt::print(file,
+             "compared {} testcases: {} perfect matches, {} new, {} missing, "
+             "{} failed",
+             summary.common, summary.perfect, summary.fresh, summary.missing,
+             summary.errors.size());
+  if (summary.common != 0u) {
+    fmt::print(file, ", average match score {:.3f}",
+               summary.score / static_cast<double>(summary.common));
+  }
+  fmt::print(file, "\n");
+}
+
 bool CompareOperation::parse_impl(int argc, char* argv[]) {
   cxxopts::Options options("touca_cli --mode=compare");
   // clang-format off
     options.add_options("main")
         ("src", "file or directory to compare", cxxopts::value<std::string>())
-        ("dst", "file or directory to compare against", cxxopts::value<std::string>());
+        ("dst", "file or directory to compare against", cxxopts::value<std::string>())
+        ("format", "format of comparison results: json, ndjson or binary", cxxopts::value<std::string>()->default_value("json"))
+        ("output", "file to write comparison results to, instead of standard output", cxxopts::value<std::string>())
+        ("workers", "number of testcases to compare at the same time when comparing directories", cxxopts::value<unsigned>()->default_value(std::to_string(std::max(1u, std::thread::hardware_concurrency()))));
   // clang-format on
   options.allow_unrecognised_options();
 
@@ -29,7 +67,8 @@ bool CompareOperation::parse_impl(int argc, char* argv[]) {
       return false;
     }
     const auto filepath = result[kvp.first].as<std::string>();
-    if (!touca::filesystem::is_regular_file(filepath)) {
+    if (!touca::filesystem::is_regular_file(filepath) &&
+        !touca::filesystem::is_directory(filepath)) {
       touca::print_error("{} file `{}` does not exist\n", kvp.second, filepath);
       return false;
     }
@@ -37,16 +76,62 @@ bool CompareOperation::parse_impl(int argc, char* argv[]) {
 
   _src = result["src"].as<std::string>();
   _dst = result["dst"].as<std::string>();
+  _format = result["format"].as<std::string>();
+  if (result.count("output")) {
+    _output = result["output"].as<std::string>();
+  }
+  _workers = result["workers"].as<unsigned>();
+
+  if (touca::filesystem::is_directory(_src) !=
+      touca::filesystem::is_directory(_dst)) {
+    touca::print_error(
+        "source and destination must both be files or both be directories\n");
+    return false;
+  }
+  if (_workers == 0u) {
+    touca::print_error("value of option \"--workers\" must be positive\n");
+    return false;
+  }
+
+  if (_format != "json" && _format != "ndjson" && _format != "binary") {
+    touca::print_error(
+        "value of option \"--format\" must be \"json\", \"ndjson\" or "
+        "\"binary\"\n");
+    return false;
+  }
 
   return true;
 }
 
 bool CompareOperation::run_impl() const {
+  std::ofstream file;
+  if (!_output.empty()) {
+    file.open(_output, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file) {
+      touca::print_error("failed to open output file `{}`\n", _output);
+      return false;
+    }
+  }
+  auto& out = _output.empty() ? std::cout : file;
   try {
-    const auto& res = touca::compare(touca::ResultFile(_src).parse(),
-                                     touca::ResultFile(_dst).parse());
-    fmt::print(stdout, "{}\n", res.json());
-    return true;
+    const auto format = _format == "binary"
+                            ? touca::ComparisonWriter::Format::binary
+                            : _format == "ndjson"
+                                  ? touca::ComparisonWriter::Format::ndjson
+                                  : touca::ComparisonWriter::Format::json;
+    touca::ComparisonWriter writer(out, format);
+    if (!touca::filesystem::is_directory(_src)) {
+      touca::ResultReader src(_src);
+      touca::ResultReader dst(_dst);
+      touca::compare(src, dst, writer);
+      return finish(writer, out, format);
+    }
+    const auto& summary =
+        touca::compare(touca::ResultDirectory(_src),
+                       touca::ResultDirectory(_dst), writer, _workers);
+    const auto ok = finish(writer, out, format);
+    print_summary(_output.empty() ? stderr : stdout, summary);
+    return ok && summary.errors.empty();
   } catch (const std::exception& ex) {
     touca::print_error("failed to compare given files: {}", ex.what());
   }
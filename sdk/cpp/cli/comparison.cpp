@@ -2,10 +2,16 @@
 
 #include "touca/cli/comparison.hpp"
 
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "flatbuffers/flatbuffers.h"
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "touca/core/filesystem.hpp"
+#include "touca/impl/comparison_schema.hpp"
 
 namespace touca {
 
@@ -284,6 +290,233 @@ TypeComparison compare(const data_point& src, const data_point& dst) {
   return cmp;
 }
 
+/**
+ * Evaluates the continued fraction expansion of the regularized
+ * incomplete beta function, following "Numerical Recipes in C", 6.4.
+ */
+static double beta_fraction(const double a, const double b, const double x) {
+  const auto tiny = 1e-30;
+  const auto clamp = [tiny](const double value) {
+    return std::fabs(value) < tiny ? tiny : value;
+  };
+  auto c = 1.0;
+  auto d = 1.0 / clamp(1.0 - (a + b) * x / (a + 1.0));
+  auto h = d;
+  for (auto m = 1; m <= 300; ++m) {
+    const auto m2 = 2.0 * m;
+    auto aa = m * (b - m) * x / ((a - 1.0 + m2) * (a + m2));
+    d = 1.0 / clamp(1.0 + aa * d);
+    c = clamp(1.0 + aa / c);
+    h *= d * c;
+    aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + 1.0 + m2));
+    d = 1.0 / clamp(1.0 + aa * d);
+    c = clamp(1.0 + aa / c);
+    const auto delta = d * c;
+    h *= delta;
+    if (std::fabs(delta - 1.0) < 1e-12) {
+      break;
+    }
+  }
+  return h;
+}
+
+static double incomplete_beta(const double a, const double b, const double x) {
+  if (x <= 0.0 || x >= 1.0) {
+    return x <= 0.0 ? 0.0 : 1.0;
+  }
+  const auto front =
+      std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+               a * std::log(x) + b * std::log(1.0 - x));
+  if (x < (a + 1.0) / (a + b + 2.0)) {
+    return front * beta_fraction(a, b, x) / a;
+  }
+  return 1.0 - front * beta_fraction(b, a, 1.0 - x) / b;
+}
+
+/**
+ * Finds the two-sided p-value of Welch's t-test for the hypothesis that
+ * the two summarized sets of measurements have the same mean.
+ */
+static double welch_p_value(const MetricSummary& src,
+                            const MetricSummary& dst) {
+  const auto src_var = src.stddev * src.stddev / src.count;
+  const auto dst_var = dst.stddev * dst.stddev / dst.count;
+  const auto variance = src_var + dst_var;
+  if (variance == 0.0) {
+    return src.mean == dst.mean ? 1.0 : 0.0;
+  }
+  const auto t = (src.mean - dst.mean) / std::sqrt(variance);
+  const auto df = variance * variance /
+                  (src_var * src_var / (src.count - 1) +
+                   dst_var * dst_var / (dst.count - 1));
+  return incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+static double typical_duration(const data_point& value) {
+  MetricSummary summary;
+  if (MetricSummary::from_data_point(value, summary)) {
+    return summary.median;
+  }
+  if (value.type() == detail::internal_type::number_unsigned) {
+    return 0.0;
+  }
+  ProfileMap profile;
+  if (profile_from_data_point(value, profile)) {
+    std::uint64_t total = 0u;
+    for (const auto& kvp : profile) {
+      if (kvp.first.find(';') == std::string::npos) {
+        total += kvp.second.total;
+      }
+    }
+    return static_cast<double>(total) / 1000.0;
+  }
+  return static_cast<double>(value.as_number_signed());
+}
+
+/**
+ * Compares two counts of hardware events. Counts within one percent of
+ * each other are considered identical since even the most deterministic
+ * counters, such as instructions retired, vary slightly between runs.
+ */
+static TypeComparison compare_counter(const data_point& src,
+                                      const data_point& dst) {
+  TypeComparison cmp;
+  cmp.srcType = src.type();
+  cmp.srcValue = src.to_string();
+  const auto src_count = static_cast<double>(src.as_number_unsigned());
+  const auto dst_count = static_cast<double>(dst.as_number_unsigned());
+  if (std::fabs(src_count - dst_count) <= 0.01 * dst_count) {
+    cmp.match = MatchType::Perfect;
+    cmp.score = 1.0;
+    return cmp;
+  }
+  compare_number(src_count, dst_count, cmp);
+  cmp.dstType = dst.type();
+  cmp.dstValue = dst.to_string();
+  return cmp;
+}
+
+/**
+ * Compares two call trees of the hierarchical profiler, reporting call
+ * paths that were added or removed and those whose number of calls or
+ * total duration has changed. Changes in duration are only reported if
+ * they are larger than ten percent and one millisecond.
+ */
+static TypeComparison compare_profile(const data_point& src,
+                                      const data_point& dst,
+                                      const ProfileMap& src_profile,
+                                      const ProfileMap& dst_profile) {
+  TypeComparison cmp;
+  cmp.srcType = src.type();
+  cmp.srcValue = src.to_string();
+
+  auto paths = src_profile.size();
+  std::size_t changed = 0u;
+  for (const auto& kvp : src_profile) {
+    const auto& it = dst_profile.find(kvp.first);
+    if (it == dst_profile.end()) {
+      cmp.desc.insert(touca::detail::format("new call path {}", kvp.first));
+      ++changed;
+      continue;
+    }
+    auto is_changed = false;
+    if (kvp.second.calls != it->second.calls) {
+      cmp.desc.insert(touca::detail::format(
+          "{}: number of calls changed from {} to {}", kvp.first,
+          it->second.calls, kvp.second.calls));
+      is_changed = true;
+    }
+    const auto src_total = static_cast<double>(kvp.second.total);
+    const auto dst_total = static_cast<double>(it->second.total);
+    const auto diff = std::fabs(src_total - dst_total);
+    if (1000.0 <= diff && 0.1 * dst_total < diff) {
+      cmp.desc.insert(touca::detail::format(
+          "{}: total duration changed from {:.1f}ms to {:.1f}ms", kvp.first,
+          dst_total / 1000.0, src_total / 1000.0));
+      is_changed = true;
+    }
+    if (is_changed) {
+      ++changed;
+    }
+  }
+  for (const auto& kvp : dst_profile) {
+    if (!src_profile.count(kvp.first)) {
+      cmp.desc.insert(touca::detail::format("missing call path {}", kvp.first));
+      ++paths;
+      ++changed;
+    }
+  }
+
+  if (changed == 0u) {
+    cmp.match = MatchType::Perfect;
+    cmp.score = 1.0;
+    return cmp;
+  }
+  cmp.score = static_cast<double>(paths - changed) / paths;
+  cmp.dstType = dst.type();
+  cmp.dstValue = dst.to_string();
+  return cmp;
+}
+
+/**
+ * Compares two measurements of a performance metric. Metrics summarizing
+ * repeated measurements are only reported as different if the difference
+ * of their means is statistically significant.
+ */
+static TypeComparison compare_metric(const data_point& src,
+                                     const data_point& dst) {
+  if (src.type() == detail::internal_type::number_unsigned &&
+      dst.type() == detail::internal_type::number_unsigned) {
+    return compare_counter(src, dst);
+  }
+
+  ProfileMap src_profile;
+  ProfileMap dst_profile;
+  if (profile_from_data_point(src, src_profile) &&
+      profile_from_data_point(dst, dst_profile)) {
+    return compare_profile(src, dst, src_profile, dst_profile);
+  }
+
+  MetricSummary src_summary;
+  MetricSummary dst_summary;
+  const auto src_is_summary = MetricSummary::from_data_point(src, src_summary);
+  const auto dst_is_summary = MetricSummary::from_data_point(dst, dst_summary);
+  if (!src_is_summary && !dst_is_summary) {
+    return compare(src, dst);
+  }
+
+  TypeComparison cmp;
+  cmp.srcType = src.type();
+  cmp.srcValue = src.to_string();
+
+  // without enough measurements on both sides, we fall back to comparing
+  // typical values.
+  if (!src_is_summary || !dst_is_summary || src_summary.count < 2u ||
+      dst_summary.count < 2u) {
+    compare_number(typical_duration(src), typical_duration(dst), cmp);
+    if (cmp.match != MatchType::Perfect) {
+      cmp.dstType = dst.type();
+      cmp.dstValue = dst.to_string();
+    }
+    return cmp;
+  }
+
+  const auto significance = 0.05;
+  const auto p_value = welch_p_value(src_summary, dst_summary);
+  if (significance <= p_value) {
+    cmp.match = MatchType::Perfect;
+    cmp.score = 1.0;
+    return cmp;
+  }
+  compare_number(src_summary.mean, dst_summary.mean, cmp);
+  cmp.desc.insert(touca::detail::format(
+      "difference of means is statistically significant (p = {:.4f})",
+      p_value));
+  cmp.dstType = dst.type();
+  cmp.dstValue = dst.to_string();
+  return cmp;
+}
+
 TestcaseComparison::TestcaseComparison(const Testcase& src, const Testcase& dst)
     : _src(src), _dst(dst) {
   _srcMeta = _src.metadata();
@@ -328,6 +561,100 @@ rapidjson::Value TestcaseComparison::json(
   return out;
 }
 
+static fbs::ValueType to_value_type(const detail::internal_type type) {
+  switch (type) {
+    case detail::internal_type::boolean:
+      return fbs::ValueType::Bool;
+    case detail::internal_type::number_signed:
+    case detail::internal_type::number_unsigned:
+    case detail::internal_type::number_float:
+    case detail::internal_type::number_double:
+      return fbs::ValueType::Number;
+    case detail::internal_type::string:
+      return fbs::ValueType::String;
+    case detail::internal_type::array:
+      return fbs::ValueType::Array;
+    case detail::internal_type::object:
+      return fbs::ValueType::Object;
+    default:
+      return fbs::ValueType::Unknown;
+  }
+}
+
+static flatbuffers::Offset<fbs::ComparisonMetadata> serialize_metadata(
+    flatbuffers::FlatBufferBuilder& builder, const Testcase::Metadata& meta) {
+  return fbs::CreateComparisonMetadataDirect(
+      builder, meta.teamslug.c_str(), meta.testsuite.c_str(),
+      meta.version.c_str(), meta.testcase.c_str(), meta.builtAt.c_str());
+}
+
+static flatbuffers::Offset<fbs::ComparisonCellar> serialize_cellar(
+    flatbuffers::FlatBufferBuilder& builder, const Cellar& cellar) {
+  std::vector<flatbuffers::Offset<fbs::ComparisonKey>> common;
+  common.reserve(cellar.common.size());
+  for (const auto& kv : cellar.common) {
+    const auto& cmp = kv.second;
+    const auto& name = builder.CreateString(kv.first);
+    flatbuffers::Offset<flatbuffers::String> srcValue = 0;
+    flatbuffers::Offset<flatbuffers::String> dstValue = 0;
+    if (MatchType::Perfect != cmp.match) {
+      srcValue = builder.CreateString(cmp.srcValue);
+      dstValue = builder.CreateString(cmp.dstValue);
+    }
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+        desc = 0;
+    if (!cmp.desc.empty()) {
+      const std::vector<std::string> entries(cmp.desc.begin(), cmp.desc.end());
+      desc = builder.CreateVectorOfStrings(entries);
+    }
+    const auto match = MatchType::Perfect == cmp.match
+                           ? fbs::MatchType::Perfect
+                           : fbs::MatchType::None;
+    common.push_back(fbs::CreateComparisonKey(
+        builder, name, match, cmp.score, to_value_type(cmp.srcType),
+        to_value_type(cmp.dstType), srcValue, dstValue, desc));
+  }
+  const auto& solo = [&builder](const Cellar::KeyMap& keys) {
+    std::vector<flatbuffers::Offset<fbs::ComparisonSoloKey>> out;
+    out.reserve(keys.size());
+    for (const auto& kv : keys) {
+      out.push_back(fbs::CreateComparisonSoloKeyDirect(
+          builder, kv.first.c_str(), to_value_type(kv.second.type()),
+          kv.second.to_string().c_str()));
+    }
+    return out;
+  };
+  const auto& missing = solo(cellar.missing);
+  const auto& fresh = solo(cellar.fresh);
+  return fbs::CreateComparisonCellarDirect(builder, &common, &missing, &fresh);
+}
+
+static std::vector<uint8_t> copy_buffer(
+    const flatbuffers::FlatBufferBuilder& builder) {
+  const auto& ptr = builder.GetBufferPointer();
+  return {ptr, ptr + builder.GetSize()};
+}
+
+std::vector<uint8_t> TestcaseComparison::flatbuffers() const {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto& src = serialize_metadata(builder, _srcMeta);
+  const auto& dst = serialize_metadata(builder, _dstMeta);
+  const auto& meta = overview();
+  const auto& fbsOverview = fbs::CreateComparisonOverview(
+      builder, meta.keysScore, meta.keysCountCommon, meta.keysCountFresh,
+      meta.keysCountMissing, meta.metricsCountCommon, meta.metricsCountFresh,
+      meta.metricsCountMissing, meta.metricsDurationCommonDst,
+      meta.metricsDurationCommonSrc);
+  const auto& assertions = serialize_cellar(builder, _assumptions);
+  const auto& results = serialize_cellar(builder, _results);
+  const auto& metrics = serialize_cellar(builder, _metrics);
+  builder.Finish(fbs::CreateCaseComparison(
+      builder, fbs::ComparisonCategory::Common, src, dst, fbsOverview,
+      assertions, results, metrics));
+  return copy_buffer(builder);
+}
+
 double TestcaseComparison::score_results() const {
   using pair_t = std::pair<std::string, TypeComparison>;
   const auto& op = [](const double t, const pair_t& item) {
@@ -364,12 +691,11 @@ TestcaseComparison::Overview TestcaseComparison::overview() const {
   output.metricsCountMissing = count(_metrics.missing.size());
 
   const auto getTotalCommonDuration = [this](const Testcase& tc) {
-    namespace chr = std::chrono;
+    const auto& metrics = tc.metrics();
     std::int32_t duration = 0U;
     for (const auto& kvp : _metrics.common) {
-      const auto& diff = tc._tocs.at(kvp.first) - tc._tics.at(kvp.first);
       duration += static_cast<std::int32_t>(
-          chr::duration_cast<chr::milliseconds>(diff).count());
+          std::llround(typical_duration(metrics.at(kvp.first).value)));
     }
     return duration;
   };
@@ -411,7 +737,8 @@ void TestcaseComparison::init_cellar(const MetricsMap& src,
   for (const auto& kv : dst) {
     const auto& key = kv.first;
     if (src.count(key)) {
-      result.common.emplace(key, compare(src.at(key).value, kv.second.value));
+      result.common.emplace(key,
+                            compare_metric(src.at(key).value, kv.second.value));
       continue;
     }
     result.missing.emplace(key, kv.second.value);
@@ -444,35 +771,184 @@ ElementsMapComparison compare(const ElementsMap& src, const ElementsMap& dst) {
 }
 
 std::string ElementsMapComparison::json() const {
-  rapidjson::Document doc(rapidjson::kObjectType);
-  auto& allocator = doc.GetAllocator();
-
-  rapidjson::Value rjFresh(rapidjson::kArrayType);
+  std::ostringstream out;
+  ComparisonWriter writer(out, ComparisonWriter::Format::json);
   for (const auto& item : fresh) {
-    auto val = item.second->metadata().json(allocator);
-    rjFresh.PushBack(val, allocator);
+    writer.add_fresh(item.second->metadata());
   }
-
-  rapidjson::Value rjMissing(rapidjson::kArrayType);
   for (const auto& item : missing) {
-    auto val = item.second->metadata().json(allocator);
-    rjMissing.PushBack(val, allocator);
+    writer.add_missing(item.second->metadata());
   }
-
-  rapidjson::Value rjCommon(rapidjson::kArrayType);
   for (const auto& item : common) {
-    rjCommon.PushBack(item.second.json(allocator), allocator);
+    writer.add_common(item.second);
+  }
+  writer.close();
+  return out.str();
+}
+
+ComparisonWriter::ComparisonWriter(std::ostream& out, const Format format)
+    : _out(out), _format(format) {}
+
+/**
+ * Serializes a testcase that is only found in one of the compared files
+ * as a `CaseComparison` table.
+ */
+static std::vector<uint8_t> serialize_solo(
+    const fbs::ComparisonCategory category, const Testcase::Metadata& meta) {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto& fbsMeta = serialize_metadata(builder, meta);
+  fbs::CaseComparisonBuilder fbsCase(builder);
+  fbsCase.add_category(category);
+  if (category == fbs::ComparisonCategory::New) {
+    fbsCase.add_src(fbsMeta);
+  } else {
+    fbsCase.add_dst(fbsMeta);
   }
+  builder.Finish(fbsCase.Finish());
+  return copy_buffer(builder);
+}
 
-  doc.AddMember("newCases", rjFresh, allocator);
-  doc.AddMember("missingCases", rjMissing, allocator);
-  doc.AddMember("commonCases", rjCommon, allocator);
+constexpr char comparison_magic[] = "TOUCACMP";
+
+void ComparisonWriter::add_fresh(const Testcase::Metadata& metadata) {
+  if (_format == Format::binary) {
+    write(Section::fresh,
+          serialize_solo(fbs::ComparisonCategory::New, metadata));
+    return;
+  }
+  rapidjson::Document doc;
+  auto value = metadata.json(doc.GetAllocator());
+  write(Section::fresh, value, doc.GetAllocator());
+}
+
+void ComparisonWriter::add_missing(const Testcase::Metadata& metadata) {
+  if (_format == Format::binary) {
+    write(Section::missing,
+          serialize_solo(fbs::ComparisonCategory::Missing, metadata));
+    return;
+  }
+  rapidjson::Document doc;
+  auto value = metadata.json(doc.GetAllocator());
+  write(Section::missing, value, doc.GetAllocator());
+}
+
+void ComparisonWriter::add_common(const TestcaseComparison& comparison) {
+  if (_format == Format::binary) {
+    write(Section::common, comparison.flatbuffers());
+    return;
+  }
+  rapidjson::Document doc;
+  auto value = comparison.json(doc.GetAllocator());
+  write(Section::common, value, doc.GetAllocator());
+}
+
+void ComparisonWriter::close() {
+  if (_section == Section::closed) {
+    return;
+  }
+  enter(Section::closed);
+  _out.flush();
+}
+
+void ComparisonWriter::write(const Section section, rapidjson::Value& value,
+                             RJAllocator& allocator) {
+  enter(section);
+  if (_format == Format::ndjson) {
+    static const char* names[] = {"", "newCase", "missingCase", "commonCase"};
+    rapidjson::Value line(rapidjson::kObjectType);
+    line.AddMember(rapidjson::StringRef(names[static_cast<int>(section)]),
+                   value, allocator);
+    value = std::move(line);
+  } else if (!_first) {
+    _out.put(',');
+  }
+  _first = false;
 
   rapidjson::StringBuffer strbuf;
   rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
   writer.SetMaxDecimalPlaces(3);
-  doc.Accept(writer);
-  return strbuf.GetString();
+  value.Accept(writer);
+  _out.write(strbuf.GetString(), strbuf.GetSize());
+  if (_format == Format::ndjson) {
+    _out.put('\n');
+  }
+}
+
+void ComparisonWriter::write(const Section section,
+                             const std::vector<uint8_t>& buffer) {
+  enter(section);
+  const auto size = static_cast<std::uint32_t>(buffer.size());
+  const char prefix[4] = {static_cast<char>(size & 0xffu),
+                          static_cast<char>((size >> 8) & 0xffu),
+                          static_cast<char>((size >> 16) & 0xffu),
+                          static_cast<char>((size >> 24) & 0xffu)};
+  _out.write(prefix, sizeof(prefix));
+  _out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+void ComparisonWriter::enter(const Section section) {
+  if (_section == Section::closed) {
+    throw std::logic_error("comparison results added after output is closed");
+  }
+  if (section < _section) {
+    throw std::logic_error("comparison results added out of order");
+  }
+  if (_format != Format::json) {
+    if (_format == Format::binary && _first) {
+      _out.write(comparison_magic, sizeof(comparison_magic) - 1);
+    }
+    _first = false;
+    if (section == Section::closed) {
+      _section = section;
+    }
+    return;
+  }
+  static const char* keys[] = {"", "newCases", "missingCases", "commonCases"};
+  while (_section < section) {
+    _out.put(_section == Section::none ? '{' : ']');
+    _section = static_cast<Section>(static_cast<int>(_section) + 1);
+    if (_section == Section::closed) {
+      _out.put('}');
+      break;
+    }
+    if (_section != Section::fresh) {
+      _out.put(',');
+    }
+    _out << '"' << keys[static_cast<int>(_section)] << "\":[";
+    _first = true;
+  }
+}
+
+ComparisonReader::ComparisonReader(std::istream& input) : _input(input) {
+  char magic[sizeof(comparison_magic) - 1];
+  if (!_input.read(magic, sizeof(magic)) ||
+      std::string(magic, sizeof(magic)) != comparison_magic) {
+    throw std::runtime_error("stream has no comparison results");
+  }
+}
+
+const fbs::CaseComparison* ComparisonReader::next() {
+  unsigned char prefix[4];
+  _input.read(reinterpret_cast<char*>(prefix), sizeof(prefix));
+  if (_input.gcount() == 0 && _input.eof()) {
+    return nullptr;
+  }
+  if (_input.gcount() != sizeof(prefix)) {
+    throw std::runtime_error("comparison results are truncated");
+  }
+  const auto size = static_cast<std::uint32_t>(prefix[0]) |
+                    static_cast<std::uint32_t>(prefix[1]) << 8 |
+                    static_cast<std::uint32_t>(prefix[2]) << 16 |
+                    static_cast<std::uint32_t>(prefix[3]) << 24;
+  _buffer.resize(size);
+  if (!_input.read(reinterpret_cast<char*>(_buffer.data()), size)) {
+    throw std::runtime_error("comparison results are truncated");
+  }
+  flatbuffers::Verifier verifier(_buffer.data(), _buffer.size());
+  if (!verifier.VerifyBuffer<fbs::CaseComparison>()) {
+    throw std::runtime_error("comparison results are corrupted");
+  }
+  return fbs::GetCaseComparison(_buffer.data());
 }
 
 }  // namespace touca
@@ -0,0 +1,85 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <algorithm>
+
+#include "cxxopts.hpp"
+#include "touca/cli/operations.hpp"
+#include "touca/cli/resultfile.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/utils.hpp"
+
+/**
+ * Finds result files in a given path. Directories are searched
+ * recursively for result files written by the test runner.
+ */
+static std::vector<touca::filesystem::path> find_result_files(
+    const touca::filesystem::path& path) {
+  if (touca::filesystem::is_regular_file(path)) {
+    return {path};
+  }
+  std::vector<touca::filesystem::path> out;
+  for (const auto& entry :
+       touca::filesystem::recursive_directory_iterator(path)) {
+    const auto& name = entry.path().filename();
+    if (entry.is_regular_file() &&
+        (name == "touca.bin" || name == "touca.results")) {
+      out.push_back(entry.path());
+    }
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+bool MergeOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=merge");
+  // clang-format off
+    options.add_options("main")
+        ("src", "result files or directories of results to merge, such as output directories of shards of a test run", cxxopts::value<std::vector<std::string>>())
+        ("out", "path to result file to be created", cxxopts::value<std::string>());
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (!result.count("src")) {
+    touca::print_error("source files not provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  if (!result.count("out")) {
+    touca::print_error("output file not provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  _src = result["src"].as<std::vector<std::string>>();
+  _out = result["out"].as<std::string>();
+  for (const auto& src : _src) {
+    if (!touca::filesystem::exists(src)) {
+      touca::print_error("path `{}` does not exist\n", src);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MergeOperation::run_impl() const {
+  touca::ResultFile out(_out);
+  auto count = 0u;
+  for (const auto& src : _src) {
+    for (const auto& path : find_result_files(src)) {
+      try {
+        out.merge(touca::ResultFile(path));
+        ++count;
+      } catch (const std::exception& ex) {
+        touca::print_error("failed to read file {}: {}\n", path.string(),
+                           ex.what());
+        return false;
+      }
+    }
+  }
+  if (count == 0u) {
+    touca::print_error("no result files found\n");
+    return false;
+  }
+  out.save();
+  fmt::print(stdout, "merged {} result files into {}\n", count, _out);
+  return true;
+}
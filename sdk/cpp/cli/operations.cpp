@@ -10,7 +10,11 @@
 
 Operation::Command Operation::find_mode(const std::string& name) {
   const std::unordered_map<std::string, Operation::Command> modes{
+      {"bench-submit", Operation::Command::bench_submit},
       {"compare", Operation::Command::compare},
+      {"merge", Operation::Command::merge},
+      {"serve", Operation::Command::serve},
+      {"upload", Operation::Command::upload},
       {"view", Operation::Command::view}};
   return modes.count(name) ? modes.at(name) : Operation::Command::unknown;
 }
@@ -18,7 +22,12 @@ Operation::Command Operation::find_mode(const std::string& name) {
 std::shared_ptr<Operation> Operation::make(const Operation::Command& mode) {
   using func_t = std::function<std::shared_ptr<Operation>()>;
   std::map<Operation::Command, func_t> ops{
+      {Operation::Command::bench_submit,
+       &std::make_shared<BenchSubmitOperation>},
       {Operation::Command::compare, &std::make_shared<CompareOperation>},
+      {Operation::Command::merge, &std::make_shared<MergeOperation>},
+      {Operation::Command::serve, &std::make_shared<ServeOperation>},
+      {Operation::Command::upload, &std::make_shared<UploadOperation>},
       {Operation::Command::view, &std::make_shared<ViewOperation>}};
   if (!ops.count(mode)) {
     touca::print_error("operation not implemented: {}\n", mode);
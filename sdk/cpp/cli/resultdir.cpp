@@ -0,0 +1,230 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/cli/resultdir.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "touca/cli/resultfile.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/testcase.hpp"
+
+namespace touca {
+
+ResultDirectory::ResultDirectory(const touca::filesystem::path& path)
+    : _path(path) {
+  if (!touca::filesystem::is_directory(_path)) {
+    throw std::runtime_error("result directory missing: " + _path.string());
+  }
+  for (const auto& entry : touca::filesystem::directory_iterator(_path)) {
+    const auto& filename = entry.path().filename().string();
+    if (entry.is_directory() && filename != ".trash" &&
+        touca::filesystem::is_regular_file(entry.path() / "touca.bin")) {
+      _files.emplace(filename, entry.path() / "touca.bin");
+    }
+  }
+  const auto& log_path = _path / "touca.results";
+  if (touca::filesystem::is_regular_file(log_path)) {
+    for (const auto& entry : ResultLog::read_index(log_path.string())) {
+      _entries.emplace(entry.testcase, std::make_pair(log_path, entry));
+    }
+  }
+}
+
+std::vector<std::string> ResultDirectory::names() const {
+  std::vector<std::string> names;
+  names.reserve(_files.size() + _entries.size());
+  for (const auto& file : _files) {
+    names.push_back(file.first);
+  }
+  for (const auto& entry : _entries) {
+    if (!_files.count(entry.first)) {
+      names.push_back(entry.first);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+bool ResultDirectory::contains(const std::string& name) const {
+  return _files.count(name) || _entries.count(name);
+}
+
+Testcase ResultDirectory::read(const std::string& name) const {
+  const auto& file = _files.find(name);
+  if (file != _files.end()) {
+    ResultReader reader(file->second);
+    const auto& names = reader.names();
+    if (reader.contains(name) || names.size() == 1u) {
+      return reader.read(reader.contains(name) ? name : names.front());
+    }
+    throw std::runtime_error("result file " + file->second.string() +
+                             " has no testcase " + name);
+  }
+  const auto& entry = _entries.find(name);
+  if (entry == _entries.end()) {
+    throw std::runtime_error("result directory " + _path.string() +
+                             " has no testcase " + name);
+  }
+  std::ifstream input(entry->second.first.string(),
+                      std::ios::in | std::ios::binary);
+  return deserialize_testcase(
+      ResultLog::read_record(input, entry->second.second));
+}
+
+namespace {
+
+enum class TaskKind : unsigned char { fresh, missing, common };
+
+struct Task {
+  TaskKind kind;
+  std::string name;
+};
+
+/**
+ * Results of one testcase that are kept until comparison results of all
+ * testcases before it are written.
+ */
+struct Outcome {
+  std::unique_ptr<Testcase> src;
+  std::unique_ptr<Testcase> dst;
+  std::unique_ptr<TestcaseComparison> comparison;
+  std::string error;
+};
+
+std::unique_ptr<Outcome> run_task(const ResultDirectory& src,
+                                  const ResultDirectory& dst,
+                                  const Task& task) {
+  std::unique_ptr<Outcome> outcome(new Outcome());
+  try {
+    if (task.kind != TaskKind::missing) {
+      outcome->src.reset(new Testcase(src.read(task.name)));
+    }
+    if (task.kind != TaskKind::fresh) {
+      outcome->dst.reset(new Testcase(dst.read(task.name)));
+    }
+    if (task.kind == TaskKind::common) {
+      outcome->comparison.reset(
+          new TestcaseComparison(*outcome->src, *outcome->dst));
+    }
+  } catch (const std::exception& ex) {
+    outcome->error = task.name + ": " + ex.what();
+  }
+  return outcome;
+}
+
+void write_outcome(const Task& task, const Outcome& outcome,
+                   ComparisonWriter& writer, ComparisonSummary& summary) {
+  if (!outcome.error.empty()) {
+    summary.errors.push_back(outcome.error);
+    return;
+  }
+  if (task.kind == TaskKind::fresh) {
+    writer.add_fresh(outcome.src->metadata());
+    ++summary.fresh;
+    return;
+  }
+  if (task.kind == TaskKind::missing) {
+    writer.add_missing(outcome.dst->metadata());
+    ++summary.missing;
+    return;
+  }
+  writer.add_common(*outcome.comparison);
+  const auto& overview = outcome.comparison->overview();
+  ++summary.common;
+  summary.score += overview.keysScore;
+  if (overview.keysScore == 1.0 && overview.keysCountFresh == 0 &&
+      overview.keysCountMissing == 0) {
+    ++summary.perfect;
+  }
+}
+
+}  // namespace
+
+ComparisonSummary compare(const ResultDirectory& src,
+                          const ResultDirectory& dst, ComparisonWriter& writer,
+                          const unsigned workers) {
+  const auto& src_names = src.names();
+  const auto& dst_names = dst.names();
+  std::vector<Task> tasks;
+  for (const auto& name : src_names) {
+    if (!dst.contains(name)) {
+      tasks.push_back({TaskKind::fresh, name});
+    }
+  }
+  for (const auto& name : dst_names) {
+    if (!src.contains(name)) {
+      tasks.push_back({TaskKind::missing, name});
+    }
+  }
+  for (const auto& name : src_names) {
+    if (dst.contains(name)) {
+      tasks.push_back({TaskKind::common, name});
+    }
+  }
+
+  // workers take tasks in order but may finish them out of order. to
+  // keep the output in order without holding results of all testcases
+  // in memory, no worker starts a task too far ahead of the first task
+  // whose results are not yet written.
+  const std::size_t window = 4u * std::max(1u, workers);
+  ComparisonSummary summary;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t next_task = 0u;
+  std::size_t next_write = 0u;
+  std::map<std::size_t, std::unique_ptr<Outcome>> pending;
+  std::exception_ptr failure;
+  const auto& work = [&]() {
+    while (true) {
+      std::size_t index = 0u;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() {
+          return failure || next_task == tasks.size() ||
+                 next_task < next_write + window;
+        });
+        if (failure || next_task == tasks.size()) {
+          return;
+        }
+        index = next_task++;
+      }
+      auto outcome = run_task(src, dst, tasks[index]);
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.emplace(index, std::move(outcome));
+      try {
+        for (auto it = pending.find(next_write); it != pending.end();
+             it = pending.find(next_write)) {
+          write_outcome(tasks[next_write], *it->second, writer, summary);
+          pending.erase(it);
+          ++next_write;
+        }
+      } catch (...) {
+        failure = std::current_exception();
+      }
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto count = std::min<std::size_t>(workers, tasks.size());
+  for (auto i = 1u; i < count; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+  return summary;
+}
+
+}  // namespace touca
@@ -8,7 +8,8 @@
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
-#include "touca/cli/deserialize.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/resultlog.hpp"
 #include "touca/core/testcase.hpp"
 #include "touca/core/utils.hpp"
 #include "touca/impl/schema.hpp"
@@ -27,6 +28,17 @@ bool ResultFile::validate() const {
   if (!touca::filesystem::is_regular_file(_path)) {
     return false;
   }
+
+  // result logs are validated by reading their index
+  if (ResultLog::is_result_log(_path.string())) {
+    try {
+      ResultLog::read_index(_path.string());
+      return true;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+
   const auto& content =
       detail::load_string_file(_path.string(), std::ios::in | std::ios::binary);
   return validate(content);
@@ -45,6 +57,18 @@ ElementsMap ResultFile::parse() const {
     return _testcases;
   }
 
+  ElementsMap testcases;
+  if (ResultLog::is_result_log(_path.string())) {
+    ResultLog::read(_path.string(),
+                    [&testcases](const ResultLog::Entry& entry,
+                                 const std::vector<uint8_t>& data) {
+                      testcases.emplace(entry.testcase,
+                                        std::make_shared<Testcase>(
+                                            deserialize_testcase(data)));
+                    });
+    return testcases;
+  }
+
   const auto& content =
       detail::load_string_file(_path.string(), std::ios::in | std::ios::binary);
 
@@ -53,7 +77,6 @@ ElementsMap ResultFile::parse() const {
     throw std::runtime_error("result file invalid: " + _path.string());
   }
 
-  ElementsMap testcases;
   // parse content of given file
   const auto& messages = touca::fbs::GetMessages(content.c_str());
   for (const auto&& message : *messages->messages()) {
@@ -91,4 +114,95 @@ void ResultFile::merge(const ResultFile& other) {
   _testcases.insert(tcs.begin(), tcs.end());
 }
 
+ResultReader::ResultReader(const touca::filesystem::path& path)
+    : _path(path) {
+  if (!touca::filesystem::is_regular_file(_path)) {
+    throw std::runtime_error("result file missing: " + _path.string());
+  }
+
+  if (ResultLog::is_result_log(_path.string())) {
+    for (const auto& entry : ResultLog::read_index(_path.string())) {
+      _records.emplace(entry.testcase, Record{entry.offset, entry.size});
+    }
+    _input.open(_path.string(), std::ios::in | std::ios::binary);
+    return;
+  }
+
+  _content =
+      detail::load_string_file(_path.string(), std::ios::in | std::ios::binary);
+  flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t*>(_content.data()), _content.size());
+  if (!verifier.VerifyBuffer<touca::fbs::Messages>()) {
+    throw std::runtime_error("result file invalid: " + _path.string());
+  }
+  const auto& messages = touca::fbs::GetMessages(_content.c_str());
+  for (const auto&& message : *messages->messages()) {
+    const auto& buffer = message->buf();
+    flatbuffers::Verifier message_verifier(buffer->data(), buffer->size());
+    if (!message_verifier.VerifyBuffer<touca::fbs::Message>()) {
+      throw std::runtime_error("result file invalid: " + _path.string());
+    }
+    const auto& metadata =
+        flatbuffers::GetRoot<touca::fbs::Message>(buffer->data())->metadata();
+    if (!metadata || !metadata->testcase()) {
+      throw std::runtime_error("result file invalid: " + _path.string());
+    }
+    const auto offset = static_cast<std::uint64_t>(
+        buffer->data() - reinterpret_cast<const uint8_t*>(_content.data()));
+    _records.emplace(metadata->testcase()->str(),
+                     Record{offset, buffer->size()});
+  }
+}
+
+std::vector<std::string> ResultReader::names() const {
+  std::vector<std::string> names;
+  names.reserve(_records.size());
+  for (const auto& record : _records) {
+    names.push_back(record.first);
+  }
+  return names;
+}
+
+bool ResultReader::contains(const std::string& name) const {
+  return _records.count(name) != 0u;
+}
+
+Testcase ResultReader::read(const std::string& name) {
+  const auto& it = _records.find(name);
+  if (it == _records.end()) {
+    throw std::runtime_error("result file " + _path.string() +
+                             " has no testcase " + name);
+  }
+  if (_content.empty()) {
+    const ResultLog::Entry entry{name, it->second.offset, it->second.size};
+    return deserialize_testcase(ResultLog::read_record(_input, entry));
+  }
+  const auto& ptr =
+      reinterpret_cast<const uint8_t*>(_content.data()) + it->second.offset;
+  return deserialize_testcase(
+      std::vector<uint8_t>(ptr, ptr + it->second.size));
+}
+
+void compare(ResultReader& src, ResultReader& dst, ComparisonWriter& writer) {
+  const auto& src_names = src.names();
+  const auto& dst_names = dst.names();
+  for (const auto& name : src_names) {
+    if (!dst.contains(name)) {
+      writer.add_fresh(src.read(name).metadata());
+    }
+  }
+  for (const auto& name : dst_names) {
+    if (!src.contains(name)) {
+      writer.add_missing(dst.read(name).metadata());
+    }
+  }
+  for (const auto& name : src_names) {
+    if (dst.contains(name)) {
+      const auto& src_testcase = src.read(name);
+      const auto& dst_testcase = dst.read(name);
+      writer.add_common(TestcaseComparison(src_testcase, dst_testcase));
+    }
+  }
+}
+
 }  // namespace touca
@@ -0,0 +1,89 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+
+#include "cxxopts.hpp"
+#include "touca/cli/operations.hpp"
+#include "touca/cli/server.hpp"
+#include "touca/core/utils.hpp"
+
+static volatile std::sig_atomic_t interrupted = 0;
+
+static void on_signal(int) { interrupted = 1; }
+
+static void print_stats(const touca::SubmissionServer::Stats& stats) {
+  const auto megabytes = static_cast<double>(stats.bytes) / 1048576.0;
+  fmt::print(stdout,
+             "stored {} submissions of {} testcases ({:.1f} MB), {} retried, "
+             "{} rejected",
+             stats.submissions, stats.testcases, megabytes, stats.duplicates,
+             stats.rejected);
+  if (stats.seconds > 0.0) {
+    fmt::print(stdout, ", {:.0f} testcases/s, {:.1f} MB/s",
+               static_cast<double>(stats.testcases) / stats.seconds,
+               megabytes / stats.seconds);
+  }
+  fmt::print(stdout, "\n");
+  std::fflush(stdout);
+}
+
+bool ServeOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=serve");
+  // clang-format off
+    options.add_options("main")
+        ("dir", "directory to store submitted test results in", cxxopts::value<std::string>())
+        ("host", "address to listen on", cxxopts::value<std::string>()->default_value("127.0.0.1"))
+        ("port", "port to listen on, or 0 for any free port", cxxopts::value<int>()->default_value("8080"))
+        ("api-key", "API key to accept, if only one should be accepted", cxxopts::value<std::string>())
+        ("report-interval", "seconds between reports of ingest throughput, or 0 to only report on exit", cxxopts::value<unsigned>()->default_value("10"));
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (!result.count("dir")) {
+    touca::print_error("result directory not provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  _options.dir = result["dir"].as<std::string>();
+  _options.host = result["host"].as<std::string>();
+  _options.port = result["port"].as<int>();
+  if (result.count("api-key")) {
+    _options.api_key = result["api-key"].as<std::string>();
+  }
+  _report_interval = result["report-interval"].as<unsigned>();
+  return true;
+}
+
+bool ServeOperation::run_impl() const {
+  touca::SubmissionServer server(_options);
+  server.start();
+  fmt::print(stdout, "listening on {}, storing results in {}\n", server.url(),
+             _options.dir.string());
+  std::fflush(stdout);
+
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+  auto reported = server.stats().submissions;
+  auto next_report = std::chrono::steady_clock::now() +
+                     std::chrono::seconds(_report_interval);
+  while (!interrupted) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (_report_interval == 0u ||
+        std::chrono::steady_clock::now() < next_report) {
+      continue;
+    }
+    next_report += std::chrono::seconds(_report_interval);
+    const auto& stats = server.stats();
+    if (stats.submissions != reported) {
+      reported = stats.submissions;
+      print_stats(stats);
+    }
+  }
+
+  server.stop();
+  print_stats(server.stats());
+  return true;
+}
@@ -0,0 +1,397 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/cli/server.hpp"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "httplib.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "touca/core/resultlog.hpp"
+#include "touca/core/utils.hpp"
+#include "touca/impl/schema.hpp"
+
+namespace touca {
+
+/**
+ * Results of one testcase, as found in a submission.
+ */
+struct SubmittedTestcase {
+  std::string team;
+  std::string suite;
+  std::string version;
+  std::string testcase;
+  std::vector<std::uint8_t> message;
+};
+
+/**
+ * Checks that a name can be used as a directory name in the result store.
+ */
+static bool is_path_component(const std::string& name) {
+  return !name.empty() && name != "." && name != ".." &&
+         name.find_first_of("/\\") == std::string::npos;
+}
+
+/**
+ * Verifies a submission and extracts the testcases it holds.
+ *
+ * @return false if the submission is not a valid flatbuffers `Messages`
+ *         buffer or if any of its messages lacks the metadata that
+ *         identifies its testcase.
+ */
+static bool parse_submission(const std::string& content,
+                             std::vector<SubmittedTestcase>& testcases) {
+  const auto data = reinterpret_cast<const std::uint8_t*>(content.data());
+  flatbuffers::Verifier verifier(data, content.size());
+  if (!verifier.VerifyBuffer<fbs::Messages>()) {
+    return false;
+  }
+  const auto& messages = fbs::GetMessages(data)->messages();
+  if (!messages) {
+    return false;
+  }
+  for (const auto&& item : *messages) {
+    const auto& buffer = item->buf();
+    if (!buffer) {
+      return false;
+    }
+    flatbuffers::Verifier message_verifier(buffer->data(), buffer->size());
+    if (!message_verifier.VerifyBuffer<fbs::Message>()) {
+      return false;
+    }
+    const auto& metadata =
+        flatbuffers::GetRoot<fbs::Message>(buffer->data())->metadata();
+    if (!metadata || !metadata->teamslug() || !metadata->testsuite() ||
+        !metadata->version() || !metadata->testcase()) {
+      return false;
+    }
+    SubmittedTestcase testcase{
+        metadata->teamslug()->str(), metadata->testsuite()->str(),
+        metadata->version()->str(), metadata->testcase()->str(),
+        std::vector<std::uint8_t>(buffer->data(),
+                                  buffer->data() + buffer->size())};
+    if (!is_path_component(testcase.team) ||
+        !is_path_component(testcase.suite) ||
+        !is_path_component(testcase.version) || testcase.testcase.empty()) {
+      return false;
+    }
+    testcases.push_back(std::move(testcase));
+  }
+  return true;
+}
+
+/**
+ * Entity tag of a list of testcases, which changes whenever a testcase
+ * is added to the list.
+ */
+static std::string make_etag(const std::set<std::string>& elements) {
+  std::string content;
+  for (const auto& element : elements) {
+    content.append(element).push_back('\n');
+  }
+  return touca::detail::format("\"{:x}-{}\"",
+                               std::hash<std::string>{}(content),
+                               elements.size());
+}
+
+static std::string make_elements_json(const std::set<std::string>& elements) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  writer.StartArray();
+  for (const auto& element : elements) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(element.c_str(),
+                  static_cast<rapidjson::SizeType>(element.size()));
+    writer.EndObject();
+  }
+  writer.EndArray();
+  return buffer.GetString();
+}
+
+struct SubmissionServer::Impl {
+  explicit Impl(const Options& options);
+
+  void load_store();
+  bool is_authorized(const httplib::Request& req) const;
+  void signin(const httplib::Request& req, httplib::Response& res);
+  void elements(const httplib::Request& req, httplib::Response& res);
+  void submit(const httplib::Request& req, httplib::Response& res);
+  void seal(const httplib::Request& req, httplib::Response& res);
+  void close_logs();
+
+  Options options;
+  std::string token;
+  httplib::Server server;
+  std::thread thread;
+  int port = -1;
+
+  mutable std::mutex mutex;
+  /** result logs of versions that are not sealed, by team/suite/version */
+  std::map<std::string, std::unique_ptr<ResultLog>> logs;
+  /** versions with stored results, by team/suite/version */
+  std::set<std::string> versions;
+  /** names of testcases with stored results, by team/suite */
+  std::map<std::string, std::set<std::string>> elements_by_suite;
+  /** idempotency keys of stored submissions */
+  std::unordered_set<std::string> keys;
+  Stats stats;
+  std::chrono::steady_clock::time_point first;
+  std::chrono::steady_clock::time_point last;
+};
+
+SubmissionServer::Impl::Impl(const Options& options) : options(options) {
+  std::random_device device;
+  token = touca::detail::format("{:08x}{:08x}{:08x}{:08x}", device(), device(),
+                                device(), device());
+  load_store();
+
+  using namespace std::placeholders;
+  server.Get("/platform", [](const httplib::Request&, httplib::Response& res) {
+    res.set_content(R"({"ready":true})", "application/json");
+  });
+  server.Post("/client/signin", std::bind(&Impl::signin, this, _1, _2));
+  server.Get(R"(/client/element/([^/]+)/([^/]+))",
+             std::bind(&Impl::elements, this, _1, _2));
+  server.Post("/client/submit", std::bind(&Impl::submit, this, _1, _2));
+  server.Post(R"(/batch/([^/]+)/([^/]+)/([^/]+)/seal2)",
+              std::bind(&Impl::seal, this, _1, _2));
+}
+
+/**
+ * Finds testcases stored in result logs of an earlier session, so that
+ * they are reported as testcases of their suite.
+ */
+void SubmissionServer::Impl::load_store() {
+  touca::filesystem::create_directories(options.dir);
+  for (const auto& entry :
+       touca::filesystem::recursive_directory_iterator(options.dir)) {
+    if (!entry.is_regular_file() ||
+        entry.path().filename() != "touca.results") {
+      continue;
+    }
+    // result logs are expected at `<team>/<suite>/<version>/touca.results`
+    std::vector<std::string> names;
+    for (const auto& name :
+         entry.path().parent_path().lexically_relative(options.dir)) {
+      names.push_back(name.string());
+    }
+    if (names.size() != 3u) {
+      continue;
+    }
+    std::vector<ResultLog::Entry> index;
+    try {
+      index = ResultLog::read_index(entry.path().string());
+    } catch (const std::exception&) {
+      continue;
+    }
+    const auto& suite = touca::detail::format("{}/{}", names[0], names[1]);
+    versions.insert(touca::detail::format("{}/{}", suite, names[2]));
+    auto& elements = elements_by_suite[suite];
+    for (const auto& item : index) {
+      elements.insert(item.testcase);
+    }
+  }
+}
+
+bool SubmissionServer::Impl::is_authorized(
+    const httplib::Request& req) const {
+  return req.get_header_value("Authorization") == "Bearer " + token;
+}
+
+void SubmissionServer::Impl::signin(const httplib::Request& req,
+                                    httplib::Response& res) {
+  rapidjson::Document parsed;
+  if (parsed.Parse<0>(req.body.c_str()).HasParseError() ||
+      !parsed.IsObject() || !parsed.HasMember("key") ||
+      !parsed["key"].IsString()) {
+    res.status = 400;
+    return;
+  }
+  if (!options.api_key.empty() &&
+      options.api_key != parsed["key"].GetString()) {
+    res.status = 401;
+    return;
+  }
+  res.set_content(touca::detail::format(R"({{"token":"{}"}})", token),
+                  "application/json");
+}
+
+void SubmissionServer::Impl::elements(const httplib::Request& req,
+                                      httplib::Response& res) {
+  if (!is_authorized(req)) {
+    res.status = 401;
+    return;
+  }
+  const auto& suite = touca::detail::format("{}/{}", req.matches[1].str(),
+                                            req.matches[2].str());
+  std::set<std::string> elements;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto& it = elements_by_suite.find(suite);
+    if (it != elements_by_suite.end()) {
+      elements = it->second;
+    }
+  }
+  const auto& etag = make_etag(elements);
+  res.set_header("ETag", etag);
+  if (req.get_header_value("If-None-Match") == etag) {
+    res.status = 304;
+    return;
+  }
+  res.set_content(make_elements_json(elements), "application/json");
+}
+
+void SubmissionServer::Impl::submit(const httplib::Request& req,
+                                    httplib::Response& res) {
+  const auto& received = std::chrono::steady_clock::now();
+  if (!is_authorized(req)) {
+    res.status = 401;
+    return;
+  }
+  const auto& key = req.get_header_value("Idempotency-Key");
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!key.empty() && keys.count(key)) {
+      ++stats.duplicates;
+      res.status = 204;
+      return;
+    }
+  }
+  std::vector<SubmittedTestcase> testcases;
+  if (!parse_submission(req.body, testcases)) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++stats.rejected;
+    res.status = 400;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  // a retry may have been stored while this submission was verified
+  if (!key.empty() && keys.count(key)) {
+    ++stats.duplicates;
+    res.status = 204;
+    return;
+  }
+  try {
+    for (const auto& testcase : testcases) {
+      const auto& suite =
+          touca::detail::format("{}/{}", testcase.team, testcase.suite);
+      const auto& version =
+          touca::detail::format("{}/{}", suite, testcase.version);
+      auto& log = logs[version];
+      if (!log) {
+        const auto& dir =
+            options.dir / testcase.team / testcase.suite / testcase.version;
+        touca::filesystem::create_directories(dir);
+        log.reset(new ResultLog((dir / "touca.results").string()));
+      }
+      log->append(testcase.testcase, testcase.message);
+      versions.insert(version);
+      elements_by_suite[suite].insert(testcase.testcase);
+    }
+  } catch (const std::exception&) {
+    res.status = 500;
+    return;
+  }
+  if (!key.empty()) {
+    keys.insert(key);
+  }
+  if (stats.submissions == 0u) {
+    first = received;
+  }
+  last = std::chrono::steady_clock::now();
+  ++stats.submissions;
+  stats.testcases += testcases.size();
+  stats.bytes += req.body.size();
+  res.status = 204;
+}
+
+void SubmissionServer::Impl::seal(const httplib::Request& req,
+                                  httplib::Response& res) {
+  if (!is_authorized(req)) {
+    res.status = 401;
+    return;
+  }
+  const auto& version =
+      touca::detail::format("{}/{}/{}", req.matches[1].str(),
+                            req.matches[2].str(), req.matches[3].str());
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!versions.count(version)) {
+    res.status = 404;
+    return;
+  }
+  // results submitted after the version is sealed are appended to the
+  // same result log once it is reopened.
+  const auto& it = logs.find(version);
+  if (it != logs.end()) {
+    it->second->close();
+    logs.erase(it);
+  }
+  res.status = 204;
+}
+
+void SubmissionServer::Impl::close_logs() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto& kvp : logs) {
+    kvp.second->close();
+  }
+  logs.clear();
+}
+
+SubmissionServer::SubmissionServer(const Options& options)
+    : _impl(new Impl(options)) {}
+
+SubmissionServer::~SubmissionServer() { stop(); }
+
+void SubmissionServer::start() {
+  if (_impl->thread.joinable()) {
+    return;
+  }
+  const auto& host = _impl->options.host;
+  if (_impl->options.port == 0) {
+    _impl->port = _impl->server.bind_to_any_port(host);
+  } else if (_impl->server.bind_to_port(host, _impl->options.port)) {
+    _impl->port = _impl->options.port;
+  }
+  if (_impl->port < 0) {
+    throw std::runtime_error(touca::detail::format(
+        "failed to listen on {}:{}", host, _impl->options.port));
+  }
+  _impl->thread = std::thread([this]() { _impl->server.listen_after_bind(); });
+  while (!_impl->server.is_running()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void SubmissionServer::stop() {
+  if (_impl->thread.joinable()) {
+    _impl->server.stop();
+    _impl->thread.join();
+  }
+  _impl->close_logs();
+}
+
+std::string SubmissionServer::url() const {
+  return touca::detail::format("http://{}:{}", _impl->options.host,
+                               _impl->port);
+}
+
+SubmissionServer::Stats SubmissionServer::stats() const {
+  std::lock_guard<std::mutex> lock(_impl->mutex);
+  auto stats = _impl->stats;
+  stats.seconds =
+      std::chrono::duration<double>(_impl->last - _impl->first).count();
+  return stats;
+}
+
+}  // namespace touca
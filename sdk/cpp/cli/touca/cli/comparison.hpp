@@ -2,12 +2,19 @@
 
 #pragma once
 
+#include <cstdint>
+#include <istream>
 #include <numeric>
+#include <ostream>
+#include <vector>
 
 #include "touca/core/testcase.hpp"
 #include "touca/core/comparison.hpp"
 
 namespace touca {
+namespace fbs {
+struct CaseComparison;
+}  // namespace fbs
 
 class TOUCA_CLIENT_API TestcaseComparison {
  public:
@@ -29,6 +36,15 @@ class TOUCA_CLIENT_API TestcaseComparison {
 
   rapidjson::Value json(RJAllocator& allocator) const;
 
+  /**
+   * @brief provides description of this object in flatbuffers format,
+   *        as a `CaseComparison` table.
+   *
+   * @details Unlike `json`, only includes values of keys that do not
+   *          match.
+   */
+  std::vector<uint8_t> flatbuffers() const;
+
   Overview overview() const;
 
  private:
@@ -76,6 +92,86 @@ struct TOUCA_CLIENT_API ElementsMapComparison {
   std::string json() const;
 };
 
+/**
+ * @brief Writes comparison results of testcases to an output stream as
+ *        soon as they are added, so that results of earlier testcases
+ *        need not be kept in memory.
+ *
+ * @details In `json` format, the output is a single object with the same
+ *          members as the output of `ElementsMapComparison::json`, which
+ *          requires all new testcases to be added before missing ones and
+ *          all missing testcases to be added before common ones. In
+ *          `ndjson` format, each testcase is written on a separate line as
+ *          an object with one member `newCase`, `missingCase` or
+ *          `commonCase`, in any order. In `binary` format, the output
+ *          starts with an eight-byte magic string followed by a flatbuffers
+ *          `CaseComparison` table for each testcase, in any order, each
+ *          prefixed with its size as a little-endian 32-bit integer.
+ *          Comparison results in `binary` format are read back using
+ *          `ComparisonReader`.
+ */
+class TOUCA_CLIENT_API ComparisonWriter {
+ public:
+  enum class Format : unsigned char { json, ndjson, binary };
+
+  ComparisonWriter(std::ostream& out, const Format format);
+
+  void add_fresh(const Testcase::Metadata& metadata);
+
+  void add_missing(const Testcase::Metadata& metadata);
+
+  void add_common(const TestcaseComparison& comparison);
+
+  /**
+   * Completes the output and flushes the output stream.
+   * No testcase may be added afterwards.
+   */
+  void close();
+
+ private:
+  enum class Section : unsigned char { none, fresh, missing, common, closed };
+
+  void write(const Section section, rapidjson::Value& value,
+             RJAllocator& allocator);
+
+  void write(const Section section, const std::vector<uint8_t>& buffer);
+
+  void enter(const Section section);
+
+  std::ostream& _out;
+  Format _format;
+  Section _section = Section::none;
+  bool _first = true;
+};
+
+/**
+ * @brief reads comparison results that `ComparisonWriter` wrote in
+ *        `binary` format, one testcase at a time.
+ */
+class TOUCA_CLIENT_API ComparisonReader {
+ public:
+  /**
+   * @throw std::runtime_error if the stream does not start with
+   *        comparison results in binary format
+   */
+  explicit ComparisonReader(std::istream& input);
+
+  /**
+   * Reads comparison results of the next testcase in the stream.
+   *
+   * @return comparison results that remain valid until the next call,
+   *         or nullptr if there are no more testcases in the stream
+   *
+   * @throw std::runtime_error if comparison results are truncated or
+   *        corrupted
+   */
+  const fbs::CaseComparison* next();
+
+ private:
+  std::istream& _input;
+  std::vector<uint8_t> _buffer;
+};
+
 TOUCA_CLIENT_API TypeComparison compare(const data_point& src,
                                         const data_point& dst);
 
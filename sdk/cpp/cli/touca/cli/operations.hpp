@@ -5,9 +5,20 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include "touca/cli/server.hpp"
 
 struct Operation {
-  enum class Command { compare, unknown, view };
+  enum class Command {
+    bench_submit,
+    compare,
+    merge,
+    serve,
+    unknown,
+    upload,
+    view
+  };
 
   static Command find_mode(const std::string& name);
 
@@ -47,6 +58,58 @@ struct ViewOperation : public Operation {
   std::string _src;
 };
 
+struct MergeOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  std::vector<std::string> _src;
+  std::string _out;
+};
+
+struct UploadOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  std::string _src;
+  std::string _api_key;
+  std::string _api_url;
+};
+
+struct ServeOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  touca::SubmissionServer::Options _options;
+  unsigned _report_interval = 10u;
+};
+
+struct BenchSubmitOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  std::string _api_url;
+  std::string _api_key;
+  std::string _dir;
+  std::string _shape;
+  unsigned _testcases = 0u;
+  unsigned _keys = 0u;
+  unsigned _size = 0u;
+  unsigned _batch = 0u;
+  unsigned _concurrency = 0u;
+};
+
 struct CompareOperation : public Operation {
  protected:
   bool parse_impl(int argc, char* argv[]) override;
@@ -56,4 +119,7 @@ struct CompareOperation : public Operation {
  private:
   std::string _src;
   std::string _dst;
+  std::string _format;
+  std::string _output;
+  unsigned _workers;
 };
@@ -0,0 +1,94 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file resultdir.hpp
+ *
+ * @brief declares class touca::ResultDirectory which finds test results
+ *        written by the test runner for one version of a suite.
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "touca/cli/comparison.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/resultlog.hpp"
+
+namespace touca {
+
+/**
+ * @brief provides access to test results that the test runner wrote
+ *        to the output directory of one version of a suite, such as
+ *        `output_dir/suite/version`.
+ *
+ * @details Results of each testcase are either in a `touca.bin` file in
+ *          a subdirectory named after the testcase or in a `touca.results`
+ *          log at the top of the directory. Previous results moved to the
+ *          `.trash` subdirectory are ignored. Results of a testcase are
+ *          only read from disk when they are requested, and may be read
+ *          from several threads at the same time.
+ */
+class ResultDirectory {
+ public:
+  /**
+   * @throw std::runtime_error if the directory does not exist or if
+   *        the index of a result log cannot be read.
+   */
+  explicit ResultDirectory(const touca::filesystem::path& path);
+
+  /**
+   * @return names of all testcases in the directory, in sorted order
+   */
+  std::vector<std::string> names() const;
+
+  bool contains(const std::string& name) const;
+
+  /**
+   * @throw std::runtime_error if the directory has no testcase with the
+   *        given name or if its results cannot be read.
+   */
+  Testcase read(const std::string& name) const;
+
+ private:
+  touca::filesystem::path _path;
+  std::map<std::string, touca::filesystem::path> _files;
+  std::map<std::string, std::pair<touca::filesystem::path, ResultLog::Entry>>
+      _entries;
+};
+
+/**
+ * @brief describes outcome of comparing all testcases of two directories.
+ *
+ * @param fresh number of testcases only found in the source directory
+ * @param missing number of testcases only found in the destination
+ * @param common number of testcases found in both directories
+ * @param perfect number of common testcases whose results match
+ * @param score sum of match scores of all common testcases
+ * @param errors descriptions of testcases that could not be compared
+ */
+struct ComparisonSummary {
+  std::size_t fresh = 0u;
+  std::size_t missing = 0u;
+  std::size_t common = 0u;
+  std::size_t perfect = 0u;
+  double score = 0.0;
+  std::vector<std::string> errors;
+};
+
+/**
+ * Compares all testcases of two result directories using the given
+ * number of threads, each of which loads and compares one testcase at a
+ * time. Comparison results are passed to the writer in the same order as
+ * `ElementsMapComparison::json` lists them, as soon as all testcases
+ * before them are written. Testcases whose results cannot be read are
+ * skipped and reported in the returned summary.
+ */
+ComparisonSummary compare(const ResultDirectory& src,
+                          const ResultDirectory& dst, ComparisonWriter& writer,
+                          const unsigned workers);
+
+}  // namespace touca
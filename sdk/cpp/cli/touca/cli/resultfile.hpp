@@ -10,6 +10,12 @@
  *        files.
  */
 
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "touca/cli/comparison.hpp"
 #include "touca/core/filesystem.hpp"
 
@@ -17,6 +23,9 @@ namespace touca {
 
 /**
  * @brief provides means for interacting with test result files.
+ *
+ * @details Supports both result files holding a flatbuffers `Messages`
+ *          buffer and result logs written by the test runner.
  */
 class ResultFile {
  public:
@@ -117,4 +126,55 @@ class ResultFile {
   touca::filesystem::path _path;
 };
 
+/**
+ * @brief reads testcases of a test result file one at a time.
+ *
+ * @details Unlike `ResultFile::parse`, only keeps the names and positions
+ *          of testcases in memory and deserializes results of a testcase
+ *          when it is read. Records of result logs are read from disk on
+ *          demand. Result files holding a flatbuffers `Messages` buffer
+ *          are kept in memory in their serialized form.
+ */
+class ResultReader {
+ public:
+  /**
+   * @throw std::runtime_error if file is missing or is not a valid
+   *        test result file.
+   */
+  explicit ResultReader(const touca::filesystem::path& path);
+
+  /**
+   * @return names of all testcases in the file, in sorted order
+   */
+  std::vector<std::string> names() const;
+
+  bool contains(const std::string& name) const;
+
+  /**
+   * @throw std::runtime_error if the file has no testcase with the given
+   *        name or if its results cannot be read.
+   */
+  Testcase read(const std::string& name);
+
+ private:
+  struct Record {
+    std::uint64_t offset;
+    std::uint32_t size;
+  };
+
+  touca::filesystem::path _path;
+  std::ifstream _input;
+  std::string _content;
+  std::map<std::string, Record> _records;
+};
+
+/**
+ * Compares all testcases of two test result files and passes the result
+ * for each testcase to the given writer as soon as it is computed, so
+ * that at most one testcase of each file is held in memory.
+ *
+ * @throw std::runtime_error if a testcase of either file cannot be read
+ */
+void compare(ResultReader& src, ResultReader& dst, ComparisonWriter& writer);
+
 }  // namespace touca
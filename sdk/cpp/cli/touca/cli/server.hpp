@@ -0,0 +1,84 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file server.hpp
+ *
+ * @brief declares class touca::SubmissionServer, a local stand-in for the
+ *        Touca server that stores submitted test results on disk.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "touca/core/filesystem.hpp"
+
+namespace touca {
+
+/**
+ * @brief Local stand-in for the Touca server that accepts test results
+ *        submitted by the client library, for load testing the path from
+ *        `ClientImpl::post` to `Platform::submit` without a real server.
+ *
+ * @details Implements the routes that the client library uses to sign in,
+ *          to fetch the list of testcases of a suite, to submit results
+ *          and to seal a version. Submitted results are verified and
+ *          appended to a result log per version, at
+ *          `<dir>/<team>/<suite>/<version>/touca.results`, which is closed
+ *          when the version is sealed or when the server stops. Testcases
+ *          found in result logs of an earlier session are reported as
+ *          testcases of their suite.
+ */
+class SubmissionServer {
+ public:
+  struct Options {
+    std::string host = "127.0.0.1";
+    int port = 0; /**< port to listen on, or zero for any free port */
+    touca::filesystem::path dir; /**< directory to store results in */
+    std::string api_key; /**< API key to accept, or empty to accept any */
+  };
+
+  struct Stats {
+    std::uint64_t submissions = 0u; /**< submissions that were stored */
+    std::uint64_t duplicates = 0u;  /**< retries of stored submissions */
+    std::uint64_t rejected = 0u;    /**< submissions that were invalid */
+    std::uint64_t testcases = 0u;   /**< testcases that were stored */
+    std::uint64_t bytes = 0u;       /**< size of stored submissions */
+    double seconds = 0.0; /**< from first to last stored submission */
+  };
+
+  explicit SubmissionServer(const Options& options);
+
+  /** Stops the server if it is running and closes all result logs. */
+  ~SubmissionServer();
+
+  SubmissionServer(const SubmissionServer&) = delete;
+  SubmissionServer& operator=(const SubmissionServer&) = delete;
+
+  /**
+   * Starts serving requests on a background thread.
+   *
+   * @throw std::runtime_error if the server cannot listen on the port
+   */
+  void start();
+
+  /**
+   * Stops serving requests and closes all result logs.
+   */
+  void stop();
+
+  /**
+   * @return URL that the client library can use as `api-url`
+   */
+  std::string url() const;
+
+  Stats stats() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+}  // namespace touca
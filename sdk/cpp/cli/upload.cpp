@@ -0,0 +1,77 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cstdlib>
+
+#include "cxxopts.hpp"
+#include "touca/cli/operations.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/platform.hpp"
+#include "touca/core/spool.hpp"
+#include "touca/core/utils.hpp"
+
+bool UploadOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=upload");
+  // clang-format off
+    options.add_options("main")
+        ("src", "spool directory of test results that are not yet submitted", cxxopts::value<std::string>())
+        ("api-key", "API key to authenticate to the server, if not set in environment variable TOUCA_API_KEY", cxxopts::value<std::string>())
+        ("api-url", "URL to the server API, if not set in environment variable TOUCA_API_URL", cxxopts::value<std::string>());
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (!result.count("src")) {
+    touca::print_error("spool directory not provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  _src = result["src"].as<std::string>();
+  if (!touca::filesystem::is_directory(_src)) {
+    touca::print_error("directory `{}` does not exist\n", _src);
+    return false;
+  }
+  if (result.count("api-key")) {
+    _api_key = result["api-key"].as<std::string>();
+  } else if (const auto value = std::getenv("TOUCA_API_KEY")) {
+    _api_key = value;
+  }
+  if (result.count("api-url")) {
+    _api_url = result["api-url"].as<std::string>();
+  } else if (const auto value = std::getenv("TOUCA_API_URL")) {
+    _api_url = value;
+  }
+  if (_api_key.empty() || _api_url.empty()) {
+    touca::print_error("API key and API URL are required\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  return true;
+}
+
+bool UploadOperation::run_impl() const {
+  touca::Platform platform(touca::ApiUrl{_api_url});
+  if (!platform.get_error().empty()) {
+    touca::print_error("{}\n", platform.get_error());
+    return false;
+  }
+  if (!platform.auth(_api_key)) {
+    touca::print_error("failed to authenticate: {}\n", platform.get_error());
+    return false;
+  }
+  const touca::Spool spool(_src);
+  const auto& count = spool.pending().size();
+  std::vector<std::string> errors;
+  std::vector<std::string> rejections;
+  const auto uploaded = spool.replay(platform, errors, rejections);
+  for (const auto& err : rejections) {
+    touca::print_error("{}\n", err);
+  }
+  for (const auto& err : errors) {
+    touca::print_error("{}\n", err);
+  }
+  fmt::print(stdout, "uploaded {} of {} submissions\n", uploaded, count);
+  if (!rejections.empty()) {
+    fmt::print(stdout, "rejected submissions are set aside in {}\n",
+               spool.failed_dir().string());
+  }
+  return errors.empty() && rejections.empty();
+}
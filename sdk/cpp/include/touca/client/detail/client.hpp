@@ -2,12 +2,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 
 #include "touca/client/detail/options.hpp"
 #include "touca/core/filesystem.hpp"
 #include "touca/core/platform.hpp"
+#include "touca/core/spool.hpp"
 #include "touca/core/testcase.hpp"
 #include "touca/extra/logger.hpp"
 
@@ -24,6 +27,18 @@ enum class DataFormat : unsigned char {
   JSON /**< json */
 };
 
+/**
+ * Finds a platform that is signed in to the server with the given API
+ * key, or signs in if there is none. Platforms are shared by all clients
+ * of this process, so that configuring clients for other suites, or the
+ * same client again, does not sign in again.
+ *
+ * @return nullptr if authentication failed, with the reason in `error`
+ */
+std::shared_ptr<Platform> find_session(const ApiUrl& api_url,
+                                       const ClientOptions& options,
+                                       std::string& error);
+
 /**
  * We are exposing this class for convenient unit-testing.
  */
@@ -49,6 +64,10 @@ class TOUCA_CLIENT_API ClientImpl {
 
   std::shared_ptr<Testcase> declare_testcase(const std::string& name);
 
+  std::shared_ptr<Testcase> find_testcase(const std::string& name) const;
+
+  void adopt_testcase(const std::shared_ptr<Testcase>& testcase);
+
   void forget_testcase(const std::string& name);
 
   void check(const std::string& key, const data_point& value);
@@ -65,6 +84,19 @@ class TOUCA_CLIENT_API ClientImpl {
 
   void stop_timer(const std::string& key);
 
+  /**
+   * Starts measuring a scope of code. Unless option `profile` is set,
+   * behaves like `start_timer`. Otherwise, scopes started on the same
+   * thread are nested and each scope is accounted for by its call path.
+   */
+  void start_scope(const std::string& name);
+
+  /**
+   * Stops measuring the scope of code most recently started on the
+   * calling thread.
+   */
+  void stop_scope(const std::string& name);
+
   void save(const touca::filesystem::path& path,
             const std::vector<std::string>& testcases, const DataFormat format,
             const bool overwrite) const;
@@ -80,16 +112,26 @@ class TOUCA_CLIENT_API ClientImpl {
 
   bool has_last_testcase() const;
 
-  std::vector<Testcase> find_testcases(
+  std::vector<std::shared_ptr<Testcase>> find_testcases(
       const std::vector<std::string>& names) const;
 
+  void enforce_memory_budget();
+
   void save_json(const touca::filesystem::path& path,
-                 const std::vector<Testcase>& testcases) const;
+                 const std::vector<std::shared_ptr<Testcase>>& testcases) const;
 
-  void save_flatbuffers(const touca::filesystem::path& path,
-                        const std::vector<Testcase>& testcases) const;
+  void save_flatbuffers(
+      const touca::filesystem::path& path,
+      const std::vector<std::shared_ptr<Testcase>>& testcases) const;
 
-  bool post_flatbuffers(const std::vector<Testcase>& testcases) const;
+  /**
+   * Submits test results of the given testcases to the server.
+   * Safe to call from multiple threads at the same time.
+   *
+   * @return a list of errors, empty if submission succeeded
+   */
+  std::vector<std::string> post_flatbuffers(
+      const std::vector<std::shared_ptr<Testcase>>& testcases) const;
 
   void notify_loggers(const touca::logger::Level severity,
                       const std::string& msg) const;
@@ -101,9 +143,49 @@ class TOUCA_CLIENT_API ClientImpl {
   ClientOptions _options;
   ElementsMap _testcases;
   std::string _mostRecentTestcase;
+  std::size_t _memoryFloor = 0u;
+  // bytes held by results of all testcases, kept up to date by testcases
+  std::shared_ptr<std::atomic<std::size_t>> _memoryUsage =
+      std::make_shared<std::atomic<std::size_t>>(0u);
   std::unique_ptr<Platform> _platform;
+  std::unique_ptr<Spool> _spool;
+  std::unique_ptr<SpoolSubmitter> _submitter;
   std::unordered_map<std::thread::id, std::string> _threadMap;
   std::vector<std::shared_ptr<touca::logger>> _loggers;
 };
 
+/**
+ * Routes functions of the public API that are called on the calling
+ * thread to the given client, instead of the client shared by the whole
+ * process, until this object is destroyed. Lets workflows of different
+ * suites capture and submit their results at the same time.
+ */
+class TOUCA_CLIENT_API ClientScope {
+ public:
+  /**
+   * @param client client to route calls to, or nullptr to keep routing
+   *               calls to the current client.
+   */
+  explicit ClientScope(const std::shared_ptr<ClientImpl>& client);
+
+  ~ClientScope();
+
+  ClientScope(const ClientScope&) = delete;
+  ClientScope& operator=(const ClientScope&) = delete;
+
+  const std::shared_ptr<ClientImpl>& client() const { return _client; }
+
+  /**
+   * Routes calls made on the calling thread back to the client shared by
+   * the whole process, disregarding scopes that are still alive. Meant for
+   * processes forked from a thread that had a scope, whose scopes are
+   * never destroyed.
+   */
+  static void reset();
+
+ private:
+  std::shared_ptr<ClientImpl> _client;
+  ClientScope* _previous;
+};
+
 }  // namespace touca
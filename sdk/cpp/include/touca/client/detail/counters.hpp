@@ -0,0 +1,96 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file counters.hpp
+ *
+ * @brief declares class touca::detail::PerfCounters which reads hardware
+ *        performance counters of the calling thread.
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace touca {
+namespace detail {
+
+/**
+ * Hardware events counted by `PerfCounters`, in order of their values in
+ * `PerfCounters::Values`.
+ */
+enum class PerfEvent : unsigned char {
+  Instructions,
+  Cycles,
+  CacheMisses,
+  BranchMisses
+};
+
+/**
+ * Number of hardware events counted by `PerfCounters`.
+ */
+constexpr std::size_t perf_event_count = 4u;
+
+/**
+ * Suffix of the key of the metric that reports the given hardware event
+ * measured by a timer, e.g. `.instructions`.
+ */
+const char* perf_event_suffix(const PerfEvent event);
+
+/**
+ * @brief Hardware performance counters of the calling thread.
+ *
+ * @details Opens counters for instructions retired, cycles, cache misses
+ *          and branch misses through `perf_event_open`, counting events in
+ *          user space only. Counters that are not supported by the host,
+ *          which is common in virtual machines and containers, are left
+ *          closed. On platforms other than Linux, no counter is available.
+ *          Counters count events of the thread that created them, so each
+ *          thread should use its own instance.
+ */
+class PerfCounters {
+ public:
+  using Values = std::array<std::uint64_t, perf_event_count>;
+
+  PerfCounters();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /**
+   * @return the counters instance of the calling thread
+   */
+  static PerfCounters& local();
+
+  /**
+   * Checks whether the counter for the given event could be opened.
+   */
+  bool available(const PerfEvent event) const;
+
+  /**
+   * Checks whether at least one counter could be opened.
+   */
+  bool available() const;
+
+  /**
+   * @return reason the first counter that could not be opened failed
+   */
+  const std::string& error() const { return _error; }
+
+  /**
+   * Reads current values of all counters. Values are scaled up if the
+   * kernel multiplexed counters because it ran out of hardware registers.
+   * Values of counters that are not available are zero.
+   */
+  Values read() const;
+
+ private:
+  std::array<int, perf_event_count> _fds;
+  std::string _error;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -17,6 +17,16 @@ struct ClientOptions {
   std::string revision; /**< Team to which this suite belongs */
   bool offline = false; /**< Perform server handshake during configuration */
   bool single_thread = false; /**< Isolates testcase scope to calling thread */
+  unsigned max_testcase_memory = 0; /**< Memory budget per testcase in MB */
+  unsigned max_client_memory = 0;   /**< Memory budget of all testcases in MB */
+  std::string spill_dir; /**< Directory to spill results exceeding budget */
+  bool profile = false;  /**< Record scoped timers as a tree of call paths */
+  bool perf_counters = false; /**< Record hardware events of each timer */
+  unsigned connect_timeout = 10; /**< Seconds to wait for a connection */
+  unsigned read_timeout = 60;    /**< Seconds to wait for a response */
+  unsigned max_inflight = 4; /**< Maximum number of concurrent submissions */
+  std::string spool_dir; /**< Directory to keep submissions until accepted */
+  std::string cache_dir; /**< Directory to cache list of testcases of suites */
 };
 
 void parse_env_variables(ClientOptions& options);
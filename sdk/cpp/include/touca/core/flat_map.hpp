@@ -0,0 +1,183 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace touca {
+namespace detail {
+
+/**
+ * @brief Associative container with string keys that keeps its entries in
+ *        a contiguous vector, in order of insertion, and looks them up
+ *        through an open-addressing table of entry indices.
+ *
+ * @details Designed for test cases that capture many thousands of keys:
+ *          inserting an entry costs one hash computation and one append,
+ *          and iterating over all entries walks a single vector. Entries
+ *          cannot be removed individually. Callers that need a stable
+ *          key order, such as serializers, should call `sorted` once.
+ */
+template <typename Value>
+class flat_map {
+ public:
+  using value_type = std::pair<std::string, Value>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  std::pair<iterator, bool> emplace(const std::string& key, Value value) {
+    const auto hash = std::hash<std::string>{}(key);
+    auto slot = find_slot(key, hash);
+    if (_slots[slot] != empty_slot) {
+      return {_entries.begin() + _slots[slot], false};
+    }
+    if ((_entries.size() + 1) * 2 > _slots.size()) {
+      rehash(_slots.size() * 2);
+      slot = find_slot(key, hash);
+    }
+    _slots[slot] = static_cast<std::uint32_t>(_entries.size());
+    _entries.emplace_back(key, std::move(value));
+    _hashes.push_back(hash);
+    return {_entries.end() - 1, true};
+  }
+
+  iterator find(const std::string& key) {
+    const auto index = lookup(key);
+    return index == empty_slot ? _entries.end() : _entries.begin() + index;
+  }
+
+  const_iterator find(const std::string& key) const {
+    const auto index = lookup(key);
+    return index == empty_slot ? _entries.end() : _entries.begin() + index;
+  }
+
+  std::size_t count(const std::string& key) const {
+    return lookup(key) == empty_slot ? 0u : 1u;
+  }
+
+  Value& at(const std::string& key) {
+    const auto index = lookup(key);
+    if (index == empty_slot) {
+      throw std::out_of_range("key not found");
+    }
+    return _entries[index].second;
+  }
+
+  const Value& at(const std::string& key) const {
+    const auto index = lookup(key);
+    if (index == empty_slot) {
+      throw std::out_of_range("key not found");
+    }
+    return _entries[index].second;
+  }
+
+  /**
+   * @brief Returns pointers to all entries ordered by their key.
+   *
+   * @details Only the pointers are sorted; the entries stay in place.
+   *          Pointers are invalidated by any subsequent insertion.
+   */
+  std::vector<const value_type*> sorted() const {
+    std::vector<const value_type*> out;
+    out.reserve(_entries.size());
+    for (const auto& entry : _entries) {
+      out.push_back(&entry);
+    }
+    std::sort(out.begin(), out.end(),
+              [](const value_type* a, const value_type* b) {
+                return a->first < b->first;
+              });
+    return out;
+  }
+
+  void reserve(const std::size_t size) {
+    _entries.reserve(size);
+    _hashes.reserve(size);
+    if (size * 2 > _slots.size()) {
+      rehash(size * 2);
+    }
+  }
+
+  void clear() {
+    _entries.clear();
+    _hashes.clear();
+    _slots.clear();
+  }
+
+  std::size_t size() const { return _entries.size(); }
+  bool empty() const { return _entries.empty(); }
+
+  iterator begin() { return _entries.begin(); }
+  iterator end() { return _entries.end(); }
+  const_iterator begin() const { return _entries.begin(); }
+  const_iterator end() const { return _entries.end(); }
+
+ private:
+  enum : std::uint32_t { empty_slot = 0xFFFFFFFFu, min_slots = 16u };
+
+  /**
+   * Returns position of the slot that holds the entry with the given key,
+   * or of the first empty slot on its probe sequence. Expects the table
+   * to have been allocated.
+   */
+  std::size_t find_slot(const std::string& key, const std::size_t hash) {
+    if (_slots.empty()) {
+      _slots.assign(min_slots, empty_slot);
+    }
+    const auto mask = _slots.size() - 1;
+    auto slot = hash & mask;
+    while (_slots[slot] != empty_slot) {
+      const auto index = _slots[slot];
+      if (_hashes[index] == hash && _entries[index].first == key) {
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  std::uint32_t lookup(const std::string& key) const {
+    if (_slots.empty()) {
+      return empty_slot;
+    }
+    const auto hash = std::hash<std::string>{}(key);
+    const auto mask = _slots.size() - 1;
+    for (auto slot = hash & mask; _slots[slot] != empty_slot;
+         slot = (slot + 1) & mask) {
+      const auto index = _slots[slot];
+      if (_hashes[index] == hash && _entries[index].first == key) {
+        return index;
+      }
+    }
+    return empty_slot;
+  }
+
+  void rehash(std::size_t capacity) {
+    std::size_t slots = min_slots;
+    while (slots < capacity) {
+      slots *= 2;
+    }
+    _slots.assign(slots, empty_slot);
+    const auto mask = slots - 1;
+    for (std::uint32_t i = 0; i < _entries.size(); ++i) {
+      auto slot = _hashes[i] & mask;
+      while (_slots[slot] != empty_slot) {
+        slot = (slot + 1) & mask;
+      }
+      _slots[slot] = i;
+    }
+  }
+
+  std::vector<value_type> _entries;
+  std::vector<std::size_t> _hashes;
+  std::vector<std::uint32_t> _slots;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -2,7 +2,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -10,26 +14,65 @@
 
 namespace touca {
 
+/**
+ * Headers of a request or a response. Names of headers of responses are
+ * in lowercase.
+ */
+using HttpHeaders = std::map<std::string, std::string>;
+
 struct Response {
-  Response(const int status, const std::string& body)
-      : status(status), body(body) {}
+  Response(const int status, const std::string& body,
+           const HttpHeaders& headers = HttpHeaders())
+      : status(status), body(body), headers(headers) {}
+  std::string header(const std::string& name) const {
+    const auto& it = headers.find(name);
+    return it == headers.end() ? "" : it->second;
+  }
   const int status = -1;
   const std::string body;
+  const HttpHeaders headers;
+};
+
+/**
+ * Configures connections of the transport to the server.
+ */
+struct TransportOptions {
+  unsigned connect_timeout = 10; /**< Seconds to wait for a connection */
+  unsigned read_timeout = 60;    /**< Seconds to wait for a response */
+  unsigned max_inflight = 4;     /**< Maximum number of concurrent requests */
 };
 
+/**
+ * Sends requests to the server. Implementations are expected to be safe
+ * to call from multiple threads at the same time.
+ */
 class TOUCA_CLIENT_API Transport {
  public:
   virtual void set_token(const std::string& token) = 0;
-  virtual Response get(const std::string& route) const = 0;
+  virtual Response get(const std::string& route,
+                       const HttpHeaders& headers = HttpHeaders()) const = 0;
   virtual Response patch(const std::string& route,
                          const std::string& body = "") const = 0;
   virtual Response post(const std::string& route,
                         const std::string& body = "") const = 0;
-  virtual Response binary(const std::string& route,
-                          const std::string& content) const = 0;
+  virtual Response binary(const std::string& route, const std::string& content,
+                          const std::string& idempotency_key = "") const = 0;
   virtual ~Transport() = default;
 };
 
+/**
+ * Configures how failed submissions are retried. Delays grow exponentially
+ * from `base_delay` up to `max_delay`, and a random part of each delay is
+ * dropped so that clients that failed together do not retry in lockstep.
+ * Servers may ask for longer delays, up to `max_retry_after` seconds.
+ */
+struct RetryPolicy {
+  unsigned max_retries = 5;       /**< Retries after the first attempt */
+  unsigned base_delay = 500;      /**< Backoff of the first retry in ms */
+  unsigned max_delay = 30000;     /**< Milliseconds to wait at most per retry */
+  unsigned max_retry_after = 300; /**< Seconds the server may ask to wait */
+};
+
 class TOUCA_CLIENT_API ApiUrl {
  public:
   ApiUrl(const std::string& url);
@@ -56,7 +99,20 @@ class TOUCA_CLIENT_API ApiUrl {
 
 class TOUCA_CLIENT_API Platform {
  public:
-  explicit Platform(const ApiUrl& apiUrl);
+  explicit Platform(const ApiUrl& apiUrl,
+                    const TransportOptions& options = TransportOptions());
+
+  /**
+   * Creates a platform that sends requests through the given transport.
+   */
+  Platform(const ApiUrl& apiUrl, std::unique_ptr<Transport> transport);
+
+  /**
+   * Creates a platform that shares the connections and the authentication
+   * of the given platform, to submit results of another suite or version
+   * without signing in again.
+   */
+  Platform(const ApiUrl& apiUrl, const Platform& session);
 
   bool set_params(const std::string& team, const std::string& suite,
                   const std::string& revision);
@@ -81,12 +137,25 @@ class TOUCA_CLIENT_API Platform {
    * Submits test results in binary format for one or multiple testcases
    * to the server. Expects a valid API Token.
    *
+   * Submissions that fail to reach the server or are rejected with status
+   * 429 or 5xx are retried after a delay, or after the number of seconds
+   * requested by the server through header `Retry-After` if that is
+   * longer. All attempts carry the same `Idempotency-Key` header so that
+   * the server can tell retries apart from new submissions. Submissions
+   * rejected with status 401 are retried once after signing in again, and
+   * are not reported as rejected if signing in does not help.
+   *
    * @param content test results in binary format.
-   * @param max_retries maximum number of retries.
+   * @param policy how many times and how long to wait before retrying.
+   * @param key idempotency key of this submission, generated if empty.
+   * @param rejected if given, set to whether the server rejected the
+   *        submission for a reason that retrying cannot resolve.
    * @return a list of error messages useful for logging or printing
    */
   std::vector<std::string> submit(const std::string& content,
-                                  const unsigned max_retries) const;
+                                  const RetryPolicy& policy = RetryPolicy(),
+                                  const std::string& key = "",
+                                  bool* rejected = nullptr) const;
 
   /**
    * Informs the server that no more testcases will be submitted for
@@ -100,16 +169,21 @@ class TOUCA_CLIENT_API Platform {
    * Queries the server for the list of testcases that are submitted
    * to the baseline version of this suite. Expects a valid API Token.
    *
+   * If a cache file is given, the list is kept in that file along with
+   * the entity tag that the server reported for it, and is downloaded
+   * again only if the server reports that it has changed since.
+   *
+   * @param cache_path path to the cache file of this suite, if any.
    * @return list of test cases of the baseline version of this suite.
    */
-  std::vector<std::string> elements() const;
+  std::vector<std::string> elements(const std::string& cache_path = "") const;
 
   /**
    * Checks if we are already authenticated with the server.
    *
    * @return true if object has a valid authentication token.
    */
-  inline bool has_token() const { return _is_auth; }
+  inline bool has_token() const { return _session->valid; }
 
   /**
    * Provides a description of any error encountered during the
@@ -121,9 +195,29 @@ class TOUCA_CLIENT_API Platform {
   inline std::string get_error() const { return _error; }
 
  private:
+  /**
+   * Authentication shared by platforms that share connections, so that
+   * any of them can sign in again once the server no longer accepts the
+   * token, for example after it expired or the server restarted.
+   */
+  struct Session {
+    std::mutex mutex;
+    std::string api_key;
+    std::atomic<bool> valid{false};
+    std::atomic<std::uint64_t> generation{0u};
+  };
+
+  bool sign_in(const std::string& apiKey, std::string& token) const;
+
+  /**
+   * Signs in again with the API Key of the last successful sign-in, unless
+   * some other request already did so since the given generation.
+   */
+  bool renew_token(const std::uint64_t generation) const;
+
   ApiUrl _api;
-  std::unique_ptr<Transport> _http;
-  bool _is_auth = false;
+  std::shared_ptr<Transport> _http;
+  std::shared_ptr<Session> _session;
   mutable std::string _error;
 };
 
@@ -0,0 +1,128 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file resultlog.hpp
+ *
+ * @brief declares class touca::ResultLog which stores test results of
+ *        all testcases of a run in a single append-only file.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "touca/lib_api.hpp"
+
+namespace touca {
+
+/**
+ * @brief Append-only file holding test results of any number of testcases.
+ *
+ * @details A result log starts with an eight-byte magic string followed by
+ *          a format version. Each record is the serialized flatbuffers
+ *          `Message` of one testcase, prefixed with its size. When the log
+ *          is closed, an index of the testcase names and positions of all
+ *          records is appended, followed by a fixed-size trailer pointing
+ *          to the index. All integers are stored in little-endian order.
+ *
+ *          Reopening an existing log drops its index and appends new
+ *          records after the last one. If the log was not closed properly,
+ *          incomplete records at its end are discarded and the index is
+ *          rebuilt from the remaining records. When a testcase is appended
+ *          more than once, its most recent record takes precedence.
+ */
+class TOUCA_CLIENT_API ResultLog {
+ public:
+  struct Entry {
+    std::string testcase;
+    std::uint64_t offset;
+    std::uint32_t size;
+  };
+
+  using Callback =
+      std::function<void(const Entry&, const std::vector<std::uint8_t>&)>;
+
+  /**
+   * Opens the result log at the given path for appending new records,
+   * creating the file if it does not exist.
+   *
+   * @throw std::runtime_error if the file exists but is not a result log
+   *        or if it cannot be opened for writing.
+   */
+  explicit ResultLog(const std::string& path);
+
+  /** Closes the log if it is not already closed. */
+  ~ResultLog();
+
+  ResultLog(const ResultLog&) = delete;
+  ResultLog& operator=(const ResultLog&) = delete;
+
+  /**
+   * Appends a record to the log. Records are buffered in memory and are
+   * only guaranteed to be on disk once the log is closed.
+   *
+   * @param testcase name of the testcase whose results are being stored
+   * @param message serialized flatbuffers `Message` of the testcase
+   */
+  void append(const std::string& testcase,
+              const std::vector<std::uint8_t>& message);
+
+  /**
+   * Checks whether the log holds a record for the given testcase.
+   */
+  bool contains(const std::string& testcase) const;
+
+  /**
+   * Writes the index, flushes buffered records and synchronizes the
+   * file with the storage device.
+   */
+  void close();
+
+  /**
+   * Checks if the file at the given path starts with the magic string
+   * of a result log.
+   */
+  static bool is_result_log(const std::string& path);
+
+  /**
+   * Reads the index of the result log at the given path, or rebuilds it
+   * by scanning the records if the log was not closed properly.
+   *
+   * @return the most recent entry of each testcase, in order of appearance
+   */
+  static std::vector<Entry> read_index(const std::string& path);
+
+  /**
+   * Invokes the given callback with the most recent record of each
+   * testcase in the result log at the given path.
+   *
+   * @throw std::runtime_error if the file is not a valid result log
+   */
+  static void read(const std::string& path, const Callback& callback);
+
+  /**
+   * Reads the record of the given entry from a stream positioned anywhere
+   * in a result log, without reading any other record.
+   *
+   * @throw std::runtime_error if the record cannot be read or is corrupted
+   */
+  static std::vector<std::uint8_t> read_record(std::istream& input,
+                                               const Entry& entry);
+
+ private:
+  void write(const void* data, const std::size_t size);
+
+  std::string _path;
+  std::FILE* _file = nullptr;
+  std::uint64_t _offset = 0u;
+  std::vector<Entry> _entries;
+  std::unordered_map<std::string, std::size_t> _positions;
+};
+
+}  // namespace touca
@@ -0,0 +1,127 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace touca {
+namespace detail {
+
+/**
+ * @brief Bounded lock-free queue that can be shared by any number of
+ *        producer and consumer threads.
+ *
+ * @details Each slot carries a sequence number that tells producers and
+ *          consumers whether it is ready to be written or read, so that
+ *          threads only contend on a single compare-and-swap of the head
+ *          or tail position. Capacity is rounded up to a power of two.
+ *          Neither operation ever blocks: callers decide what to do when
+ *          the queue is full or empty.
+ */
+template <typename Value>
+class ring_buffer {
+ public:
+  explicit ring_buffer(const std::size_t capacity) {
+    std::size_t size = 2u;
+    while (size < capacity) {
+      size *= 2u;
+    }
+    _mask = size - 1u;
+    _cells.reset(new cell[size]);
+    for (std::size_t i = 0u; i < size; ++i) {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ring_buffer(const ring_buffer&) = delete;
+  ring_buffer& operator=(const ring_buffer&) = delete;
+
+  /**
+   * Moves the given value into the queue if there is room for it.
+   * The value is left untouched if the queue is full.
+   *
+   * @return false if the queue is full
+   */
+  bool try_push(Value& value) {
+    auto pos = _tail.value.load(std::memory_order_relaxed);
+    cell* slot;
+    while (true) {
+      slot = &_cells[pos & _mask];
+      const auto seq = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (_tail.value.compare_exchange_weak(pos, pos + 1u,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _tail.value.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(value);
+    slot->sequence.store(pos + 1u, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Moves the oldest value in the queue into the given output.
+   *
+   * @return false if the queue is empty
+   */
+  bool try_pop(Value& value) {
+    auto pos = _head.value.load(std::memory_order_relaxed);
+    cell* slot;
+    while (true) {
+      slot = &_cells[pos & _mask];
+      const auto seq = slot->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1u);
+      if (diff == 0) {
+        if (_head.value.compare_exchange_weak(pos, pos + 1u,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _head.value.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(slot->value);
+    slot->sequence.store(pos + _mask + 1u, std::memory_order_release);
+    return true;
+  }
+
+  std::size_t capacity() const { return _mask + 1u; }
+
+ private:
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    Value value;
+  };
+
+  /**
+   * Position of producers or consumers, preceded by a cache line worth of
+   * padding so that head and tail never share a cache line. Padding is
+   * used instead of `alignas` since over-aligned types cannot be allocated
+   * with plain `new` before C++17.
+   */
+  struct position {
+    char padding[64];
+    std::atomic<std::size_t> value{0u};
+  };
+
+  std::unique_ptr<cell[]> _cells;
+  std::size_t _mask;
+  position _tail;
+  position _head;
+};
+
+}  // namespace detail
+}  // namespace touca
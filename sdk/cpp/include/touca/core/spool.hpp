@@ -0,0 +1,144 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file spool.hpp
+ *
+ * @brief declares class touca::Spool which keeps submissions of test
+ *        results on disk until the server accepts them, and class
+ *        touca::SpoolSubmitter which replays them in the background.
+ */
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "touca/core/filesystem.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+
+class Platform;
+
+/**
+ * @brief Directory of serialized submissions of test results that are
+ *        not yet accepted by the server.
+ *
+ * @details Each submission is stored in its own file, named after the
+ *          time it was spooled so that files sort in the order they were
+ *          spooled. Files are written under a temporary name and renamed
+ *          once synced to disk, so that an interrupted process or a crash
+ *          never leaves a partial submission behind. Submissions are
+ *          independent of the suite and version they belong to, so
+ *          multiple test runs may share the same spool directory.
+ */
+class TOUCA_CLIENT_API Spool {
+ public:
+  /**
+   * @throw std::runtime_error if the directory cannot be created
+   */
+  explicit Spool(const touca::filesystem::path& dir);
+
+  /**
+   * Stores the given serialized submission in the spool.
+   *
+   * @throw std::runtime_error if the submission cannot be written
+   */
+  void push(const std::string& content);
+
+  /**
+   * @return paths of submissions in the spool, oldest first
+   */
+  std::vector<touca::filesystem::path> pending() const;
+
+  /**
+   * Submits spooled submissions to the server, oldest first, removing
+   * each submission that the server accepts. Submissions that cannot be
+   * read or that the server rejects for reasons other than load are moved
+   * to subdirectory `failed` and reported. Stops at the first failure
+   * that may be resolved by retrying, so that no submission is accepted
+   * before an older one that may still be accepted.
+   *
+   * @param platform authenticated connection to the server
+   * @param errors receives reasons submissions were left in the spool,
+   *               which a later replay may resolve
+   * @param rejections receives reasons submissions were moved to
+   *                   `failed`, which replaying cannot resolve
+   * @return number of submissions accepted by the server
+   */
+  std::size_t replay(const Platform& platform, std::vector<std::string>& errors,
+                     std::vector<std::string>& rejections) const;
+
+  const touca::filesystem::path& dir() const { return _dir; }
+
+  /**
+   * @return directory that submissions are moved to once they are rejected
+   */
+  touca::filesystem::path failed_dir() const { return _dir / "failed"; }
+
+ private:
+  void reject(const touca::filesystem::path& path,
+              std::vector<std::string>& errors,
+              std::vector<std::string>& rejections) const;
+
+  touca::filesystem::path _dir;
+  std::string _prefix;
+  unsigned long _counter = 0u;
+  mutable std::mutex _mutex;
+};
+
+/**
+ * @brief Replays the content of a spool in a background thread, so that
+ *        submitting test results never blocks the caller on the network.
+ *
+ * @details The spool is replayed once when the submitter is created and
+ *          then each time `notify` or `flush` is called. A replay that
+ *          fails leaves the remaining submissions in the spool until the
+ *          next replay.
+ */
+class TOUCA_CLIENT_API SpoolSubmitter {
+ public:
+  SpoolSubmitter(const Platform& platform, const Spool& spool);
+
+  /**
+   * Waits for the ongoing replay, if any, to finish, without starting
+   * a new one. Submissions that are left are kept in the spool.
+   */
+  ~SpoolSubmitter();
+
+  /**
+   * Lets the submitter know that new submissions were spooled.
+   */
+  void notify();
+
+  /**
+   * Replays the spool and waits for the replay to finish.
+   *
+   * @param rejections receives reasons submissions were moved to `failed`
+   *                   since the last call, if given
+   * @return reasons submissions are left in the spool, empty if the spool
+   *         was drained
+   */
+  std::vector<std::string> flush(std::vector<std::string>* rejections =
+                                     nullptr);
+
+ private:
+  void run();
+
+  const Platform& _platform;
+  const Spool& _spool;
+  unsigned long _requested = 1u;
+  unsigned long _completed = 0u;
+  std::vector<std::string> _errors;
+  std::vector<std::string> _rejections;
+  bool _stopping = false;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::condition_variable _cv_completed;
+  std::thread _thread;
+};
+
+}  // namespace touca
@@ -2,11 +2,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "rapidjson/fwd.h"
+#include "touca/core/flat_map.hpp"
 #include "touca/core/types.hpp"
 #include "touca/lib_api.hpp"
 
@@ -25,8 +29,82 @@ struct ResultEntry {
   ResultCategory typ;
 };
 
+/**
+ * Start and stop times of a performance benchmark, kept in a single
+ * record so that reporting a metric takes one lookup.
+ */
+struct TimerEntry {
+  std::chrono::system_clock::time_point tic;
+  std::chrono::system_clock::time_point toc;
+  bool stopped;
+
+  std::int64_t duration() const;
+};
+
+/**
+ * Summary statistics of repeated measurements of a performance metric,
+ * in milliseconds. Serialized in place of the metric as an object with
+ * members `count`, `min`, `median`, `mean`, `p90` and `stddev`.
+ */
+struct TOUCA_CLIENT_API MetricSummary {
+  std::uint32_t count = 0u;
+  double min = 0.0;
+  double median = 0.0;
+  double mean = 0.0;
+  double p90 = 0.0;
+  double stddev = 0.0;
+
+  /**
+   * Summarizes a given set of measurements. Percentiles are linearly
+   * interpolated and the standard deviation is that of a sample.
+   */
+  static MetricSummary from_samples(std::vector<double> samples);
+
+  /**
+   * Reads a summary previously converted to a data point.
+   *
+   * @return false if the value does not describe a summary
+   */
+  static bool from_data_point(const data_point& value, MetricSummary& out);
+
+  data_point to_data_point() const;
+};
+
+/**
+ * Calls of a code path recorded by the hierarchical profiler. Times are
+ * in microseconds. Self time excludes the time spent in nested scopes.
+ */
+struct ProfileEntry {
+  std::uint64_t calls = 0u;
+  std::uint64_t total = 0u;
+  std::uint64_t self = 0u;
+};
+
+/**
+ * Entries of the hierarchical profiler keyed by their call path, that is
+ * the names of nested scopes joined by semicolons, outermost first.
+ */
+using ProfileMap = std::map<std::string, ProfileEntry>;
+
+/**
+ * Converts entries of the hierarchical profiler to a tree of objects,
+ * with a member for each scope that holds its `calls`, `total` and `self`
+ * time and its nested scopes as `children`.
+ */
+TOUCA_CLIENT_API data_point profile_to_data_point(const ProfileMap& profile);
+
+/**
+ * Reads entries of the hierarchical profiler previously converted to a
+ * data point.
+ *
+ * @return false if the value does not describe a profile
+ */
+TOUCA_CLIENT_API bool profile_from_data_point(const data_point& value,
+                                              ProfileMap& out);
+
 using MetricsMap = std::map<std::string, MetricsMapValue>;
-using ResultsMap = std::map<std::string, ResultEntry>;
+using ResultsMap = detail::flat_map<ResultEntry>;
+using TimersMap = detail::flat_map<TimerEntry>;
 
 class TOUCA_CLIENT_API Testcase {
   friend class ClientImpl;
@@ -55,7 +133,12 @@ class TOUCA_CLIENT_API Testcase {
 
   Testcase(const Metadata& meta, const ResultsMap& results,
            const std::unordered_map<std::string, detail::number_unsigned_t>&
-               metrics);
+               metrics,
+           const std::unordered_map<std::string, MetricSummary>& summaries =
+               {},
+           const ProfileMap& profile = {},
+           const std::unordered_map<std::string, detail::number_unsigned_t>&
+               counters = {});
 
   Testcase(const std::string& teamslug, const std::string& testsuite,
            const std::string& version, const std::string& name);
@@ -74,12 +157,90 @@ class TOUCA_CLIENT_API Testcase {
 
   void add_metric(const std::string& key, const unsigned duration);
 
+  /**
+   * Reports summary statistics of repeated measurements of a metric,
+   * taking precedence over any single measurement with the same key.
+   */
+  void add_metric_summary(const std::string& key,
+                          const MetricSummary& summary);
+
+  /**
+   * Adds the given number of events to the counter metric with the given
+   * key. Unlike timers, counters accumulate across repeated calls and do
+   * not contribute to the total duration of the testcase.
+   */
+  void add_counter(const std::string& key,
+                   const detail::number_unsigned_t count);
+
+  /**
+   * Accounts for one call of a code path in the hierarchical profile of
+   * this testcase, which is reported as metric `__profile__`.
+   *
+   * @param path names of nested scopes joined by semicolons
+   * @param total microseconds spent in the scope
+   * @param self microseconds spent in the scope outside nested scopes
+   */
+  void add_profile_sample(const std::string& path, const std::uint64_t total,
+                          const std::uint64_t self);
+
+  /**
+   * Adds results and metrics of another testcase, such as those captured
+   * by a different client on threads that a workflow spawns. Keys that
+   * both testcases hold are kept as captured by this testcase, except for
+   * counters and profile samples which are accumulated.
+   */
+  void merge(const Testcase& other);
+
   /**
    * Removes all assumptions, checks and metrics that have been
-   * associated with this testcase.
+   * associated with this testcase, including those spilled to disk.
    */
   void clear();
 
+  /**
+   * Limits the estimated memory held by captured results of this testcase.
+   * Once the limit is exceeded, strings, arrays and objects captured so far
+   * are appended to a spill file on disk and released from memory. They
+   * are stitched back with the in-memory results upon serialization.
+   *
+   * The budget only bounds memory held while results are captured.
+   * Serializing a testcase to save or submit its results still builds
+   * the serialized form of all its results in memory.
+   *
+   * The spill file is emptied when this testcase first spills and removed
+   * once no copy of this testcase refers to it. Copies share the spill
+   * file until one of them spills or is cleared, after which that copy
+   * keeps its results in a file of its own.
+   *
+   * @param budget maximum number of bytes, or zero to disable spilling
+   * @param spill_path path to the file that should hold spilled results
+   */
+  void set_memory_budget(const std::size_t budget,
+                         const std::string& spill_path);
+
+  /**
+   * Estimated number of bytes of memory held by captured results of this
+   * testcase that have not been spilled to disk.
+   */
+  std::size_t memory_usage() const;
+
+  /**
+   * Counts memory held by captured results of this testcase towards a
+   * total shared with other testcases, which is kept up to date as results
+   * are added, spilled to disk or cleared. Copies of this testcase do not
+   * count towards the total.
+   */
+  void set_memory_total(
+      const std::shared_ptr<std::atomic<std::size_t>>& total);
+
+  /**
+   * Moves strings, arrays and objects captured so far to the spill file.
+   * Has no effect if no spill file is set.
+   *
+   * @return number of bytes of memory estimated to have been released
+   */
+  std::size_t spill();
+
   MetricsMap metrics() const;
 
   rapidjson::Value json(RJAllocator& allocator) const;
@@ -101,13 +262,75 @@ class TOUCA_CLIENT_API Testcase {
    */
   static std::vector<uint8_t> serialize(const std::vector<Testcase>& testcases);
 
+  static std::vector<uint8_t> serialize(
+      const std::vector<std::shared_ptr<Testcase>>& testcases);
+
  private:
+  struct SpilledEntry {
+    ResultCategory typ;
+    detail::internal_type type;
+  };
+
+  /**
+   * Bytes of a testcase counted towards a total shared with other
+   * testcases. Subtracted from the total when the testcase is destroyed.
+   */
+  class MemoryShare {
+   public:
+    MemoryShare() = default;
+    MemoryShare(const MemoryShare&) {}
+    MemoryShare& operator=(const MemoryShare&) { return *this; }
+    ~MemoryShare() { update(0u); }
+    void attach(const std::shared_ptr<std::atomic<std::size_t>>& total,
+                const std::size_t bytes);
+    void update(const std::size_t bytes);
+
+   private:
+    std::shared_ptr<std::atomic<std::size_t>> _total;
+    std::size_t _bytes = 0u;
+  };
+
+  /**
+   * File that holds results of a testcase spilled to disk. Truncated when
+   * created, so that nothing is left of files of previous runs that did
+   * not remove them, and removed when destroyed.
+   */
+  class SpillFile {
+   public:
+    explicit SpillFile(const std::string& path);
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+    ~SpillFile();
+    const std::string path;
+  };
+
+  bool is_spilled(const std::string& key) const;
+
+  void own_spill_file();
+
+  void add_result(const std::string& key, const ResultEntry& entry);
+
+  void enforce_memory_budget();
+
+  void set_memory_usage(const std::size_t usage);
+
+  ResultsMap stitched_results() const;
+
   bool _posted;
   Metadata _metadata;
   ResultsMap _resultsMap;
-
-  std::unordered_map<std::string, std::chrono::system_clock::time_point> _tics;
-  std::unordered_map<std::string, std::chrono::system_clock::time_point> _tocs;
+  TimersMap _timersMap;
+  detail::flat_map<MetricSummary> _summariesMap;
+  ProfileMap _profile;
+  detail::flat_map<detail::number_unsigned_t> _countersMap;
+
+  std::size_t _memoryUsage = 0u;
+  std::size_t _memoryBudget = 0u;
+  std::size_t _memoryResidual = 0u;
+  std::string _spillPath;
+  std::shared_ptr<SpillFile> _spillFile;
+  detail::flat_map<SpilledEntry> _spilledKeys;
+  MemoryShare _memoryShare;
 };
 
 using ElementsMap = std::unordered_map<std::string, std::shared_ptr<Testcase>>;
@@ -225,6 +225,12 @@ class TOUCA_CLIENT_API data_point {
 
   std::string to_string() const;
 
+  /**
+   * @brief Estimates number of bytes of memory held by this value,
+   *        including memory allocated for its nested values.
+   */
+  std::size_t memory_usage() const noexcept;
+
   detail::number_signed_t as_metric() const noexcept {
     return detail::get<detail::number_signed_t>(_value);
   }
@@ -0,0 +1,71 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+/**
+ * @file allocations.hpp
+ *
+ * @brief Replaces global operators `new` and `delete` so that the test
+ *        framework can count memory allocations of each testcase.
+ *
+ * @details Include this file in exactly one source file of your test tool
+ *          and pass option `--memory-metrics` to report the number of
+ *          allocations and the number of bytes allocated by the workflow
+ *          of each testcase, as metrics `__allocations__` and
+ *          `__allocated_bytes__`. Allocations are counted across all
+ *          threads of the process.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/**
+ * Lets the test framework know that allocations can be counted.
+ */
+TOUCA_CLIENT_API bool install_allocation_hook();
+
+/**
+ * Accounts for an allocation of the given number of bytes, if the test
+ * framework is currently counting allocations.
+ */
+TOUCA_CLIENT_API void count_allocation(const std::size_t size) noexcept;
+
+}  // namespace detail
+}  // namespace touca
+
+namespace {
+const bool touca_allocation_hook = touca::detail::install_allocation_hook();
+}  // namespace
+
+void* operator new(std::size_t size) {
+  touca::detail::count_allocation(size);
+  if (size == 0u) {
+    size = 1u;
+  }
+  while (true) {
+    if (void* ptr = std::malloc(size)) {
+      return ptr;
+    }
+    const auto handler = std::get_new_handler();
+    if (!handler) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
@@ -28,6 +28,11 @@ namespace touca {
 /**
  * @brief a simple class that helps clients log the duration between
  *        its instantiation and destruction as a performance metric.
+ *
+ * @details When option `profile` is set, scoped timers that are alive at
+ *          the same time on the same thread are nested: their durations
+ *          are captured as a call tree that tells the time spent in each
+ *          scope apart from the time spent in the scopes nested in it.
  */
 class TOUCA_CLIENT_API scoped_timer {
  public:
@@ -0,0 +1,752 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+// Code for schema `config/flatbuffers/comparison.fbs`, written in the form
+// of the code in `schema.hpp` because flatc was not available to generate
+// it. Regenerate it with `./build.sh --schema` using flatc v2.0.0 instead
+// of modifying it.
+
+#pragma once
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace touca {
+namespace fbs {
+
+struct ComparisonMetadata;
+struct ComparisonMetadataBuilder;
+
+struct ComparisonKey;
+struct ComparisonKeyBuilder;
+
+struct ComparisonSoloKey;
+struct ComparisonSoloKeyBuilder;
+
+struct ComparisonCellar;
+struct ComparisonCellarBuilder;
+
+struct ComparisonOverview;
+struct ComparisonOverviewBuilder;
+
+struct CaseComparison;
+struct CaseComparisonBuilder;
+
+enum class MatchType : uint8_t {
+  Perfect = 0,
+  None = 1,
+  MIN = Perfect,
+  MAX = None
+};
+
+enum class ValueType : uint8_t {
+  Unknown = 0,
+  Bool = 1,
+  Number = 2,
+  String = 3,
+  Array = 4,
+  Object = 5,
+  MIN = Unknown,
+  MAX = Object
+};
+
+enum class ComparisonCategory : uint8_t {
+  Common = 0,
+  New = 1,
+  Missing = 2,
+  MIN = Common,
+  MAX = Missing
+};
+
+struct ComparisonMetadata FLATBUFFERS_FINAL_CLASS
+    : private flatbuffers::Table {
+  typedef ComparisonMetadataBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_TEAMSLUG = 4,
+    VT_TESTSUITE = 6,
+    VT_VERSION = 8,
+    VT_TESTCASE = 10,
+    VT_BUILTAT = 12
+  };
+  const flatbuffers::String* teamslug() const {
+    return GetPointer<const flatbuffers::String*>(VT_TEAMSLUG);
+  }
+  const flatbuffers::String* testsuite() const {
+    return GetPointer<const flatbuffers::String*>(VT_TESTSUITE);
+  }
+  const flatbuffers::String* version() const {
+    return GetPointer<const flatbuffers::String*>(VT_VERSION);
+  }
+  const flatbuffers::String* testcase() const {
+    return GetPointer<const flatbuffers::String*>(VT_TESTCASE);
+  }
+  const flatbuffers::String* builtAt() const {
+    return GetPointer<const flatbuffers::String*>(VT_BUILTAT);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_TEAMSLUG) &&
+           verifier.VerifyString(teamslug()) &&
+           VerifyOffset(verifier, VT_TESTSUITE) &&
+           verifier.VerifyString(testsuite()) &&
+           VerifyOffset(verifier, VT_VERSION) &&
+           verifier.VerifyString(version()) &&
+           VerifyOffset(verifier, VT_TESTCASE) &&
+           verifier.VerifyString(testcase()) &&
+           VerifyOffset(verifier, VT_BUILTAT) &&
+           verifier.VerifyString(builtAt()) && verifier.EndTable();
+  }
+};
+
+struct ComparisonMetadataBuilder {
+  typedef ComparisonMetadata Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_teamslug(flatbuffers::Offset<flatbuffers::String> teamslug) {
+    fbb_.AddOffset(ComparisonMetadata::VT_TEAMSLUG, teamslug);
+  }
+  void add_testsuite(flatbuffers::Offset<flatbuffers::String> testsuite) {
+    fbb_.AddOffset(ComparisonMetadata::VT_TESTSUITE, testsuite);
+  }
+  void add_version(flatbuffers::Offset<flatbuffers::String> version) {
+    fbb_.AddOffset(ComparisonMetadata::VT_VERSION, version);
+  }
+  void add_testcase(flatbuffers::Offset<flatbuffers::String> testcase) {
+    fbb_.AddOffset(ComparisonMetadata::VT_TESTCASE, testcase);
+  }
+  void add_builtAt(flatbuffers::Offset<flatbuffers::String> builtAt) {
+    fbb_.AddOffset(ComparisonMetadata::VT_BUILTAT, builtAt);
+  }
+  explicit ComparisonMetadataBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<ComparisonMetadata> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ComparisonMetadata>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ComparisonMetadata> CreateComparisonMetadata(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<flatbuffers::String> teamslug = 0,
+    flatbuffers::Offset<flatbuffers::String> testsuite = 0,
+    flatbuffers::Offset<flatbuffers::String> version = 0,
+    flatbuffers::Offset<flatbuffers::String> testcase = 0,
+    flatbuffers::Offset<flatbuffers::String> builtAt = 0) {
+  ComparisonMetadataBuilder builder_(_fbb);
+  builder_.add_builtAt(builtAt);
+  builder_.add_testcase(testcase);
+  builder_.add_version(version);
+  builder_.add_testsuite(testsuite);
+  builder_.add_teamslug(teamslug);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ComparisonMetadata> CreateComparisonMetadataDirect(
+    flatbuffers::FlatBufferBuilder& _fbb, const char* teamslug = nullptr,
+    const char* testsuite = nullptr, const char* version = nullptr,
+    const char* testcase = nullptr, const char* builtAt = nullptr) {
+  auto teamslug__ = teamslug ? _fbb.CreateString(teamslug) : 0;
+  auto testsuite__ = testsuite ? _fbb.CreateString(testsuite) : 0;
+  auto version__ = version ? _fbb.CreateString(version) : 0;
+  auto testcase__ = testcase ? _fbb.CreateString(testcase) : 0;
+  auto builtAt__ = builtAt ? _fbb.CreateString(builtAt) : 0;
+  return touca::fbs::CreateComparisonMetadata(
+      _fbb, teamslug__, testsuite__, version__, testcase__, builtAt__);
+}
+
+struct ComparisonKey FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ComparisonKeyBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_NAME = 4,
+    VT_MATCH = 6,
+    VT_SCORE = 8,
+    VT_SRCTYPE = 10,
+    VT_DSTTYPE = 12,
+    VT_SRCVALUE = 14,
+    VT_DSTVALUE = 16,
+    VT_DESC = 18
+  };
+  const flatbuffers::String* name() const {
+    return GetPointer<const flatbuffers::String*>(VT_NAME);
+  }
+  touca::fbs::MatchType match() const {
+    return static_cast<touca::fbs::MatchType>(GetField<uint8_t>(VT_MATCH, 0));
+  }
+  double score() const { return GetField<double>(VT_SCORE, 0.0); }
+  touca::fbs::ValueType srcType() const {
+    return static_cast<touca::fbs::ValueType>(
+        GetField<uint8_t>(VT_SRCTYPE, 0));
+  }
+  touca::fbs::ValueType dstType() const {
+    return static_cast<touca::fbs::ValueType>(
+        GetField<uint8_t>(VT_DSTTYPE, 0));
+  }
+  const flatbuffers::String* srcValue() const {
+    return GetPointer<const flatbuffers::String*>(VT_SRCVALUE);
+  }
+  const flatbuffers::String* dstValue() const {
+    return GetPointer<const flatbuffers::String*>(VT_DSTVALUE);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>* desc()
+      const {
+    return GetPointer<
+        const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*>(
+        VT_DESC);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_NAME) &&
+           verifier.VerifyString(name()) &&
+           VerifyField<uint8_t>(verifier, VT_MATCH) &&
+           VerifyField<double>(verifier, VT_SCORE) &&
+           VerifyField<uint8_t>(verifier, VT_SRCTYPE) &&
+           VerifyField<uint8_t>(verifier, VT_DSTTYPE) &&
+           VerifyOffset(verifier, VT_SRCVALUE) &&
+           verifier.VerifyString(srcValue()) &&
+           VerifyOffset(verifier, VT_DSTVALUE) &&
+           verifier.VerifyString(dstValue()) &&
+           VerifyOffset(verifier, VT_DESC) && verifier.VerifyVector(desc()) &&
+           verifier.VerifyVectorOfStrings(desc()) && verifier.EndTable();
+  }
+};
+
+struct ComparisonKeyBuilder {
+  typedef ComparisonKey Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) {
+    fbb_.AddOffset(ComparisonKey::VT_NAME, name);
+  }
+  void add_match(touca::fbs::MatchType match) {
+    fbb_.AddElement<uint8_t>(ComparisonKey::VT_MATCH,
+                             static_cast<uint8_t>(match), 0);
+  }
+  void add_score(double score) {
+    fbb_.AddElement<double>(ComparisonKey::VT_SCORE, score, 0.0);
+  }
+  void add_srcType(touca::fbs::ValueType srcType) {
+    fbb_.AddElement<uint8_t>(ComparisonKey::VT_SRCTYPE,
+                             static_cast<uint8_t>(srcType), 0);
+  }
+  void add_dstType(touca::fbs::ValueType dstType) {
+    fbb_.AddElement<uint8_t>(ComparisonKey::VT_DSTTYPE,
+                             static_cast<uint8_t>(dstType), 0);
+  }
+  void add_srcValue(flatbuffers::Offset<flatbuffers::String> srcValue) {
+    fbb_.AddOffset(ComparisonKey::VT_SRCVALUE, srcValue);
+  }
+  void add_dstValue(flatbuffers::Offset<flatbuffers::String> dstValue) {
+    fbb_.AddOffset(ComparisonKey::VT_DSTVALUE, dstValue);
+  }
+  void add_desc(
+      flatbuffers::Offset<
+          flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+          desc) {
+    fbb_.AddOffset(ComparisonKey::VT_DESC, desc);
+  }
+  explicit ComparisonKeyBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<ComparisonKey> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ComparisonKey>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ComparisonKey> CreateComparisonKey(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<flatbuffers::String> name = 0,
+    touca::fbs::MatchType match = touca::fbs::MatchType::Perfect,
+    double score = 0.0,
+    touca::fbs::ValueType srcType = touca::fbs::ValueType::Unknown,
+    touca::fbs::ValueType dstType = touca::fbs::ValueType::Unknown,
+    flatbuffers::Offset<flatbuffers::String> srcValue = 0,
+    flatbuffers::Offset<flatbuffers::String> dstValue = 0,
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+        desc = 0) {
+  ComparisonKeyBuilder builder_(_fbb);
+  builder_.add_score(score);
+  builder_.add_desc(desc);
+  builder_.add_dstValue(dstValue);
+  builder_.add_srcValue(srcValue);
+  builder_.add_name(name);
+  builder_.add_dstType(dstType);
+  builder_.add_srcType(srcType);
+  builder_.add_match(match);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ComparisonKey> CreateComparisonKeyDirect(
+    flatbuffers::FlatBufferBuilder& _fbb, const char* name = nullptr,
+    touca::fbs::MatchType match = touca::fbs::MatchType::Perfect,
+    double score = 0.0,
+    touca::fbs::ValueType srcType = touca::fbs::ValueType::Unknown,
+    touca::fbs::ValueType dstType = touca::fbs::ValueType::Unknown,
+    const char* srcValue = nullptr, const char* dstValue = nullptr,
+    const std::vector<flatbuffers::Offset<flatbuffers::String>>* desc =
+        nullptr) {
+  auto name__ = name ? _fbb.CreateString(name) : 0;
+  auto srcValue__ = srcValue ? _fbb.CreateString(srcValue) : 0;
+  auto dstValue__ = dstValue ? _fbb.CreateString(dstValue) : 0;
+  auto desc__ =
+      desc ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(*desc)
+           : 0;
+  return touca::fbs::CreateComparisonKey(_fbb, name__, match, score, srcType,
+                                         dstType, srcValue__, dstValue__,
+                                         desc__);
+}
+
+struct ComparisonSoloKey FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ComparisonSoloKeyBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_NAME = 4,
+    VT_TYP = 6,
+    VT_VALUE = 8
+  };
+  const flatbuffers::String* name() const {
+    return GetPointer<const flatbuffers::String*>(VT_NAME);
+  }
+  touca::fbs::ValueType typ() const {
+    return static_cast<touca::fbs::ValueType>(GetField<uint8_t>(VT_TYP, 0));
+  }
+  const flatbuffers::String* value() const {
+    return GetPointer<const flatbuffers::String*>(VT_VALUE);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_NAME) &&
+           verifier.VerifyString(name()) &&
+           VerifyField<uint8_t>(verifier, VT_TYP) &&
+           VerifyOffset(verifier, VT_VALUE) &&
+           verifier.VerifyString(value()) && verifier.EndTable();
+  }
+};
+
+struct ComparisonSoloKeyBuilder {
+  typedef ComparisonSoloKey Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) {
+    fbb_.AddOffset(ComparisonSoloKey::VT_NAME, name);
+  }
+  void add_typ(touca::fbs::ValueType typ) {
+    fbb_.AddElement<uint8_t>(ComparisonSoloKey::VT_TYP,
+                             static_cast<uint8_t>(typ), 0);
+  }
+  void add_value(flatbuffers::Offset<flatbuffers::String> value) {
+    fbb_.AddOffset(ComparisonSoloKey::VT_VALUE, value);
+  }
+  explicit ComparisonSoloKeyBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<ComparisonSoloKey> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ComparisonSoloKey>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ComparisonSoloKey> CreateComparisonSoloKey(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<flatbuffers::String> name = 0,
+    touca::fbs::ValueType typ = touca::fbs::ValueType::Unknown,
+    flatbuffers::Offset<flatbuffers::String> value = 0) {
+  ComparisonSoloKeyBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_name(name);
+  builder_.add_typ(typ);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ComparisonSoloKey> CreateComparisonSoloKeyDirect(
+    flatbuffers::FlatBufferBuilder& _fbb, const char* name = nullptr,
+    touca::fbs::ValueType typ = touca::fbs::ValueType::Unknown,
+    const char* value = nullptr) {
+  auto name__ = name ? _fbb.CreateString(name) : 0;
+  auto value__ = value ? _fbb.CreateString(value) : 0;
+  return touca::fbs::CreateComparisonSoloKey(_fbb, name__, typ, value__);
+}
+
+struct ComparisonCellar FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ComparisonCellarBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_COMMONKEYS = 4,
+    VT_MISSINGKEYS = 6,
+    VT_NEWKEYS = 8
+  };
+  const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::ComparisonKey>>*
+  commonKeys() const {
+    return GetPointer<const flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::ComparisonKey>>*>(VT_COMMONKEYS);
+  }
+  const flatbuffers::Vector<
+      flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*
+  missingKeys() const {
+    return GetPointer<const flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*>(VT_MISSINGKEYS);
+  }
+  const flatbuffers::Vector<
+      flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*
+  newKeys() const {
+    return GetPointer<const flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*>(VT_NEWKEYS);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_COMMONKEYS) &&
+           verifier.VerifyVector(commonKeys()) &&
+           verifier.VerifyVectorOfTables(commonKeys()) &&
+           VerifyOffset(verifier, VT_MISSINGKEYS) &&
+           verifier.VerifyVector(missingKeys()) &&
+           verifier.VerifyVectorOfTables(missingKeys()) &&
+           VerifyOffset(verifier, VT_NEWKEYS) &&
+           verifier.VerifyVector(newKeys()) &&
+           verifier.VerifyVectorOfTables(newKeys()) && verifier.EndTable();
+  }
+};
+
+struct ComparisonCellarBuilder {
+  typedef ComparisonCellar Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_commonKeys(
+      flatbuffers::Offset<
+          flatbuffers::Vector<flatbuffers::Offset<touca::fbs::ComparisonKey>>>
+          commonKeys) {
+    fbb_.AddOffset(ComparisonCellar::VT_COMMONKEYS, commonKeys);
+  }
+  void add_missingKeys(
+      flatbuffers::Offset<flatbuffers::Vector<
+          flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>>
+          missingKeys) {
+    fbb_.AddOffset(ComparisonCellar::VT_MISSINGKEYS, missingKeys);
+  }
+  void add_newKeys(flatbuffers::Offset<flatbuffers::Vector<
+                       flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>>
+                       newKeys) {
+    fbb_.AddOffset(ComparisonCellar::VT_NEWKEYS, newKeys);
+  }
+  explicit ComparisonCellarBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<ComparisonCellar> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ComparisonCellar>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ComparisonCellar> CreateComparisonCellar(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<touca::fbs::ComparisonKey>>>
+        commonKeys = 0,
+    flatbuffers::Offset<flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>>
+        missingKeys = 0,
+    flatbuffers::Offset<flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>>
+        newKeys = 0) {
+  ComparisonCellarBuilder builder_(_fbb);
+  builder_.add_newKeys(newKeys);
+  builder_.add_missingKeys(missingKeys);
+  builder_.add_commonKeys(commonKeys);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ComparisonCellar> CreateComparisonCellarDirect(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    const std::vector<flatbuffers::Offset<touca::fbs::ComparisonKey>>*
+        commonKeys = nullptr,
+    const std::vector<flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*
+        missingKeys = nullptr,
+    const std::vector<flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>*
+        newKeys = nullptr) {
+  auto commonKeys__ =
+      commonKeys
+          ? _fbb.CreateVector<flatbuffers::Offset<touca::fbs::ComparisonKey>>(
+                *commonKeys)
+          : 0;
+  auto missingKeys__ =
+      missingKeys ? _fbb.CreateVector<
+                        flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>(
+                        *missingKeys)
+                  : 0;
+  auto newKeys__ =
+      newKeys ? _fbb.CreateVector<
+                    flatbuffers::Offset<touca::fbs::ComparisonSoloKey>>(
+                    *newKeys)
+              : 0;
+  return touca::fbs::CreateComparisonCellar(_fbb, commonKeys__, missingKeys__,
+                                            newKeys__);
+}
+
+struct ComparisonOverview FLATBUFFERS_FINAL_CLASS
+    : private flatbuffers::Table {
+  typedef ComparisonOverviewBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_KEYSSCORE = 4,
+    VT_KEYSCOUNTCOMMON = 6,
+    VT_KEYSCOUNTFRESH = 8,
+    VT_KEYSCOUNTMISSING = 10,
+    VT_METRICSCOUNTCOMMON = 12,
+    VT_METRICSCOUNTFRESH = 14,
+    VT_METRICSCOUNTMISSING = 16,
+    VT_METRICSDURATIONCOMMONDST = 18,
+    VT_METRICSDURATIONCOMMONSRC = 20
+  };
+  double keysScore() const { return GetField<double>(VT_KEYSSCORE, 0.0); }
+  int32_t keysCountCommon() const {
+    return GetField<int32_t>(VT_KEYSCOUNTCOMMON, 0);
+  }
+  int32_t keysCountFresh() const {
+    return GetField<int32_t>(VT_KEYSCOUNTFRESH, 0);
+  }
+  int32_t keysCountMissing() const {
+    return GetField<int32_t>(VT_KEYSCOUNTMISSING, 0);
+  }
+  int32_t metricsCountCommon() const {
+    return GetField<int32_t>(VT_METRICSCOUNTCOMMON, 0);
+  }
+  int32_t metricsCountFresh() const {
+    return GetField<int32_t>(VT_METRICSCOUNTFRESH, 0);
+  }
+  int32_t metricsCountMissing() const {
+    return GetField<int32_t>(VT_METRICSCOUNTMISSING, 0);
+  }
+  int32_t metricsDurationCommonDst() const {
+    return GetField<int32_t>(VT_METRICSDURATIONCOMMONDST, 0);
+  }
+  int32_t metricsDurationCommonSrc() const {
+    return GetField<int32_t>(VT_METRICSDURATIONCOMMONSRC, 0);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<double>(verifier, VT_KEYSSCORE) &&
+           VerifyField<int32_t>(verifier, VT_KEYSCOUNTCOMMON) &&
+           VerifyField<int32_t>(verifier, VT_KEYSCOUNTFRESH) &&
+           VerifyField<int32_t>(verifier, VT_KEYSCOUNTMISSING) &&
+           VerifyField<int32_t>(verifier, VT_METRICSCOUNTCOMMON) &&
+           VerifyField<int32_t>(verifier, VT_METRICSCOUNTFRESH) &&
+           VerifyField<int32_t>(verifier, VT_METRICSCOUNTMISSING) &&
+           VerifyField<int32_t>(verifier, VT_METRICSDURATIONCOMMONDST) &&
+           VerifyField<int32_t>(verifier, VT_METRICSDURATIONCOMMONSRC) &&
+           verifier.EndTable();
+  }
+};
+
+struct ComparisonOverviewBuilder {
+  typedef ComparisonOverview Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_keysScore(double keysScore) {
+    fbb_.AddElement<double>(ComparisonOverview::VT_KEYSSCORE, keysScore, 0.0);
+  }
+  void add_keysCountCommon(int32_t keysCountCommon) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_KEYSCOUNTCOMMON,
+                             keysCountCommon, 0);
+  }
+  void add_keysCountFresh(int32_t keysCountFresh) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_KEYSCOUNTFRESH,
+                             keysCountFresh, 0);
+  }
+  void add_keysCountMissing(int32_t keysCountMissing) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_KEYSCOUNTMISSING,
+                             keysCountMissing, 0);
+  }
+  void add_metricsCountCommon(int32_t metricsCountCommon) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_METRICSCOUNTCOMMON,
+                             metricsCountCommon, 0);
+  }
+  void add_metricsCountFresh(int32_t metricsCountFresh) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_METRICSCOUNTFRESH,
+                             metricsCountFresh, 0);
+  }
+  void add_metricsCountMissing(int32_t metricsCountMissing) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_METRICSCOUNTMISSING,
+                             metricsCountMissing, 0);
+  }
+  void add_metricsDurationCommonDst(int32_t metricsDurationCommonDst) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_METRICSDURATIONCOMMONDST,
+                             metricsDurationCommonDst, 0);
+  }
+  void add_metricsDurationCommonSrc(int32_t metricsDurationCommonSrc) {
+    fbb_.AddElement<int32_t>(ComparisonOverview::VT_METRICSDURATIONCOMMONSRC,
+                             metricsDurationCommonSrc, 0);
+  }
+  explicit ComparisonOverviewBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<ComparisonOverview> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ComparisonOverview>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ComparisonOverview> CreateComparisonOverview(
+    flatbuffers::FlatBufferBuilder& _fbb, double keysScore = 0.0,
+    int32_t keysCountCommon = 0, int32_t keysCountFresh = 0,
+    int32_t keysCountMissing = 0, int32_t metricsCountCommon = 0,
+    int32_t metricsCountFresh = 0, int32_t metricsCountMissing = 0,
+    int32_t metricsDurationCommonDst = 0,
+    int32_t metricsDurationCommonSrc = 0) {
+  ComparisonOverviewBuilder builder_(_fbb);
+  builder_.add_keysScore(keysScore);
+  builder_.add_metricsDurationCommonSrc(metricsDurationCommonSrc);
+  builder_.add_metricsDurationCommonDst(metricsDurationCommonDst);
+  builder_.add_metricsCountMissing(metricsCountMissing);
+  builder_.add_metricsCountFresh(metricsCountFresh);
+  builder_.add_metricsCountCommon(metricsCountCommon);
+  builder_.add_keysCountMissing(keysCountMissing);
+  builder_.add_keysCountFresh(keysCountFresh);
+  builder_.add_keysCountCommon(keysCountCommon);
+  return builder_.Finish();
+}
+
+struct CaseComparison FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef CaseComparisonBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_CATEGORY = 4,
+    VT_SRC = 6,
+    VT_DST = 8,
+    VT_OVERVIEW = 10,
+    VT_ASSERTIONS = 12,
+    VT_RESULTS = 14,
+    VT_METRICS = 16
+  };
+  touca::fbs::ComparisonCategory category() const {
+    return static_cast<touca::fbs::ComparisonCategory>(
+        GetField<uint8_t>(VT_CATEGORY, 0));
+  }
+  const touca::fbs::ComparisonMetadata* src() const {
+    return GetPointer<const touca::fbs::ComparisonMetadata*>(VT_SRC);
+  }
+  const touca::fbs::ComparisonMetadata* dst() const {
+    return GetPointer<const touca::fbs::ComparisonMetadata*>(VT_DST);
+  }
+  const touca::fbs::ComparisonOverview* overview() const {
+    return GetPointer<const touca::fbs::ComparisonOverview*>(VT_OVERVIEW);
+  }
+  const touca::fbs::ComparisonCellar* assertions() const {
+    return GetPointer<const touca::fbs::ComparisonCellar*>(VT_ASSERTIONS);
+  }
+  const touca::fbs::ComparisonCellar* results() const {
+    return GetPointer<const touca::fbs::ComparisonCellar*>(VT_RESULTS);
+  }
+  const touca::fbs::ComparisonCellar* metrics() const {
+    return GetPointer<const touca::fbs::ComparisonCellar*>(VT_METRICS);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint8_t>(verifier, VT_CATEGORY) &&
+           VerifyOffset(verifier, VT_SRC) && verifier.VerifyTable(src()) &&
+           VerifyOffset(verifier, VT_DST) && verifier.VerifyTable(dst()) &&
+           VerifyOffset(verifier, VT_OVERVIEW) &&
+           verifier.VerifyTable(overview()) &&
+           VerifyOffset(verifier, VT_ASSERTIONS) &&
+           verifier.VerifyTable(assertions()) &&
+           VerifyOffset(verifier, VT_RESULTS) &&
+           verifier.VerifyTable(results()) &&
+           VerifyOffset(verifier, VT_METRICS) &&
+           verifier.VerifyTable(metrics()) && verifier.EndTable();
+  }
+};
+
+struct CaseComparisonBuilder {
+  typedef CaseComparison Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_category(touca::fbs::ComparisonCategory category) {
+    fbb_.AddElement<uint8_t>(CaseComparison::VT_CATEGORY,
+                             static_cast<uint8_t>(category), 0);
+  }
+  void add_src(flatbuffers::Offset<touca::fbs::ComparisonMetadata> src) {
+    fbb_.AddOffset(CaseComparison::VT_SRC, src);
+  }
+  void add_dst(flatbuffers::Offset<touca::fbs::ComparisonMetadata> dst) {
+    fbb_.AddOffset(CaseComparison::VT_DST, dst);
+  }
+  void add_overview(
+      flatbuffers::Offset<touca::fbs::ComparisonOverview> overview) {
+    fbb_.AddOffset(CaseComparison::VT_OVERVIEW, overview);
+  }
+  void add_assertions(
+      flatbuffers::Offset<touca::fbs::ComparisonCellar> assertions) {
+    fbb_.AddOffset(CaseComparison::VT_ASSERTIONS, assertions);
+  }
+  void add_results(flatbuffers::Offset<touca::fbs::ComparisonCellar> results) {
+    fbb_.AddOffset(CaseComparison::VT_RESULTS, results);
+  }
+  void add_metrics(flatbuffers::Offset<touca::fbs::ComparisonCellar> metrics) {
+    fbb_.AddOffset(CaseComparison::VT_METRICS, metrics);
+  }
+  explicit CaseComparisonBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<CaseComparison> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<CaseComparison>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<CaseComparison> CreateCaseComparison(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    touca::fbs::ComparisonCategory category =
+        touca::fbs::ComparisonCategory::Common,
+    flatbuffers::Offset<touca::fbs::ComparisonMetadata> src = 0,
+    flatbuffers::Offset<touca::fbs::ComparisonMetadata> dst = 0,
+    flatbuffers::Offset<touca::fbs::ComparisonOverview> overview = 0,
+    flatbuffers::Offset<touca::fbs::ComparisonCellar> assertions = 0,
+    flatbuffers::Offset<touca::fbs::ComparisonCellar> results = 0,
+    flatbuffers::Offset<touca::fbs::ComparisonCellar> metrics = 0) {
+  CaseComparisonBuilder builder_(_fbb);
+  builder_.add_metrics(metrics);
+  builder_.add_results(results);
+  builder_.add_assertions(assertions);
+  builder_.add_overview(overview);
+  builder_.add_dst(dst);
+  builder_.add_src(src);
+  builder_.add_category(category);
+  return builder_.Finish();
+}
+
+inline const touca::fbs::CaseComparison* GetCaseComparison(const void* buf) {
+  return flatbuffers::GetRoot<touca::fbs::CaseComparison>(buf);
+}
+
+inline const touca::fbs::CaseComparison* GetSizePrefixedCaseComparison(
+    const void* buf) {
+  return flatbuffers::GetSizePrefixedRoot<touca::fbs::CaseComparison>(buf);
+}
+
+inline bool VerifyCaseComparisonBuffer(flatbuffers::Verifier& verifier) {
+  return verifier.VerifyBuffer<touca::fbs::CaseComparison>(nullptr);
+}
+
+inline bool VerifySizePrefixedCaseComparisonBuffer(
+    flatbuffers::Verifier& verifier) {
+  return verifier.VerifySizePrefixedBuffer<touca::fbs::CaseComparison>(
+      nullptr);
+}
+
+inline void FinishCaseComparisonBuffer(
+    flatbuffers::FlatBufferBuilder& fbb,
+    flatbuffers::Offset<touca::fbs::CaseComparison> root) {
+  fbb.Finish(root);
+}
+
+inline void FinishSizePrefixedCaseComparisonBuffer(
+    flatbuffers::FlatBufferBuilder& fbb,
+    flatbuffers::Offset<touca::fbs::CaseComparison> root) {
+  fbb.FinishSizePrefixed(root);
+}
+
+}  // namespace fbs
+}  // namespace touca
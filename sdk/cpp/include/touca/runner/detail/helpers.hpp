@@ -2,23 +2,33 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "fmt/color.h"
+#include "touca/core/resultlog.hpp"
+#include "touca/core/ring_buffer.hpp"
+#include "touca/core/testcase.hpp"
 #include "touca/lib_api.hpp"
 #include "touca/runner/runner.hpp"
 
 namespace touca {
 
-enum Status : uint8_t { Pass, Fail, Skip };
+enum Status : uint8_t { Pass, Fail, Skip, Timeout };
 
 /**
  * @brief Configures the client based on a given set of configuration options
@@ -27,6 +37,116 @@ enum Status : uint8_t { Pass, Fail, Skip };
  */
 void configure(const ClientOptions& options);
 
+/**
+ * @brief Finds a testcase declared in the client
+ *
+ * @param name name of the testcase
+ * @return pointer to the testcase or nullptr if it is not declared
+ */
+std::shared_ptr<Testcase> find_testcase(const std::string& name);
+
+/**
+ * @brief Registers a testcase created outside the client, replacing any
+ *        declared testcase with the same name
+ *
+ * @param testcase testcase to be saved and submitted by the client
+ */
+void adopt_testcase(const std::shared_ptr<Testcase>& testcase);
+
+/**
+ * @brief Reads expected durations of testcases from a json file.
+ *
+ * @param path path to a json object mapping testcases to milliseconds
+ * @throw std::runtime_error if the file is missing or malformed
+ */
+std::unordered_map<std::string, unsigned long long> load_durations(
+    const touca::filesystem::path& path);
+
+/**
+ * @brief Selects the testcases that belong to a given shard.
+ *
+ * @details Every shard makes the same selection independently, given the
+ *          same inputs. Without durations, testcases are assigned by a
+ *          stable hash of their name. Otherwise, they are assigned in
+ *          decreasing order of duration to the shard with the least total
+ *          duration so far. Testcases without a known duration are
+ *          expected to take the average duration of the others.
+ *
+ * @return testcases of the shard, in their original order
+ */
+std::vector<std::string> select_shard(
+    const std::vector<std::string>& testcases, const unsigned shard_index,
+    const unsigned shard_count,
+    const std::unordered_map<std::string, unsigned long long>& durations);
+
+/**
+ * @brief Writes durations of testcases to a json file, replacing it in a
+ *        single operation.
+ *
+ * @param path path to the json file to be created or replaced
+ * @param durations milliseconds taken by each testcase
+ * @throw std::runtime_error if the file cannot be written
+ */
+void save_durations(
+    const touca::filesystem::path& path,
+    const std::unordered_map<std::string, unsigned long long>& durations);
+
+/**
+ * @brief Sorts testcases by decreasing expected duration, so that long
+ *        testcases do not hold back the end of the run.
+ *
+ * @details Testcases without a known duration are expected to take the
+ *          average duration of the others. Testcases with equal expected
+ *          durations keep their original order.
+ */
+std::vector<std::string> order_by_duration(
+    const std::vector<std::string>& testcases,
+    const std::unordered_map<std::string, unsigned long long>& durations);
+
+/**
+ * @brief Memory consumed by the workflow of a testcase.
+ */
+struct MemoryUsage {
+  bool has_peak_rss = false;
+  bool has_allocations = false;
+  std::uint64_t peak_rss = 0u;  // growth of peak resident set size in bytes
+  std::uint64_t allocations = 0u;
+  std::uint64_t allocated_bytes = 0u;
+
+  /**
+   * Reports memory usage as metrics of the given testcase.
+   */
+  void add_to(Testcase& testcase) const;
+
+  /**
+   * Finds memory usage previously reported as metrics of a testcase.
+   */
+  static MemoryUsage from_metrics(const MetricsMap& metrics);
+};
+
+/**
+ * @brief Measures memory consumed by the process between calls to
+ *        `start` and `stop`.
+ *
+ * @details On Linux, the peak resident set size of the process is reset
+ *          when measurement starts, if the kernel allows it, so that the
+ *          growth of the peak is measured even if an earlier testcase
+ *          used more memory. Elsewhere, only growth beyond the highest
+ *          peak so far is measured. Allocations are counted only if file
+ *          `touca/extra/allocations.hpp` is included in the test tool.
+ *          Measurements cover all threads of the process.
+ */
+struct MemoryProbe {
+  void start();
+  MemoryUsage stop();
+
+ private:
+  std::uint64_t _baseline = 0u;
+  bool _has_baseline = false;
+  std::uint64_t _allocations = 0u;
+  std::uint64_t _allocated_bytes = 0u;
+};
+
 struct Statistics {
   void inc(Status value);
   unsigned long count(Status value) const;
@@ -45,29 +165,91 @@ struct Timer {
   std::unordered_map<std::string, std::chrono::system_clock::time_point> _tocs;
 };
 
+struct FileSink;
+
+struct LogRecord {
+  Sink::Level level;
+  std::chrono::system_clock::time_point time;
+  std::thread::id thread;
+  std::string msg;
+};
+
+/**
+ * @brief Publishes log events of the test framework to registered sinks.
+ *
+ * @details Events are printed to the console on the calling thread, so
+ *          that they appear in order with the progress report. All other
+ *          sinks, including those registered by the user, are called from
+ *          a dedicated writer thread that consumes events from a bounded
+ *          queue. When the queue is full, debug and info events are dropped
+ *          while warnings and errors wait for room in the queue.
+ */
 struct Logger {
-  void debug(const std::string& msg) const;
-  void info(const std::string& msg) const;
-  void warn(const std::string& msg) const;
-  void error(const std::string& msg) const;
+  Logger() = default;
+  ~Logger();
+
+  void debug(const std::string& msg);
+  void info(const std::string& msg);
+  void warn(const std::string& msg);
+  void error(const std::string& msg);
   void add_sink(std::unique_ptr<Sink> sink, const Sink::Level level);
 
+  /**
+   * Waits until all events published so far are passed to their sinks.
+   */
+  void flush();
+
  private:
-  void publish(const Sink::Level level, const std::string& msg) const;
-  std::vector<std::pair<std::unique_ptr<Sink>, Sink::Level>> _sinks;
+  struct SinkEntry {
+    std::unique_ptr<Sink> sink;
+    Sink::Level level;
+    FileSink* file;
+  };
+
+  void publish(const Sink::Level level, const std::string& msg);
+  void dispatch(const LogRecord& record);
+  void run();
+
+  std::vector<SinkEntry> _sinks;
+  std::vector<SinkEntry> _async_sinks;
+  Sink::Level _async_level = Sink::Level::Error;
+  std::unique_ptr<detail::ring_buffer<LogRecord>> _queue;
+  std::atomic<unsigned long long> _pushed{0u};
+  std::atomic<unsigned long long> _dropped{0u};
+  unsigned long long _written = 0u;
+  unsigned long long _reported = 0u;
+  bool _stopping = false;
+  std::mutex _mutex;
+  std::mutex _sinks_mutex;
+  std::condition_variable _cv;
+  std::condition_variable _cv_flushed;
+  std::thread _thread;
 };
 
+/**
+ * @brief Reports progress of the test framework to the console and to a
+ *        file in the output directory.
+ *
+ * @details Each report is assembled in memory and written with a single
+ *          call. In live mode, the console only shows a summary line that
+ *          is refreshed at most ten times per second, along with the full
+ *          report of failed testcases, while the file still receives the
+ *          report of every testcase.
+ */
 struct Printer {
   unsigned testcase_count;  // number of testcases
   unsigned testcase_width;  // longest testcase length
+  std::string label;        // prefix of progress lines, if any
 
-  void update(const touca::filesystem::path& path, const bool colored_output);
+  void update(const touca::filesystem::path& path, const bool colored_output,
+              const bool live_progress = false);
 
   void print_header(const FrameworkOptions& options);
 
   void print_progress(const unsigned index, const Status status,
                       const std::string& testcase, const Timer& timer,
-                      const std::vector<std::string>& errors = {});
+                      const std::vector<std::string>& errors = {},
+                      const MemoryUsage& memory = {});
 
   void print_footer(const Statistics& stats, Timer& timer,
                     const unsigned suiteSize);
@@ -76,28 +258,62 @@ struct Printer {
   template <typename... Args>
   void print(const std::string& fmtstr, Args&&... args) {
     const auto& content = fmt::format(fmtstr, std::forward<Args>(args)...);
-    fmt::print(_file, "{}", content);
-    fmt::print(std::cout, "{}", content);
-    _file.flush();
-    std::cout.flush();
+    _plain += content;
+    _styled += content;
   }
 
   template <typename... Args>
   void print(const fmt::text_style& style, const std::string& fmtstr,
              Args&&... args) {
     const auto& content = fmt::format(fmtstr, std::forward<Args>(args)...);
-    fmt::print(_file, "{}", content);
-    fmt::print(std::cout, "{}", _color ? fmt::format(style, content) : content);
-    _file.flush();
-    std::cout.flush();
+    _plain += content;
+    _styled += _color ? fmt::format(style, "{}", content) : content;
   }
 
+  void flush(const bool to_console = true);
+  void print_live_line(const bool force);
+
   bool _color;
+  bool _live = false;
   std::ofstream _file;
+  std::string _plain;
+  std::string _styled;
+  std::map<Status, unsigned> _counts;
+  std::chrono::steady_clock::time_point _last_refresh;
+  bool _live_line = false;
   const std::map<Status, std::tuple<fmt::terminal_color, std::string>> _states =
       {{Status::Pass, std::make_tuple(fmt::terminal_color::green, "PASS")},
        {Status::Skip, std::make_tuple(fmt::terminal_color::yellow, "SKIP")},
-       {Status::Fail, std::make_tuple(fmt::terminal_color::red, "FAIL")}};
+       {Status::Fail, std::make_tuple(fmt::terminal_color::red, "FAIL")},
+       {Status::Timeout,
+        std::make_tuple(fmt::terminal_color::magenta, "TIME")}};
+};
+
+/**
+ * @brief Removes directories in a background thread.
+ *
+ * @details Directories are moved out of the way with a single rename
+ *          into a trash directory, so that a new directory with the same
+ *          name can be created right away. The trash directory is removed
+ *          once all its content is deleted, when this object is destroyed.
+ */
+struct Trash {
+  explicit Trash(const touca::filesystem::path& root);
+  ~Trash();
+
+  void discard(const touca::filesystem::path& path);
+
+ private:
+  void run();
+
+  touca::filesystem::path _root;
+  std::string _prefix;
+  unsigned long _counter = 0u;
+  bool _stopping = false;
+  std::deque<touca::filesystem::path> _queue;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::thread _thread;
 };
 
 /**
@@ -121,20 +337,182 @@ struct TOUCA_CLIENT_API OutputCapturer {
   std::stringstream _bufout;
 };
 
+/**
+ * @brief Captures everything written to file descriptors of standard
+ *        output and error, including output of C functions, native
+ *        libraries and child processes.
+ *
+ * @details Each descriptor is redirected to a pipe that is drained by a
+ *          reader thread into `stdout.txt` or `stderr.txt` in the given
+ *          directory. Files are only created once there is some output.
+ *          Output beyond the given size limit is discarded and noted at
+ *          the end of the file.
+ *
+ *          Child processes that outlive the capture may keep the pipes
+ *          open. Readers therefore stop within a second of the end of the
+ *          capture, even if they have not reached the end of their input,
+ *          and later writes of those processes fail. Pipes are not inherited
+ *          by child processes other than through the captured descriptors.
+ */
+struct TOUCA_CLIENT_API DescriptorCapturer {
+  /**
+   * @param dir directory to write captured output into
+   * @param limit maximum number of bytes to keep for each descriptor,
+   *              or zero to keep everything
+   */
+  DescriptorCapturer(const touca::filesystem::path& dir,
+                     const std::uint64_t limit);
+  ~DescriptorCapturer();
+
+  void start_capture();
+  void stop_capture();
+
+ private:
+  struct Channel {
+    int fd;
+    int saved = -1;
+    int pipe = -1;
+    touca::filesystem::path path;
+    std::thread reader;
+  };
+
+  void drain(Channel& channel);
+
+  std::uint64_t _limit;
+  bool _capturing = false;
+  std::atomic<bool> _stopping{false};
+  std::chrono::steady_clock::time_point _deadline;
+  Channel _channels[2];
+};
+
+/**
+ * @brief Pool of worker processes forked from the test runner that execute
+ *        testcases in isolation from the runner and from each other.
+ *
+ * @details Workers are forked once, when the pool is created, and receive
+ *          names of testcases to execute over a pipe. Each worker sends back
+ *          the errors of the workflow and the serialized results of the
+ *          testcase. A worker that crashes is reported as a failure of its
+ *          testcase and is replaced with a new worker. Only supported on
+ *          platforms that provide `fork`.
+ *
+ *          Workers are not forked by the runner itself but by a spawner
+ *          process that is forked when the pool is created and does nothing
+ *          but fork and reap workers on request of the runner. The pool
+ *          should therefore be created before the runner starts any thread,
+ *          so that workers, including the ones that replace crashed workers,
+ *          never inherit locks held by threads that do not exist in them.
+ */
+struct WorkerPool {
+  struct Result {
+    unsigned index;
+    std::string testcase;
+    std::vector<std::string> errors;
+    std::vector<std::uint8_t> message;  // empty if the worker crashed
+    bool timed_out = false;
+  };
+
+  using Task = std::function<void(const std::string& testcase,
+                                  std::vector<std::string>& errors,
+                                  std::vector<std::uint8_t>& message)>;
+
+  WorkerPool(const unsigned size, Task task);
+  ~WorkerPool();
+
+  bool has_idle_worker() const;
+  bool has_busy_worker() const;
+
+  /**
+   * Sends a testcase to an idle worker. Expects at least one idle worker.
+   *
+   * @param timeout time after which the worker is killed, or zero to let
+   *                the worker run for as long as it takes
+   */
+  void submit(const unsigned index, const std::string& testcase,
+              const std::chrono::milliseconds timeout);
+
+  /**
+   * Waits until a busy worker completes, crashes or runs out of time.
+   */
+  Result wait();
+
+ private:
+  struct Worker {
+    int pid = -1;
+    int request = -1;
+    int response = -1;
+    bool busy = false;
+    unsigned index = 0u;
+    std::string testcase;
+    std::chrono::steady_clock::time_point deadline;
+    bool has_deadline = false;
+  };
+
+  void start_spawner();
+  void stop_spawner();
+  void run_spawner(const int control);
+  int reap(Worker& worker);
+  void spawn(Worker& worker);
+  void stop(Worker& worker);
+  void expire(Worker& worker, Result& result);
+  void serve(const int request, const int response);
+
+  Task _task;
+  std::vector<Worker> _workers;
+  int _spawner = -1;
+  int _control = -1;
+  void (*_sigpipe)(int) = nullptr;
+};
+
 struct TOUCA_CLIENT_API Runner {
   using Workflow = std::function<void(const std::string&)>;
 
   Runner(int argc, char* argv[]);
+
+  /**
+   * Creates a runner with options that are already parsed and validated.
+   *
+   * @param client client that captures and submits results of testcases,
+   *               or nullptr for the client shared by the whole process.
+   */
+  explicit Runner(const FrameworkOptions& options,
+                  std::shared_ptr<ClientImpl> client = nullptr);
+
   int run(const Workflow workflow);
 
  private:
   void run_testcase(const Workflow workflow, const std::string& testcase,
                     const unsigned index);
 
+  void start_workers(const Workflow workflow);
+
+  void run_isolated();
+
+  bool prepare_testcase(const std::string& testcase, const unsigned index);
+
+  Status execute_testcase(const Workflow workflow, const std::string& testcase,
+                          std::vector<std::string>& errors,
+                          const unsigned timeout);
+
+  void finish_testcase(const std::string& testcase, const unsigned index,
+                       const Status status,
+                       const std::vector<std::string>& errors);
+
+  unsigned find_timeout(const std::string& testcase) const;
+
+  void scan_output_dir(const touca::filesystem::path& output_dir_version);
+
   Timer timer;
   Logger logger;
   Printer printer;
   Statistics stats;
   FrameworkOptions options;
+  std::shared_ptr<ClientImpl> client;
+  std::unique_ptr<ResultLog> result_log;
+  std::unique_ptr<Trash> trash;
+  std::unique_ptr<WorkerPool> pool;
+  std::unordered_set<std::string> existing_dirs;
+  std::unordered_set<std::string> processed;
+  std::unordered_map<std::string, unsigned long long> durations;
 };
 }  // namespace touca
@@ -9,18 +9,35 @@
 namespace touca {
 struct FrameworkOptions : public ClientOptions {
   std::map<std::string, std::string> extra;
+  std::map<std::string, unsigned> timeouts;
   std::string testcase_file;
   std::string config_file;
   std::string output_dir = "./results";
   std::string log_level = "info";
+  std::string redirect_mode = "stream";
+  std::string order = "input";
+  std::string shard_durations;
+  std::string shard_sync_dir;
   bool has_help = false;
   bool has_version = false;
   bool colored_output = true;
+  bool live_progress = false;
   bool save_binary = true;
   bool save_json = false;
   bool skip_logs = false;
   bool redirect = true;
   bool overwrite = false;
+  bool result_log = false;
+  bool isolate = false;
+  bool memory_metrics = false;
+  unsigned workers = 0;
+  unsigned parallel_workflows = 1;
+  unsigned timeout = 0;
+  unsigned repeat = 1;
+  unsigned warmup = 0;
+  unsigned shard_index = 0;
+  unsigned shard_count = 0;
+  unsigned redirect_limit = 0;
 };
 bool parse_options(int argc, char* argv[], FrameworkOptions& options);
 std::string cli_help_description();
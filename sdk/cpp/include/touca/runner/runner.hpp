@@ -37,6 +37,13 @@
 
 namespace touca {
 
+/**
+ * Queries the server for the list of testcases of the suite, signing in
+ * through the session shared with all clients of this process.
+ *
+ * @throw std::runtime_error if the API URL is invalid or if signing in
+ *        to the server failed
+ */
 TOUCA_CLIENT_API std::vector<std::string> get_testsuite_remote(
     const FrameworkOptions& options);
 
@@ -55,6 +62,9 @@ struct TOUCA_CLIENT_API Sink {
   /**
    * @brief Called by the test framework when a log event is published.
    *
+   * @details Sinks are called from a dedicated thread of the test
+   *          framework, one event at a time and in order of publication.
+   *
    * @param level minimum level of detail to subscribe to
    * @param event log message published by the framework
    */
@@ -13,6 +13,7 @@
  *          capture results and submit them to the Touca server.
  */
 
+#include <functional>
 #include <unordered_map>
 
 #include "touca/core/serializer.hpp"
@@ -246,6 +247,30 @@ TOUCA_CLIENT_API void declare_testcase(const std::string& name);
  */
 TOUCA_CLIENT_API void forget_testcase(const std::string& name);
 
+/**
+ * @brief Binds a function to the client that the calling thread uses.
+ *
+ * @details When workflows run in parallel, each workflow has its own
+ *          client, which only the thread running the workflow uses.
+ *          Threads that the workflow spawns use the default client and
+ *          their results are dropped, unless they run functions that are
+ *          bound to the client of the workflow using this function.
+ *
+ * @code
+ *   std::thread worker(touca::bind_client([] {
+ *     touca::check("some-key", some_value);
+ *   }));
+ * @endcode
+ *
+ * @param task function to be called on another thread
+ * @return function that calls `task` with calls to this API routed to
+ *         the client of the calling thread
+ *
+ * @since v1.7
+ */
+TOUCA_CLIENT_API std::function<void()> bind_client(
+    const std::function<void()>& task);
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 /**
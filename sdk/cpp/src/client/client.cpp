@@ -2,26 +2,59 @@
 
 #include "touca/client/detail/client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "touca/client/detail/counters.hpp"
 #include "touca/client/detail/options.hpp"
 #include "touca/core/filesystem.hpp"
 #include "touca/core/platform.hpp"
 #include "touca/core/utils.hpp"
 #include "touca/impl/schema.hpp"
 
-/** maximum number of attempts to re-submit failed http requests */
-constexpr unsigned post_max_retries = 2U;
-
 /** maximum number of cases to be posted in a single http request */
 constexpr unsigned post_max_cases = 10U;
 
 namespace touca {
 
+std::shared_ptr<Platform> find_session(const ApiUrl& api_url,
+                                       const ClientOptions& options,
+                                       std::string& error) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::shared_ptr<Platform>> sessions;
+  const auto& key = touca::detail::format(
+      "{}\n{}\n{}\n{}\n{}\n{}", api_url.root(), api_url.route(""),
+      options.api_key, options.connect_timeout, options.read_timeout,
+      options.max_inflight);
+  // clients that are configured at the same time wait for the first one
+  // to sign in, instead of signing in on their own. sessions whose token
+  // the server no longer accepts, and that failed to sign in again, are
+  // replaced.
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& session = sessions[key];
+  if (session && session->has_token()) {
+    return session;
+  }
+  TransportOptions transport;
+  transport.connect_timeout = options.connect_timeout;
+  transport.read_timeout = options.read_timeout;
+  transport.max_inflight = options.max_inflight;
+  session = std::make_shared<Platform>(api_url, transport);
+  if (!session->auth(options.api_key)) {
+    error = session->get_error();
+    sessions.erase(key);
+    return nullptr;
+  }
+  return session;
+}
+
 bool ClientImpl::configure(const ClientImpl::OptionsMap& opts) {
   _config_error.clear();
   parse_options(opts, _options);
@@ -35,6 +68,9 @@ bool ClientImpl::configure(const ClientOptions& options) {
 }
 
 bool ClientImpl::apply_options() {
+  // the submitter uses the platform that is about to be replaced
+  _submitter.reset();
+  _spool.reset();
   try {
     if (reformat_options(_options)) {
       _configured = true;
@@ -49,15 +85,34 @@ bool ClientImpl::apply_options() {
   // perform authentication to server using the provided
   // API key and obtain API token for posting results.
   ApiUrl api_url(_options.api_url);
-  _platform = std::unique_ptr<Platform>(new Platform(api_url));
-  if (!_platform->auth(_options.api_key)) {
-    _config_error = _platform->get_error();
+  const auto& session = find_session(api_url, _options, _config_error);
+  if (!session) {
     return false;
   }
+  _platform = std::unique_ptr<Platform>(new Platform(api_url, *session));
+  _platform->set_params(_options.team, _options.suite, _options.revision);
+
+  // submissions are kept on disk until the server accepts them and are
+  // replayed in the background, starting with those left by earlier runs.
+  if (!_options.spool_dir.empty()) {
+    try {
+      _spool = detail::make_unique<Spool>(_options.spool_dir);
+    } catch (const std::exception& ex) {
+      _config_error = ex.what();
+      return false;
+    }
+    _submitter = detail::make_unique<SpoolSubmitter>(*_platform, *_spool);
+  }
 
   // retrieve list of known test cases for this suite
   if (_options.testcases.empty()) {
-    _options.testcases = _platform->elements();
+    const auto& cache_path =
+        _options.cache_dir.empty()
+            ? std::string()
+            : (touca::filesystem::path(_options.cache_dir) / _options.team /
+               _options.suite / "elements.json")
+                  .string();
+    _options.testcases = _platform->elements(cache_path);
     if (_options.testcases.empty()) {
       _config_error = _platform->get_error();
       return false;
@@ -94,6 +149,17 @@ std::shared_ptr<touca::Testcase> ClientImpl::declare_testcase(
   if (!_testcases.count(name)) {
     const auto& tc = std::make_shared<Testcase>(_options.team, _options.suite,
                                                 _options.revision, name);
+    if (_options.max_testcase_memory || _options.max_client_memory) {
+      const auto& spill_dir =
+          _options.spill_dir.empty()
+              ? touca::filesystem::temp_directory_path() / "touca" /
+                    _options.suite / _options.revision
+              : touca::filesystem::path(_options.spill_dir);
+      tc->set_memory_budget(
+          static_cast<std::size_t>(_options.max_testcase_memory) << 20,
+          (spill_dir / name / "touca.spill").string());
+    }
+    tc->set_memory_total(_memoryUsage);
     _testcases.emplace(name, tc);
   }
   _threadMap[std::this_thread::get_id()] = name;
@@ -101,6 +167,23 @@ std::shared_ptr<touca::Testcase> ClientImpl::declare_testcase(
   return _testcases.at(name);
 }
 
+std::shared_ptr<touca::Testcase> ClientImpl::find_testcase(
+    const std::string& name) const {
+  const auto& it = _testcases.find(name);
+  return it == _testcases.end() ? nullptr : it->second;
+}
+
+void ClientImpl::adopt_testcase(const std::shared_ptr<Testcase>& testcase) {
+  if (!_configured) {
+    return;
+  }
+  // testcases rebuilt from serialized results are marked as posted, but
+  // adopted testcases are yet to be submitted.
+  testcase->_posted = false;
+  testcase->set_memory_total(_memoryUsage);
+  _testcases[testcase->metadata().testcase] = testcase;
+}
+
 void ClientImpl::forget_testcase(const std::string& name) {
   if (!_testcases.count(name)) {
     const auto err = touca::detail::format("key `{}` does not exist", name);
@@ -114,12 +197,14 @@ void ClientImpl::forget_testcase(const std::string& name) {
 void ClientImpl::check(const std::string& key, const data_point& value) {
   if (has_last_testcase()) {
     _testcases.at(get_last_testcase())->check(key, value);
+    enforce_memory_budget();
   }
 }
 
 void ClientImpl::assume(const std::string& key, const data_point& value) {
   if (has_last_testcase()) {
     _testcases.at(get_last_testcase())->assume(key, value);
+    enforce_memory_budget();
   }
 }
 
@@ -127,12 +212,14 @@ void ClientImpl::add_array_element(const std::string& key,
                                    const data_point& value) {
   if (has_last_testcase()) {
     _testcases.at(get_last_testcase())->add_array_element(key, value);
+    enforce_memory_budget();
   }
 }
 
 void ClientImpl::add_hit_count(const std::string& key) {
   if (has_last_testcase()) {
     _testcases.at(get_last_testcase())->add_hit_count(key);
+    enforce_memory_budget();
   }
 }
 
@@ -142,15 +229,109 @@ void ClientImpl::add_metric(const std::string& key, const unsigned duration) {
   }
 }
 
+/**
+ * Values of hardware performance counters when timers that are running on
+ * the calling thread were started.
+ */
+static thread_local std::unordered_map<std::string,
+                                       detail::PerfCounters::Values>
+    counter_starts;
+
 void ClientImpl::start_timer(const std::string& key) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->tic(key);
+  if (!has_last_testcase()) {
+    return;
+  }
+  _testcases.at(get_last_testcase())->tic(key);
+  if (!_options.perf_counters) {
+    return;
   }
+  const auto& counters = detail::PerfCounters::local();
+  if (!counters.available()) {
+    static std::once_flag reported;
+    std::call_once(reported, [this, &counters]() {
+      notify_loggers(logger::Level::Warning, counters.error());
+    });
+    return;
+  }
+  // counters are read last so that they leave out the cost of starting
+  // the timer.
+  counter_starts[key] = counters.read();
 }
 
 void ClientImpl::stop_timer(const std::string& key) {
+  detail::PerfCounters::Values values{};
+  if (_options.perf_counters) {
+    values = detail::PerfCounters::local().read();
+  }
+  if (!has_last_testcase()) {
+    return;
+  }
+  const auto& testcase = _testcases.at(get_last_testcase());
+  testcase->toc(key);
+  const auto& it = counter_starts.find(key);
+  if (it == counter_starts.end()) {
+    return;
+  }
+  const auto& counters = detail::PerfCounters::local();
+  for (auto i = 0u; i < detail::perf_event_count; ++i) {
+    const auto event = static_cast<detail::PerfEvent>(i);
+    if (counters.available(event)) {
+      testcase->add_counter(key + detail::perf_event_suffix(event),
+                            values[i] - it->second[i]);
+    }
+  }
+  counter_starts.erase(it);
+}
+
+/**
+ * Scope of code measured by the hierarchical profiler.
+ */
+struct ProfileFrame {
+  std::string path;
+  std::chrono::steady_clock::time_point start;
+  std::uint64_t children;
+};
+
+/**
+ * Scopes measured by the hierarchical profiler that are open on the
+ * calling thread, outermost first.
+ */
+static thread_local std::vector<ProfileFrame> profile_stack;
+
+void ClientImpl::start_scope(const std::string& name) {
+  if (!_options.profile) {
+    start_timer(name);
+    return;
+  }
+  auto path = profile_stack.empty() ? name : profile_stack.back().path;
+  if (!profile_stack.empty()) {
+    path.append(1, ';').append(name);
+  }
+  profile_stack.push_back(
+      ProfileFrame{std::move(path), std::chrono::steady_clock::now(), 0u});
+}
+
+void ClientImpl::stop_scope(const std::string& name) {
+  if (!_options.profile) {
+    stop_timer(name);
+    return;
+  }
+  if (profile_stack.empty()) {
+    return;
+  }
+  const auto& elapsed = std::chrono::steady_clock::now() -
+                        profile_stack.back().start;
+  const auto total = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  const auto children = std::min(total, profile_stack.back().children);
+  const auto path = std::move(profile_stack.back().path);
+  profile_stack.pop_back();
+  if (!profile_stack.empty()) {
+    profile_stack.back().children += total;
+  }
   if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->toc(key);
+    _testcases.at(get_last_testcase())
+        ->add_profile_sample(path, total, total - children);
   }
 }
 
@@ -206,21 +387,64 @@ bool ClientImpl::post() const {
   // group multiple testcases together according to `_postMaxTestcases`
   // configuration parameter and post each group separately in
   // flatbuffers format.
+  std::vector<std::vector<std::string>> batches;
   for (auto it = testcases.begin(); it != testcases.end();) {
     const auto& tail = it + (std::min)(static_cast<ptrdiff_t>(post_max_cases),
                                        std::distance(it, testcases.end()));
-    std::vector<std::string> batch(it, tail);
-    // attempt to post results for this group of testcases.
-    // currently we only support posting data in flatbuffers format.
-    const auto isPosted = post_flatbuffers(find_testcases(batch));
+    batches.emplace_back(it, tail);
     it = tail;
-    if (!isPosted) {
+  }
+  // with a spool, groups are written to disk and submitted in the
+  // background so that the caller never waits for the server.
+  if (_spool) {
+    for (const auto& batch : batches) {
+      const auto& buffer = Testcase::serialize(find_testcases(batch));
+      try {
+        _spool->push(std::string((const char*)buffer.data(), buffer.size()));
+      } catch (const std::exception& ex) {
+        notify_loggers(logger::Level::Error, ex.what());
+        ret = false;
+        continue;
+      }
+      for (const auto& tc : batch) {
+        _testcases.at(tc)->_posted = true;
+      }
+    }
+    _submitter->notify();
+    return ret;
+  }
+  // up to `max_inflight` groups are serialized and submitted at the same
+  // time, each over its own connection.
+  std::vector<std::vector<std::string>> errors(batches.size());
+  std::atomic<std::size_t> next(0u);
+  const auto& submit = [this, &batches, &errors, &next]() {
+    for (auto i = next++; i < batches.size(); i = next++) {
+      errors[i] = post_flatbuffers(find_testcases(batches[i]));
+    }
+  };
+  const auto& thread_count =
+      (std::min)(static_cast<std::size_t>(_options.max_inflight),
+                 batches.size());
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < thread_count; ++i) {
+    threads.emplace_back(submit);
+  }
+  submit();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto i = 0u; i < batches.size(); ++i) {
+    for (const auto& err : errors[i]) {
+      notify_loggers(logger::Level::Warning, err);
+    }
+    if (!errors[i].empty()) {
       notify_loggers(logger::Level::Error,
                      "failed to post test results for a group of testcases");
       ret = false;
       continue;
     }
-    for (const auto& tc : batch) {
+    for (const auto& tc : batches[i]) {
       _testcases.at(tc)->_posted = true;
     }
   }
@@ -238,6 +462,36 @@ bool ClientImpl::seal() const {
                    "client is not authenticated to the server");
     return false;
   };
+  // results must all be accepted by the server before the version is
+  // sealed, or else they would be rejected when they are replayed.
+  if (_submitter) {
+    std::vector<std::string> rejections;
+    const auto& errors = _submitter->flush(&rejections);
+    // submissions that the server rejected are never replayed and do not
+    // keep the version from being sealed.
+    for (const auto& err : rejections) {
+      notify_loggers(logger::Level::Warning, err);
+    }
+    if (!rejections.empty()) {
+      notify_loggers(logger::Level::Warning,
+                     touca::detail::format(
+                         "some test results were rejected by the server and "
+                         "are set aside in {}",
+                         _spool->failed_dir().string()));
+    }
+    for (const auto& err : errors) {
+      notify_loggers(logger::Level::Warning, err);
+    }
+    if (!errors.empty()) {
+      notify_loggers(logger::Level::Error,
+                     touca::detail::format(
+                         "some test results are not yet submitted; upload "
+                         "them with `touca_cli upload --src {}` before "
+                         "sealing",
+                         _spool->dir().string()));
+      return false;
+    }
+  }
   if (!_platform->set_params(_options.team, _options.suite,
                              _options.revision) ||
       !_platform->seal()) {
@@ -292,23 +546,54 @@ std::string ClientImpl::get_last_testcase() const {
   return _threadMap.at(std::this_thread::get_id());
 }
 
-std::vector<Testcase> ClientImpl::find_testcases(
+std::vector<std::shared_ptr<Testcase>> ClientImpl::find_testcases(
     const std::vector<std::string>& names) const {
-  std::vector<Testcase> testcases;
+  std::vector<std::shared_ptr<Testcase>> testcases;
   testcases.reserve(names.size());
   for (const auto& name : names) {
-    testcases.emplace_back(*_testcases.at(name));
+    testcases.emplace_back(_testcases.at(name));
   }
   return testcases;
 }
 
-void ClientImpl::save_json(const touca::filesystem::path& path,
-                           const std::vector<Testcase>& testcases) const {
+void ClientImpl::enforce_memory_budget() {
+  if (!_options.max_client_memory) {
+    return;
+  }
+  const auto budget = static_cast<std::size_t>(_options.max_client_memory)
+                      << 20;
+  auto usage = _memoryUsage->load();
+  // results that cannot be spilled remain in memory. if they alone exceed
+  // the budget, wait for half a budget worth of new results before trying
+  // again, to avoid writing small chunks on every call.
+  if (usage <= budget || usage <= _memoryFloor + budget / 2) {
+    return;
+  }
+  // spill the testcases holding the most memory first, until we are
+  // within budget or there is nothing left to spill. testcases are only
+  // visited here, not on every check of the budget.
+  while (usage > budget) {
+    const auto& largest = std::max_element(
+        _testcases.begin(), _testcases.end(),
+        [](const ElementsMap::value_type& a, const ElementsMap::value_type& b) {
+          return a.second->memory_usage() < b.second->memory_usage();
+        });
+    if (largest == _testcases.end() || !largest->second->spill()) {
+      break;
+    }
+    usage = _memoryUsage->load();
+  }
+  _memoryFloor = usage > budget ? usage : 0u;
+}
+
+void ClientImpl::save_json(
+    const touca::filesystem::path& path,
+    const std::vector<std::shared_ptr<Testcase>>& testcases) const {
   rapidjson::Document doc(rapidjson::kArrayType);
   rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
 
   for (const auto& testcase : testcases) {
-    doc.PushBack(testcase.json(allocator), allocator);
+    doc.PushBack(testcase->json(allocator), allocator);
   }
 
   rapidjson::StringBuffer strbuf;
@@ -321,19 +606,15 @@ void ClientImpl::save_json(const touca::filesystem::path& path,
 
 void ClientImpl::save_flatbuffers(
     const touca::filesystem::path& path,
-    const std::vector<Testcase>& testcases) const {
+    const std::vector<std::shared_ptr<Testcase>>& testcases) const {
   detail::save_binary_file(path.string(), Testcase::serialize(testcases));
 }
 
-bool ClientImpl::post_flatbuffers(
-    const std::vector<Testcase>& testcases) const {
+std::vector<std::string> ClientImpl::post_flatbuffers(
+    const std::vector<std::shared_ptr<Testcase>>& testcases) const {
   const auto& buffer = Testcase::serialize(testcases);
   std::string content((const char*)buffer.data(), buffer.size());
-  const auto& errors = _platform->submit(content, post_max_retries);
-  for (const auto& err : errors) {
-    notify_loggers(logger::Level::Warning, err);
-  }
-  return errors.empty();
+  return _platform->submit(content);
 }
 
 void ClientImpl::notify_loggers(const logger::Level severity,
@@ -0,0 +1,127 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/client/detail/counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace touca {
+namespace detail {
+
+const char* perf_event_suffix(const PerfEvent event) {
+  switch (event) {
+    case PerfEvent::Instructions:
+      return ".instructions";
+    case PerfEvent::Cycles:
+      return ".cycles";
+    case PerfEvent::CacheMisses:
+      return ".cache_misses";
+    case PerfEvent::BranchMisses:
+      return ".branch_misses";
+  }
+  return "";
+}
+
+#ifdef __linux__
+
+static int open_counter(const std::uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  const auto fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  ioctl(static_cast<int>(fd), PERF_EVENT_IOC_ENABLE, 0);
+  return static_cast<int>(fd);
+}
+
+PerfCounters::PerfCounters() {
+  const std::array<std::uint64_t, perf_event_count> configs = {
+      {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+       PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES}};
+  for (auto i = 0u; i < perf_event_count; ++i) {
+    _fds[i] = open_counter(configs[i]);
+    if (_fds[i] == -1 && _error.empty()) {
+      _error = std::string("failed to open hardware performance counter: ") +
+               std::strerror(errno);
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const auto fd : _fds) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
+}
+
+PerfCounters::Values PerfCounters::read() const {
+  Values values{};
+  for (auto i = 0u; i < perf_event_count; ++i) {
+    std::uint64_t content[3] = {0u, 0u, 0u};
+    if (_fds[i] == -1 ||
+        ::read(_fds[i], content, sizeof(content)) != sizeof(content)) {
+      continue;
+    }
+    // content holds the counter value, followed by the durations for
+    // which the counter was enabled and actually running.
+    values[i] = content[2] == 0u || content[1] == content[2]
+                    ? content[0]
+                    : static_cast<std::uint64_t>(
+                          static_cast<double>(content[0]) *
+                          static_cast<double>(content[1]) /
+                          static_cast<double>(content[2]));
+  }
+  return values;
+}
+
+#else
+
+PerfCounters::PerfCounters()
+    : _error("hardware performance counters are not supported on this "
+             "platform") {
+  _fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {}
+
+PerfCounters::Values PerfCounters::read() const { return Values{}; }
+
+#endif
+
+PerfCounters& PerfCounters::local() {
+  static thread_local PerfCounters counters;
+  return counters;
+}
+
+bool PerfCounters::available(const PerfEvent event) const {
+  return _fds[static_cast<std::size_t>(event)] != -1;
+}
+
+bool PerfCounters::available() const {
+  for (const auto fd : _fds) {
+    if (fd != -1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace detail
+}  // namespace touca
@@ -25,6 +25,13 @@ template <>
 func_t parse_member(bool& member) {
   return [&member](const std::string& value) { member = value != "false"; };
 }
+
+template <>
+func_t parse_member(unsigned& member) {
+  return [&member](const std::string& value) {
+    member = static_cast<unsigned>(std::stoul(value));
+  };
+}
 }  // namespace detail
 
 /**
@@ -64,6 +71,11 @@ bool reformat_options(ClientOptions& existing) {
   existing.suite = api_url._suite;
   existing.revision = api_url._revision;
 
+  if (existing.max_inflight == 0) {
+    throw std::runtime_error(
+        "configuration parameter \"max-inflight\" must be positive");
+  }
+
   // if required parameters are not set, maybe user is just experimenting.
   const auto is_pristine = [&params](const std::vector<std::string>& keys) {
     return std::all_of(
@@ -112,6 +124,20 @@ void parse_options(const std::unordered_map<std::string, std::string>& incoming,
   parsers.emplace("offline", detail::parse_member(existing.offline));
   parsers.emplace("single-thread",
                   detail::parse_member(existing.single_thread));
+  parsers.emplace("max-testcase-memory",
+                  detail::parse_member(existing.max_testcase_memory));
+  parsers.emplace("max-client-memory",
+                  detail::parse_member(existing.max_client_memory));
+  parsers.emplace("spill-dir", detail::parse_member(existing.spill_dir));
+  parsers.emplace("profile", detail::parse_member(existing.profile));
+  parsers.emplace("perf-counters",
+                  detail::parse_member(existing.perf_counters));
+  parsers.emplace("connect-timeout",
+                  detail::parse_member(existing.connect_timeout));
+  parsers.emplace("read-timeout", detail::parse_member(existing.read_timeout));
+  parsers.emplace("max-inflight", detail::parse_member(existing.max_inflight));
+  parsers.emplace("spool-dir", detail::parse_member(existing.spool_dir));
+  parsers.emplace("cache-dir", detail::parse_member(existing.cache_dir));
 
   for (const auto& kvp : incoming) {
     if (parsers.count(kvp.first)) {
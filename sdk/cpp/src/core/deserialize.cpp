@@ -1,6 +1,6 @@
 // Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
 
-#include "touca/cli/deserialize.hpp"
+#include "touca/core/deserialize.hpp"
 
 #include <stdexcept>
 
@@ -85,16 +85,32 @@ Testcase deserialize_testcase(const std::vector<uint8_t>& buffer) {
   }
 
   std::unordered_map<std::string, detail::number_unsigned_t> metricsMap;
+  std::unordered_map<std::string, MetricSummary> summariesMap;
+  ProfileMap profile;
+  std::unordered_map<std::string, detail::number_unsigned_t> countersMap;
   const auto& metrics = message->metrics()->entries();
   for (const auto&& metric : *metrics) {
     const auto& key = metric->key()->data();
     const auto& value = deserialize_value(metric->value());
+    MetricSummary summary;
+    if (MetricSummary::from_data_point(value, summary)) {
+      summariesMap.emplace(key, summary);
+      continue;
+    }
+    if (profile_from_data_point(value, profile)) {
+      continue;
+    }
+    if (value.type() == detail::internal_type::number_unsigned) {
+      countersMap.emplace(key, value.as_number_unsigned());
+      continue;
+    }
     if (value.type() != detail::internal_type::number_signed) {
       throw std::runtime_error("failed to parse metrics map entry");
     }
     metricsMap.emplace(key, value.as_metric());
   }
 
-  return Testcase(metadata, resultsMap, metricsMap);
+  return Testcase(metadata, resultsMap, metricsMap, summariesMap, profile,
+                  countersMap);
 }
 }  // namespace touca
@@ -2,52 +2,159 @@
 
 #include "touca/core/platform.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
 #include <regex>
 #include <sstream>
+#include <thread>
 
 #include "httplib.h"
 #include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 #include "touca/core/filesystem.hpp"
 
 namespace touca {
 
+/**
+ * Sends requests to the server through a pool of persistent connections,
+ * so that up to a given number of requests can be in flight at the same
+ * time. Connections are opened on demand and are kept alive for reuse by
+ * later requests.
+ */
 class Http : public Transport {
  public:
-  explicit Http(const std::string& root);
+  Http(const std::string& root, const TransportOptions& options);
   void set_token(const std::string& token);
-  Response get(const std::string& route) const;
+  Response get(const std::string& route,
+               const HttpHeaders& headers = HttpHeaders()) const;
   Response patch(const std::string& route, const std::string& body = "") const;
   Response post(const std::string& route, const std::string& body = "") const;
-  Response binary(const std::string& route, const std::string& content) const;
+  Response binary(const std::string& route, const std::string& content,
+                  const std::string& idempotency_key = "") const;
 
  private:
-  mutable httplib::Client _cli;
+  /**
+   * Connection borrowed from the pool for the duration of one request.
+   */
+  class Lease {
+   public:
+    Lease(const Http& http, std::unique_ptr<httplib::Client> client)
+        : _http(http), _client(std::move(client)) {}
+    Lease(Lease&& other)
+        : _http(other._http), _client(std::move(other._client)) {}
+    ~Lease() {
+      if (_client) {
+        _http.release(std::move(_client));
+      }
+    }
+    httplib::Client* operator->() const { return _client.get(); }
+
+   private:
+    const Http& _http;
+    std::unique_ptr<httplib::Client> _client;
+  };
+
+  Lease acquire() const;
+  void release(std::unique_ptr<httplib::Client> client) const;
+  std::unique_ptr<httplib::Client> connect() const;
+
+  std::string _root;
+  TransportOptions _options;
+  std::string _token;
+  mutable std::mutex _mutex;
+  mutable std::condition_variable _cv;
+  mutable std::vector<std::unique_ptr<httplib::Client>> _idle;
+  mutable unsigned _open = 0u;
 };
 
-Http::Http(const std::string& root) : _cli(root.c_str()) {
-  _cli.set_default_headers({{"Accept-Charset", "utf-8"},
-                            {"Accept", "application/json"},
-                            {"User-Agent", "touca-client-cpp/1.6.0"}});
+Http::Http(const std::string& root, const TransportOptions& options)
+    : _root(root), _options(options) {
+  if (_options.max_inflight == 0u) {
+    _options.max_inflight = 1u;
+  }
+}
+
+std::unique_ptr<httplib::Client> Http::connect() const {
+  std::unique_ptr<httplib::Client> client(new httplib::Client(_root.c_str()));
+  client->set_default_headers({{"Accept-Charset", "utf-8"},
+                               {"Accept", "application/json"},
+                               {"User-Agent", "touca-client-cpp/1.6.0"}});
+  client->set_keep_alive(true);
+  client->set_connection_timeout(_options.connect_timeout, 0);
+  client->set_read_timeout(_options.read_timeout, 0);
+  client->set_write_timeout(_options.read_timeout, 0);
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-  _cli.enable_server_certificate_verification(false);
+  client->enable_server_certificate_verification(false);
 #endif
+  return client;
+}
+
+Http::Lease Http::acquire() const {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cv.wait(lock, [this] {
+    return !_idle.empty() || _open < _options.max_inflight;
+  });
+  std::unique_ptr<httplib::Client> client;
+  if (!_idle.empty()) {
+    client = std::move(_idle.back());
+    _idle.pop_back();
+  } else {
+    ++_open;
+    lock.unlock();
+    client = connect();
+    lock.lock();
+  }
+  if (!_token.empty()) {
+    client->set_bearer_token_auth(_token.c_str());
+  }
+  return Lease(*this, std::move(client));
+}
+
+void Http::release(std::unique_ptr<httplib::Client> client) const {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _idle.push_back(std::move(client));
+  }
+  _cv.notify_one();
 }
 
 void Http::set_token(const std::string& token) {
-  _cli.set_bearer_token_auth(token.c_str());
+  std::lock_guard<std::mutex> lock(_mutex);
+  _token = token;
+}
+
+static HttpHeaders to_headers(const httplib::Headers& headers) {
+  HttpHeaders out;
+  for (const auto& kvp : headers) {
+    auto name = kvp.first;
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char ch) { return std::tolower(ch); });
+    out.emplace(name, kvp.second);
+  }
+  return out;
 }
 
-Response Http::get(const std::string& route) const {
-  const auto& result = _cli.Get(route.c_str());
+Response Http::get(const std::string& route,
+                   const HttpHeaders& headers) const {
+  const auto& result = acquire()->Get(
+      route.c_str(), httplib::Headers(headers.begin(), headers.end()));
   if (!result) {
     return {-1, touca::detail::format("failed to submit HTTP GET request to {}",
                                       route)};
   }
-  return {result->status, result->body};
+  return {result->status, result->body, to_headers(result->headers)};
 }
 
 Response Http::patch(const std::string& route, const std::string& body) const {
-  const auto& result = _cli.Patch(route.c_str(), body, "application/json");
+  const auto& result =
+      acquire()->Patch(route.c_str(), body, "application/json");
   if (!result) {
     return {-1, touca::detail::format(
                     "failed to submit HTTP PATCH request to {}", route)};
@@ -56,7 +163,7 @@ Response Http::patch(const std::string& route, const std::string& body) const {
 }
 
 Response Http::post(const std::string& route, const std::string& body) const {
-  const auto& result = _cli.Post(route.c_str(), body, "application/json");
+  const auto& result = acquire()->Post(route.c_str(), body, "application/json");
   if (!result) {
     return {-1, touca::detail::format(
                     "failed to submit HTTP POST request to {}", route)};
@@ -64,15 +171,19 @@ Response Http::post(const std::string& route, const std::string& body) const {
   return {result->status, result->body};
 }
 
-Response Http::binary(const std::string& route,
-                      const std::string& content) const {
-  const auto& result =
-      _cli.Post(route.c_str(), content, "application/octet-stream");
+Response Http::binary(const std::string& route, const std::string& content,
+                      const std::string& idempotency_key) const {
+  httplib::Headers headers;
+  if (!idempotency_key.empty()) {
+    headers.emplace("Idempotency-Key", idempotency_key);
+  }
+  const auto& result = acquire()->Post(route.c_str(), headers, content,
+                                       "application/octet-stream");
   if (!result) {
     return {-1, touca::detail::format(
                     "failed to submit HTTP POST request to {}", route)};
   }
-  return {result->status, result->body};
+  return {result->status, result->body, to_headers(result->headers)};
 }
 
 ApiUrl::ApiUrl(const std::string& url) {
@@ -162,7 +273,26 @@ bool ApiUrl::confirm(const std::string& team, const std::string& suite,
   return true;
 }
 
-Platform::Platform(const ApiUrl& api) : _api(api), _http(new Http(api.root())) {
+Platform::Platform(const ApiUrl& api, const TransportOptions& options)
+    : _api(api),
+      _http(new Http(api.root(), options)),
+      _session(std::make_shared<Session>()) {
+  if (!_api._error.empty()) {
+    _error = _api._error;
+  }
+}
+
+Platform::Platform(const ApiUrl& api, std::unique_ptr<Transport> transport)
+    : _api(api),
+      _http(std::move(transport)),
+      _session(std::make_shared<Session>()) {
+  if (!_api._error.empty()) {
+    _error = _api._error;
+  }
+}
+
+Platform::Platform(const ApiUrl& api, const Platform& session)
+    : _api(api), _http(session._http), _session(session._session) {
   if (!_api._error.empty()) {
     _error = _api._error;
   }
@@ -213,8 +343,7 @@ bool Platform::handshake() const {
  * Submit authentication request. If the server accepts this request,
  * parse the response to extract the API Token issued by the server.
  */
-bool Platform::auth(const std::string& apiKey) {
-  _error.clear();
+bool Platform::sign_in(const std::string& apiKey, std::string& token) const {
   const auto content = touca::detail::format("{{\"key\": \"{}\"}}", apiKey);
   const auto response = _http->post(_api.route("/client/signin"), content);
   if (response.status == -1) {
@@ -235,20 +364,126 @@ bool Platform::auth(const std::string& apiKey) {
     _error = "unexpected server response";
     return false;
   }
-  _http->set_token(parsed["token"].GetString());
-  _is_auth = true;
+  token = parsed["token"].GetString();
   return true;
 }
 
-std::vector<std::string> Platform::elements() const {
+bool Platform::auth(const std::string& apiKey) {
   _error.clear();
+  std::string token;
+  if (!sign_in(apiKey, token)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(_session->mutex);
+  _http->set_token(token);
+  _session->api_key = apiKey;
+  ++_session->generation;
+  _session->valid = true;
+  return true;
+}
+
+bool Platform::renew_token(const std::uint64_t generation) const {
+  std::lock_guard<std::mutex> lock(_session->mutex);
+  if (_session->generation != generation) {
+    return true;
+  }
+  _session->valid = false;
+  std::string token;
+  if (_session->api_key.empty() || !sign_in(_session->api_key, token)) {
+    return false;
+  }
+  _http->set_token(token);
+  ++_session->generation;
+  _session->valid = true;
+  return true;
+}
+
+/**
+ * Reads the list of testcases and its entity tag from the given cache
+ * file. The cache is ignored if it is missing or cannot be parsed.
+ */
+static bool read_elements_cache(const std::string& path, std::string& etag,
+                                std::vector<std::string>& elements) {
+  std::string content;
+  try {
+    content = touca::detail::load_string_file(path);
+  } catch (const std::exception&) {
+    return false;
+  }
+  rapidjson::Document parsed;
+  if (parsed.Parse<0>(content.c_str()).HasParseError() ||
+      !parsed.IsObject() || !parsed.HasMember("etag") ||
+      !parsed["etag"].IsString() || !parsed.HasMember("elements") ||
+      !parsed["elements"].IsArray()) {
+    return false;
+  }
+  std::vector<std::string> out;
+  for (const auto& rjElement : parsed["elements"].GetArray()) {
+    if (!rjElement.IsString()) {
+      return false;
+    }
+    out.emplace_back(rjElement.GetString());
+  }
+  etag = parsed["etag"].GetString();
+  elements = std::move(out);
+  return true;
+}
+
+static void write_elements_cache(const std::string& path,
+                                 const std::string& etag,
+                                 const std::vector<std::string>& elements) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("etag");
+  writer.String(etag.c_str(), etag.size());
+  writer.Key("elements");
+  writer.StartArray();
+  for (const auto& element : elements) {
+    writer.String(element.c_str(), element.size());
+  }
+  writer.EndArray();
+  writer.EndObject();
+  // the cache is only a shortcut, so failing to write it is not an error.
+  std::error_code ec;
+  const auto& tmp_path = path + ".tmp";
+  touca::filesystem::create_directories(
+      touca::filesystem::path(path).parent_path(), ec);
+  std::ofstream ofs(tmp_path, std::ios::trunc);
+  ofs << buffer.GetString();
+  ofs.close();
+  if (ofs) {
+    touca::filesystem::rename(tmp_path, path, ec);
+  }
+}
+
+std::vector<std::string> Platform::elements(
+    const std::string& cache_path) const {
+  _error.clear();
+  std::string etag;
+  std::vector<std::string> elements;
+  HttpHeaders headers;
+  if (!cache_path.empty() &&
+      read_elements_cache(cache_path, etag, elements)) {
+    headers.emplace("If-None-Match", etag);
+  }
   const auto& route =
       touca::detail::format("/client/element/{}/{}", _api._team, _api._suite);
-  const auto& response = _http->get(_api.route(route));
+  const auto generation = _session->generation.load();
+  const auto& first = _http->get(_api.route(route), headers);
+  const auto& response = first.status == 401 && renew_token(generation)
+                             ? _http->get(_api.route(route), headers)
+                             : first;
   if (response.status == -1) {
     _error = response.body;
     return {};
   }
+  if (response.status == 304 && !headers.empty()) {
+    if (elements.empty()) {
+      _error = "suite has no test case";
+    }
+    return elements;
+  }
   if (response.status != 200) {
     _error = "unexpected server response";
     return {};
@@ -262,27 +497,123 @@ std::vector<std::string> Platform::elements() const {
     _error = "unexpected server response";
     return {};
   }
-  std::vector<std::string> elements;
+  elements.clear();
   for (const auto& rjElement : parsed.GetArray()) {
     elements.emplace_back(rjElement["name"].GetString());
   }
   if (elements.empty()) {
     _error = "suite has no test case";
   }
+  const auto& new_etag = response.header("etag");
+  if (!cache_path.empty() && !new_etag.empty()) {
+    write_elements_cache(cache_path, new_etag, elements);
+  }
   return elements;
 }
 
+static std::mt19937_64& random_engine() {
+  static thread_local std::mt19937_64 engine(std::random_device{}());
+  return engine;
+}
+
+/**
+ * Generates a random version 4 UUID that identifies one submission across
+ * all of its attempts.
+ */
+static std::string make_idempotency_key() {
+  std::uniform_int_distribution<std::uint64_t> dist;
+  auto high = dist(random_engine());
+  auto low = dist(random_engine());
+  high = (high & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+  low = (low & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+  return touca::detail::format("{:08x}-{:04x}-{:04x}-{:04x}-{:012x}",
+                               high >> 32, (high >> 16) & 0xFFFFU,
+                               high & 0xFFFFU, low >> 48,
+                               low & 0xFFFFFFFFFFFFULL);
+}
+
+/**
+ * Checks whether a failed submission may succeed if attempted again.
+ * Requests that the server rejected for reasons other than load are not
+ * retried since they are bound to fail the same way.
+ */
+static bool is_transient(const int status) {
+  return status == -1 || status == 429 || status >= 500;
+}
+
+/**
+ * Computes how long to wait before the given retry. The delay is drawn
+ * between half and all of the exponentially growing backoff, unless the
+ * server asked for a longer delay in seconds through `Retry-After`, which
+ * is honored up to `max_retry_after` seconds.
+ */
+static std::chrono::milliseconds retry_delay(const RetryPolicy& policy,
+                                             const unsigned retry,
+                                             const std::string& retry_after) {
+  std::uint64_t backoff = policy.base_delay;
+  for (auto i = 0u; i < retry && backoff < policy.max_delay; ++i) {
+    backoff *= 2u;
+  }
+  backoff = std::min<std::uint64_t>(backoff, policy.max_delay);
+  std::uniform_int_distribution<std::uint64_t> dist(backoff / 2u, backoff);
+  auto delay = dist(random_engine());
+  if (!retry_after.empty() &&
+      retry_after.find_first_not_of("0123456789") == std::string::npos) {
+    // values too long to parse are as good as the largest permitted one.
+    const auto seconds =
+        retry_after.size() < 10u
+            ? std::min<std::uint64_t>(
+                  std::strtoull(retry_after.c_str(), nullptr, 10),
+                  policy.max_retry_after)
+            : policy.max_retry_after;
+    delay = std::max<std::uint64_t>(delay, seconds * 1000u);
+  }
+  return std::chrono::milliseconds(delay);
+}
+
 std::vector<std::string> Platform::submit(const std::string& content,
-                                          const unsigned max_retries) const {
+                                          const RetryPolicy& policy,
+                                          const std::string& key,
+                                          bool* rejected) const {
   std::vector<std::string> errors;
-  for (auto i = 0UL; i < max_retries; ++i) {
-    const auto response = _http->binary(_api.route("/client/submit"), content);
+  if (rejected) {
+    *rejected = false;
+  }
+  const auto& idempotency_key = key.empty() ? make_idempotency_key() : key;
+  auto attempts = policy.max_retries + 1u;
+  auto renewed = false;
+  for (auto i = 0u; i < attempts; ++i) {
+    const auto generation = _session->generation.load();
+    const auto response =
+        _http->binary(_api.route("/client/submit"), content, idempotency_key);
     if (response.status == 204) {
       return {};
     }
     errors.emplace_back(touca::detail::format(
-        "failed to post testresults for a group of testcases ({}/{})", i + 1,
-        max_retries));
+        "failed to post testresults for a group of testcases ({}/{}): {}",
+        i + 1, attempts,
+        response.status == -1 ? response.body
+                              : std::to_string(response.status)));
+    // the token may have expired or the server may have restarted. unlike
+    // other rejections, this one may be resolved by signing in again.
+    if (response.status == 401) {
+      if (!renewed && renew_token(generation)) {
+        renewed = true;
+        ++attempts;
+        continue;
+      }
+      break;
+    }
+    if (!is_transient(response.status)) {
+      if (rejected) {
+        *rejected = true;
+      }
+      break;
+    }
+    if (i + 1u < attempts) {
+      std::this_thread::sleep_for(
+          retry_delay(policy, i, response.header("retry-after")));
+    }
   }
   errors.emplace_back("giving up on submitting testresults");
   return errors;
@@ -292,7 +623,11 @@ bool Platform::seal() const {
   _error.clear();
   const auto route = fmt::format("/batch/{}/{}/{}/seal2", _api._team,
                                  _api._suite, _api._revision);
-  const auto& response = _http->post(_api.route(route));
+  const auto generation = _session->generation.load();
+  const auto& first = _http->post(_api.route(route));
+  const auto& response = first.status == 401 && renew_token(generation)
+                             ? _http->post(_api.route(route))
+                             : first;
   if (response.status == -1) {
     _error = response.body;
     return false;
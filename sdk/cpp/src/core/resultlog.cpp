@@ -0,0 +1,336 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/resultlog.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/filesystem.hpp"
+#include "touca/impl/schema.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace touca {
+namespace detail {
+
+constexpr char result_log_magic[] = "TOUCALOG";
+constexpr char result_log_index_magic[] = "TOUCAIDX";
+constexpr std::uint32_t result_log_version = 1u;
+constexpr std::uint64_t result_log_header_size = 12u;
+constexpr std::uint64_t result_log_trailer_size = 20u;
+
+static void put_u32(char* out, const std::uint32_t value) {
+  for (auto i = 0u; i < 4u; ++i) {
+    out[i] = static_cast<char>((value >> (8u * i)) & 0xFFu);
+  }
+}
+
+static void put_u64(char* out, const std::uint64_t value) {
+  for (auto i = 0u; i < 8u; ++i) {
+    out[i] = static_cast<char>((value >> (8u * i)) & 0xFFu);
+  }
+}
+
+static std::uint32_t get_u32(const char* in) {
+  std::uint32_t out = 0u;
+  for (auto i = 0u; i < 4u; ++i) {
+    out |= static_cast<std::uint32_t>(static_cast<unsigned char>(in[i]))
+           << (8u * i);
+  }
+  return out;
+}
+
+static std::uint64_t get_u64(const char* in) {
+  std::uint64_t out = 0u;
+  for (auto i = 0u; i < 8u; ++i) {
+    out |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i]))
+           << (8u * i);
+  }
+  return out;
+}
+
+/**
+ * Keeps the most recent entry of each testcase, in order of first
+ * appearance of the testcase.
+ */
+struct IndexBuilder {
+  void add(ResultLog::Entry&& entry) {
+    const auto& it = positions.find(entry.testcase);
+    if (it != positions.end()) {
+      entries[it->second] = std::move(entry);
+      return;
+    }
+    positions.emplace(entry.testcase, entries.size());
+    entries.push_back(std::move(entry));
+  }
+
+  std::vector<ResultLog::Entry> entries;
+  std::unordered_map<std::string, std::size_t> positions;
+};
+
+static const fbs::Message* verify_message(
+    const std::vector<std::uint8_t>& buffer) {
+  flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+  if (!verifier.VerifyBuffer<fbs::Message>()) {
+    return nullptr;
+  }
+  const auto& message = flatbuffers::GetRoot<fbs::Message>(buffer.data());
+  if (!message->metadata() || !message->metadata()->testcase()) {
+    return nullptr;
+  }
+  return message;
+}
+
+/**
+ * Reads the index appended to a properly closed log.
+ *
+ * @return false if the log has no valid trailer or index
+ */
+static bool load_index(std::ifstream& ifs, const std::uint64_t file_size,
+                       IndexBuilder& index, std::uint64_t& records_end) {
+  if (file_size < result_log_header_size + result_log_trailer_size) {
+    return false;
+  }
+  char trailer[result_log_trailer_size];
+  ifs.seekg(static_cast<std::streamoff>(file_size - result_log_trailer_size));
+  if (!ifs.read(trailer, sizeof(trailer)) ||
+      std::memcmp(trailer + 12, result_log_index_magic, 8) != 0) {
+    return false;
+  }
+  const auto index_offset = get_u64(trailer);
+  const auto count = get_u32(trailer + 8);
+  const auto index_end = file_size - result_log_trailer_size;
+  if (index_offset < result_log_header_size || index_end < index_offset) {
+    return false;
+  }
+  std::string content(static_cast<std::size_t>(index_end - index_offset),
+                      '\0');
+  ifs.seekg(static_cast<std::streamoff>(index_offset));
+  if (!ifs.read(&content[0], static_cast<std::streamsize>(content.size()))) {
+    return false;
+  }
+  std::size_t pos = 0u;
+  for (auto i = 0u; i < count; ++i) {
+    if (content.size() - pos < 4u) {
+      return false;
+    }
+    const auto name_size = get_u32(content.data() + pos);
+    pos += 4u;
+    if (content.size() - pos < name_size + 12u) {
+      return false;
+    }
+    ResultLog::Entry entry;
+    entry.testcase = content.substr(pos, name_size);
+    pos += name_size;
+    entry.offset = get_u64(content.data() + pos);
+    entry.size = get_u32(content.data() + pos + 8u);
+    pos += 12u;
+    if (entry.offset + 4u + entry.size > index_offset) {
+      return false;
+    }
+    index.add(std::move(entry));
+  }
+  records_end = index_offset;
+  return pos == content.size();
+}
+
+/**
+ * Rebuilds the index of a log that was not closed properly by reading its
+ * records one by one, until the end of file or the first incomplete or
+ * invalid record.
+ */
+static void scan_records(std::ifstream& ifs, const std::uint64_t file_size,
+                         IndexBuilder& index, std::uint64_t& records_end) {
+  ifs.clear();
+  std::uint64_t offset = result_log_header_size;
+  std::vector<std::uint8_t> buffer;
+  char prefix[4];
+  while (offset + 4u <= file_size) {
+    ifs.seekg(static_cast<std::streamoff>(offset));
+    if (!ifs.read(prefix, sizeof(prefix))) {
+      break;
+    }
+    const auto size = get_u32(prefix);
+    if (offset + 4u + size > file_size) {
+      break;
+    }
+    buffer.resize(size);
+    if (!ifs.read(reinterpret_cast<char*>(buffer.data()), size)) {
+      break;
+    }
+    const auto& message = verify_message(buffer);
+    if (!message) {
+      break;
+    }
+    index.add({message->metadata()->testcase()->str(), offset, size});
+    offset += 4u + size;
+  }
+  records_end = offset;
+}
+
+static void open_index(const std::string& path, IndexBuilder& index,
+                       std::uint64_t& records_end) {
+  std::ifstream ifs(path, std::ios::binary);
+  char header[result_log_header_size];
+  if (!ifs.read(header, sizeof(header)) ||
+      std::memcmp(header, result_log_magic, 8) != 0) {
+    throw std::runtime_error("file is not a result log: " + path);
+  }
+  if (get_u32(header + 8) != result_log_version) {
+    throw std::runtime_error("result log has unsupported version: " + path);
+  }
+  const auto file_size =
+      static_cast<std::uint64_t>(touca::filesystem::file_size(path));
+  if (!load_index(ifs, file_size, index, records_end)) {
+    index = IndexBuilder();
+    scan_records(ifs, file_size, index, records_end);
+  }
+}
+
+}  // namespace detail
+
+ResultLog::ResultLog(const std::string& path) : _path(path) {
+  const auto exists = touca::filesystem::exists(path) &&
+                      touca::filesystem::file_size(path) != 0u;
+  if (exists) {
+    detail::IndexBuilder index;
+    detail::open_index(path, index, _offset);
+    _entries = std::move(index.entries);
+    _positions = std::move(index.positions);
+    // drop the index and any incomplete record so that new records are
+    // appended right after the last complete one.
+    touca::filesystem::resize_file(path, _offset);
+  }
+  _file = std::fopen(path.c_str(), exists ? "ab" : "wb");
+  if (!_file) {
+    throw std::runtime_error("failed to open result log: " + path);
+  }
+  std::setvbuf(_file, nullptr, _IOFBF, 1u << 20);
+  if (!exists) {
+    char header[detail::result_log_header_size];
+    std::memcpy(header, detail::result_log_magic, 8);
+    detail::put_u32(header + 8, detail::result_log_version);
+    write(header, sizeof(header));
+  }
+}
+
+ResultLog::~ResultLog() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+void ResultLog::write(const void* data, const std::size_t size) {
+  if (std::fwrite(data, 1, size, _file) != size) {
+    throw std::runtime_error("failed to write to result log: " + _path);
+  }
+  _offset += size;
+}
+
+void ResultLog::append(const std::string& testcase,
+                       const std::vector<std::uint8_t>& message) {
+  if (!_file) {
+    throw std::logic_error("result log is closed");
+  }
+  const auto size = static_cast<std::uint32_t>(message.size());
+  Entry entry{testcase, _offset, size};
+  char prefix[4];
+  detail::put_u32(prefix, size);
+  write(prefix, sizeof(prefix));
+  write(message.data(), message.size());
+
+  const auto& it = _positions.find(testcase);
+  if (it != _positions.end()) {
+    _entries[it->second] = std::move(entry);
+    return;
+  }
+  _positions.emplace(testcase, _entries.size());
+  _entries.push_back(std::move(entry));
+}
+
+bool ResultLog::contains(const std::string& testcase) const {
+  return _positions.count(testcase);
+}
+
+void ResultLog::close() {
+  if (!_file) {
+    return;
+  }
+  const auto index_offset = _offset;
+  char buffer[12];
+  for (const auto& entry : _entries) {
+    detail::put_u32(buffer, static_cast<std::uint32_t>(entry.testcase.size()));
+    write(buffer, 4u);
+    write(entry.testcase.data(), entry.testcase.size());
+    detail::put_u64(buffer, entry.offset);
+    detail::put_u32(buffer + 8, entry.size);
+    write(buffer, 12u);
+  }
+  char trailer[detail::result_log_trailer_size];
+  detail::put_u64(trailer, index_offset);
+  detail::put_u32(trailer + 8, static_cast<std::uint32_t>(_entries.size()));
+  std::memcpy(trailer + 12, detail::result_log_index_magic, 8);
+  write(trailer, sizeof(trailer));
+
+  auto ok = std::fflush(_file) == 0;
+#ifdef _WIN32
+  ok &= _commit(_fileno(_file)) == 0;
+#else
+  ok &= fsync(fileno(_file)) == 0;
+#endif
+  ok &= std::fclose(_file) == 0;
+  _file = nullptr;
+  if (!ok) {
+    throw std::runtime_error("failed to sync result log: " + _path);
+  }
+}
+
+bool ResultLog::is_result_log(const std::string& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  char magic[8];
+  return ifs.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, detail::result_log_magic, 8) == 0;
+}
+
+std::vector<ResultLog::Entry> ResultLog::read_index(const std::string& path) {
+  detail::IndexBuilder index;
+  std::uint64_t records_end = 0u;
+  detail::open_index(path, index, records_end);
+  return index.entries;
+}
+
+void ResultLog::read(const std::string& path, const Callback& callback) {
+  const auto& entries = read_index(path);
+  std::ifstream ifs(path, std::ios::binary);
+  std::vector<std::uint8_t> buffer;
+  for (const auto& entry : entries) {
+    try {
+      buffer = read_record(ifs, entry);
+    } catch (const std::runtime_error&) {
+      throw std::runtime_error("result log is corrupted: " + path);
+    }
+    callback(entry, buffer);
+  }
+}
+
+std::vector<std::uint8_t> ResultLog::read_record(std::istream& input,
+                                                 const Entry& entry) {
+  std::vector<std::uint8_t> buffer(entry.size);
+  input.clear();
+  input.seekg(static_cast<std::streamoff>(entry.offset + 4u));
+  if (!input.read(reinterpret_cast<char*>(buffer.data()), entry.size) ||
+      !detail::verify_message(buffer)) {
+    throw std::runtime_error("record of testcase \"" + entry.testcase +
+                             "\" is corrupted");
+  }
+  return buffer;
+}
+
+}  // namespace touca
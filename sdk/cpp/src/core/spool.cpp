@@ -0,0 +1,247 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/spool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+#include "touca/core/platform.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace touca {
+namespace detail {
+
+/**
+ * Writes the given content to a new file and flushes it to the storage
+ * device, so that the file is complete before it is renamed.
+ */
+static bool write_durably(const touca::filesystem::path& path,
+                          const std::string& content) {
+  const auto file = std::fopen(path.string().c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  auto ok = std::fwrite(content.data(), 1, content.size(), file) ==
+            content.size();
+  ok &= std::fflush(file) == 0;
+#ifdef _WIN32
+  ok &= _commit(_fileno(file)) == 0;
+#else
+  ok &= fsync(fileno(file)) == 0;
+#endif
+  ok &= std::fclose(file) == 0;
+  return ok;
+}
+
+/**
+ * Flushes the entries of the given directory to the storage device, so
+ * that files renamed into it survive a crash. Directories cannot be
+ * synced on Windows, where renames are journaled by the file system.
+ */
+static bool sync_directory(const touca::filesystem::path& dir) {
+#ifdef _WIN32
+  (void)dir;
+  return true;
+#else
+  const auto fd = open(dir.string().c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  const auto ok = fsync(fd) == 0;
+  close(fd);
+  return ok;
+#endif
+}
+
+}  // namespace detail
+
+Spool::Spool(const touca::filesystem::path& dir) : _dir(dir) {
+  std::error_code ec;
+  touca::filesystem::create_directories(_dir, ec);
+  if (ec) {
+    throw std::runtime_error(touca::detail::format(
+        "failed to create spool directory {}: {}", _dir.string(),
+        ec.message()));
+  }
+  // distinguishes files of processes that share the same spool directory
+  std::random_device device;
+  _prefix = touca::detail::format("{:08x}", device());
+}
+
+void Spool::push(const std::string& content) {
+  std::string name;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    name = touca::detail::format("{:020}-{}-{:06}", now.count(), _prefix,
+                                 _counter++);
+  }
+  const auto& tmp = _dir / (name + ".tmp");
+  // the file is synced before it is renamed, and the directory after, so
+  // that a crash leaves either no submission or a complete one behind.
+  std::error_code ec;
+  if (!detail::write_durably(tmp, content)) {
+    touca::filesystem::remove(tmp, ec);
+    throw std::runtime_error(touca::detail::format(
+        "failed to write submission to spool {}", _dir.string()));
+  }
+  touca::filesystem::rename(tmp, _dir / (name + ".bin"), ec);
+  if (ec || !detail::sync_directory(_dir)) {
+    touca::filesystem::remove(tmp, ec);
+    throw std::runtime_error(touca::detail::format(
+        "failed to write submission to spool {}", _dir.string()));
+  }
+}
+
+std::vector<touca::filesystem::path> Spool::pending() const {
+  std::vector<touca::filesystem::path> paths;
+  std::error_code ec;
+  for (const auto& entry : touca::filesystem::directory_iterator(_dir, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+      paths.push_back(entry.path());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+void Spool::reject(const touca::filesystem::path& path,
+                   std::vector<std::string>& errors,
+                   std::vector<std::string>& rejections) const {
+  const auto& failed_dir = this->failed_dir();
+  std::error_code ec;
+  touca::filesystem::create_directories(failed_dir, ec);
+  touca::filesystem::rename(path, failed_dir / path.filename(), ec);
+  // the file may have been moved by another process meanwhile
+  if (ec && touca::filesystem::exists(path)) {
+    errors.emplace_back(touca::detail::format(
+        "failed to move rejected submission {} to {}: {}", path.string(),
+        failed_dir.string(), ec.message()));
+    return;
+  }
+  rejections.emplace_back(touca::detail::format(
+      "moved rejected submission {} to {}", path.filename().string(),
+      failed_dir.string()));
+}
+
+std::size_t Spool::replay(const Platform& platform,
+                          std::vector<std::string>& errors,
+                          std::vector<std::string>& rejections) const {
+  auto count = 0u;
+  for (const auto& path : pending()) {
+    std::string content;
+    try {
+      content = touca::detail::load_string_file(
+          path.string(), std::ios::in | std::ios::binary);
+    } catch (const std::exception& ex) {
+      // the file may have been replayed by another process meanwhile
+      if (!touca::filesystem::exists(path)) {
+        continue;
+      }
+      rejections.emplace_back(touca::detail::format(
+          "failed to read spooled submission {}: {}", path.string(),
+          ex.what()));
+      reject(path, errors, rejections);
+      continue;
+    }
+    // the name of the file identifies the submission, so that replaying
+    // it more than once does not duplicate its results on the server.
+    auto rejected = false;
+    const auto& failures = platform.submit(content, RetryPolicy(),
+                                           path.stem().string(), &rejected);
+    if (failures.empty()) {
+      std::error_code ec;
+      touca::filesystem::remove(path, ec);
+      ++count;
+      continue;
+    }
+    // submissions that the server rejected are bound to be rejected again
+    // and would otherwise keep newer submissions from being replayed.
+    if (rejected) {
+      rejections.insert(rejections.end(), failures.begin(), failures.end());
+      reject(path, errors, rejections);
+      continue;
+    }
+    errors.insert(errors.end(), failures.begin(), failures.end());
+    errors.emplace_back(touca::detail::format(
+        "left {} submissions in spool {}", pending().size(), _dir.string()));
+    return count;
+  }
+  return count;
+}
+
+SpoolSubmitter::SpoolSubmitter(const Platform& platform, const Spool& spool)
+    : _platform(platform), _spool(spool) {
+  _thread = std::thread(&SpoolSubmitter::run, this);
+}
+
+SpoolSubmitter::~SpoolSubmitter() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+}
+
+void SpoolSubmitter::notify() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_requested;
+  }
+  _cv.notify_one();
+}
+
+std::vector<std::string> SpoolSubmitter::flush(
+    std::vector<std::string>* rejections) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  const auto target = ++_requested;
+  _cv.notify_one();
+  _cv_completed.wait(lock, [this, target] { return _completed >= target; });
+  if (rejections) {
+    rejections->swap(_rejections);
+  }
+  _rejections.clear();
+  return _errors;
+}
+
+void SpoolSubmitter::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _cv.wait(lock, [this] { return _stopping || _completed < _requested; });
+    if (_stopping) {
+      break;
+    }
+    // requests made while replaying are served by the next replay, since
+    // they may have spooled submissions that this replay does not see.
+    const auto target = _requested;
+    lock.unlock();
+    std::vector<std::string> errors;
+    std::vector<std::string> rejections;
+    _spool.replay(_platform, errors, rejections);
+    lock.lock();
+    _errors = std::move(errors);
+    // submissions set aside by background replays are reported by the
+    // next flush.
+    _rejections.insert(_rejections.end(), rejections.begin(),
+                       rejections.end());
+    _completed = target;
+    _cv_completed.notify_all();
+  }
+  // let callers of `flush` know that no replay is coming
+  _completed = _requested;
+  _errors = {"submitter was stopped before the spool was replayed"};
+  _cv_completed.notify_all();
+}
+
+}  // namespace touca
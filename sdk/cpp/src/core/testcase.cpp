@@ -2,16 +2,148 @@
 
 #include "touca/core/testcase.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <system_error>
+
 #include "flatbuffers/flatbuffers.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
 #include "touca/core/types.hpp"
 #include "touca/impl/schema.hpp"
 
 namespace touca {
+namespace detail {
+
+/**
+ * Spill files are sequences of flatbuffers `Message` buffers, each prefixed
+ * with its size as a four-byte little-endian integer.
+ */
+static void append_spill_chunk(const std::string& path,
+                               const flatbuffers::FlatBufferBuilder& builder) {
+  const auto size = static_cast<std::uint32_t>(builder.GetSize());
+  const char prefix[4] = {
+      static_cast<char>(size & 0xFF), static_cast<char>((size >> 8) & 0xFF),
+      static_cast<char>((size >> 16) & 0xFF),
+      static_cast<char>((size >> 24) & 0xFF)};
+  std::ofstream ofs(path, std::ios::binary | std::ios::app);
+  ofs.write(prefix, sizeof(prefix));
+  ofs.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), size);
+  if (!ofs) {
+    throw std::runtime_error("failed to write to spill file");
+  }
+}
+
+static void read_spill_file(
+    const std::string& path,
+    const std::function<void(const fbs::Message&)>& callback) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    throw std::runtime_error("failed to open spill file");
+  }
+  std::vector<std::uint8_t> buffer;
+  unsigned char prefix[4];
+  while (ifs.read(reinterpret_cast<char*>(prefix), sizeof(prefix))) {
+    const auto size = static_cast<std::uint32_t>(prefix[0]) |
+                      static_cast<std::uint32_t>(prefix[1]) << 8 |
+                      static_cast<std::uint32_t>(prefix[2]) << 16 |
+                      static_cast<std::uint32_t>(prefix[3]) << 24;
+    buffer.resize(size);
+    if (!ifs.read(reinterpret_cast<char*>(buffer.data()), size)) {
+      throw std::runtime_error("spill file is truncated");
+    }
+    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    if (!verifier.VerifyBuffer<fbs::Message>()) {
+      throw std::runtime_error("spill file is corrupted");
+    }
+    callback(*flatbuffers::GetRoot<fbs::Message>(buffer.data()));
+  }
+}
+
+static ResultCategory to_category(const fbs::ResultType type) {
+  return type == fbs::ResultType::Assert ? ResultCategory::Assert
+                                         : ResultCategory::Check;
+}
+
+static fbs::ResultType to_result_type(const ResultCategory category) {
+  return category == ResultCategory::Assert ? fbs::ResultType::Assert
+                                            : fbs::ResultType::Check;
+}
+
+static bool is_spillable(const internal_type type) {
+  return type == internal_type::array || type == internal_type::object ||
+         type == internal_type::string;
+}
+
+/**
+ * Serializes results spilled to disk together with those still in memory
+ * without materializing the spilled values all at once. Elements of arrays
+ * that were spilled in multiple chunks are concatenated in capture order.
+ * For other keys, the first captured value wins.
+ */
+static std::vector<flatbuffers::Offset<fbs::Result>> stitch_results(
+    flatbuffers::FlatBufferBuilder& builder, const std::string& spill_path,
+    const ResultsMap& results) {
+  struct StitchedEntry {
+    ResultCategory typ;
+    bool is_array;
+    flatbuffers::Offset<fbs::TypeWrapper> value;
+    std::vector<flatbuffers::Offset<fbs::TypeWrapper>> elements;
+  };
+  std::map<std::string, StitchedEntry> entries;
+  const auto& add = [&builder, &entries](const std::string& key,
+                                         const ResultCategory typ,
+                                         const data_point& value) {
+    const auto is_array = value.type() == internal_type::array;
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+      it = entries.emplace(key, StitchedEntry{typ, is_array}).first;
+      if (!is_array) {
+        it->second.value = value.serialize(builder);
+        return;
+      }
+    } else if (!it->second.is_array || !is_array) {
+      return;
+    }
+    for (const auto& element : *value.as_array()) {
+      it->second.elements.push_back(element.serialize(builder));
+    }
+  };
+
+  read_spill_file(spill_path, [&add](const fbs::Message& message) {
+    for (const auto&& result : *message.results()->entries()) {
+      add(result->key()->str(), to_category(result->typ()),
+          deserialize_value(result->value()));
+    }
+  });
+  for (const auto& result : results) {
+    add(result.first, result.second.typ, result.second.val);
+  }
+
+  std::vector<flatbuffers::Offset<fbs::Result>> out;
+  out.reserve(entries.size());
+  for (auto& entry : entries) {
+    auto value = entry.second.value;
+    if (entry.second.is_array) {
+      const auto& fbsArray =
+          fbs::CreateArrayDirect(builder, &entry.second.elements);
+      value = fbs::CreateTypeWrapper(builder, fbs::Type::Array,
+                                     fbsArray.Union());
+    }
+    out.push_back(fbs::CreateResultDirect(builder, entry.first.c_str(), value,
+                                          to_result_type(entry.second.typ)));
+  }
+  return out;
+}
+
+}  // namespace detail
 
 Testcase::Testcase(const std::string& teamslug, const std::string& testsuite,
                    const std::string& version, const std::string& name)
@@ -40,16 +172,171 @@ Testcase::Testcase(const std::string& teamslug, const std::string& testsuite,
 
 Testcase::Testcase(
     const Metadata& meta, const ResultsMap& results,
-    const std::unordered_map<std::string, detail::number_unsigned_t>& metrics)
-    : _posted(true), _metadata(meta), _resultsMap(results) {
+    const std::unordered_map<std::string, detail::number_unsigned_t>& metrics,
+    const std::unordered_map<std::string, MetricSummary>& summaries,
+    const ProfileMap& profile,
+    const std::unordered_map<std::string, detail::number_unsigned_t>& counters)
+    : _posted(true), _metadata(meta), _resultsMap(results), _profile(profile) {
+  for (const auto& summary : summaries) {
+    _summariesMap.emplace(summary.first, summary.second);
+  }
+  for (const auto& counter : counters) {
+    _countersMap.emplace(counter.first, counter.second);
+  }
+  _timersMap.reserve(metrics.size());
   for (const auto& metric : metrics) {
     namespace chr = std::chrono;
     const auto& tic = chr::system_clock::time_point(chr::milliseconds(0));
     const auto& toc =
         chr::system_clock::time_point(chr::milliseconds(metric.second));
-    _tics.emplace(metric.first, tic);
-    _tocs.emplace(metric.first, toc);
+    _timersMap.emplace(metric.first, TimerEntry{tic, toc, true});
+  }
+}
+
+static double interpolate(const std::vector<double>& sorted,
+                          const double fraction) {
+  const auto pos = fraction * static_cast<double>(sorted.size() - 1u);
+  const auto lower = static_cast<std::size_t>(std::floor(pos));
+  const auto upper = std::min(lower + 1u, sorted.size() - 1u);
+  return sorted[lower] + (pos - lower) * (sorted[upper] - sorted[lower]);
+}
+
+MetricSummary MetricSummary::from_samples(std::vector<double> samples) {
+  MetricSummary out;
+  if (samples.empty()) {
+    return out;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto count = static_cast<double>(samples.size());
+  out.count = static_cast<std::uint32_t>(samples.size());
+  out.min = samples.front();
+  out.median = interpolate(samples, 0.5);
+  out.p90 = interpolate(samples, 0.9);
+  out.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+  if (samples.size() > 1u) {
+    auto sum = 0.0;
+    for (const auto sample : samples) {
+      sum += (sample - out.mean) * (sample - out.mean);
+    }
+    out.stddev = std::sqrt(sum / (count - 1.0));
+  }
+  return out;
+}
+
+bool MetricSummary::from_data_point(const data_point& value,
+                                    MetricSummary& out) {
+  if (value.type() != detail::internal_type::object) {
+    return false;
+  }
+  const auto& members = *value.as_object();
+  const auto& number = [&members](const std::string& key, double& field) {
+    const auto& it = members.find(key);
+    if (it == members.end() ||
+        it->second.type() != detail::internal_type::number_double) {
+      return false;
+    }
+    field = it->second.as_number_double();
+    return true;
+  };
+  const auto& it = members.find("count");
+  if (it == members.end() ||
+      it->second.type() != detail::internal_type::number_unsigned) {
+    return false;
+  }
+  out.count = static_cast<std::uint32_t>(it->second.as_number_unsigned());
+  return number("min", out.min) && number("median", out.median) &&
+         number("mean", out.mean) && number("p90", out.p90) &&
+         number("stddev", out.stddev);
+}
+
+data_point MetricSummary::to_data_point() const {
+  return object("MetricSummary")
+      .add("count", data_point::number_unsigned(count))
+      .add("min", data_point::number_double(min))
+      .add("median", data_point::number_double(median))
+      .add("mean", data_point::number_double(mean))
+      .add("p90", data_point::number_double(p90))
+      .add("stddev", data_point::number_double(stddev));
+}
+
+constexpr char profile_metric_key[] = "__profile__";
+
+/**
+ * Builds the tree of scopes nested directly in the scope with the given
+ * call path, or of outermost scopes if the path is empty.
+ */
+static data_point profile_children(const ProfileMap& profile,
+                                   const std::string& path) {
+  const auto& prefix = path.empty() ? path : path + ';';
+  object out("CallTree");
+  for (auto it = profile.lower_bound(prefix);
+       it != profile.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it) {
+    const auto& name = it->first.substr(prefix.size());
+    if (name.find(';') != std::string::npos) {
+      continue;
+    }
+    out.add(name, data_point(object("CallNode")
+                                 .add("calls", data_point::number_unsigned(
+                                                   it->second.calls))
+                                 .add("total", data_point::number_unsigned(
+                                                   it->second.total))
+                                 .add("self", data_point::number_unsigned(
+                                                  it->second.self))
+                                 .add("children",
+                                      profile_children(profile, it->first))));
+  }
+  return out;
+}
+
+data_point profile_to_data_point(const ProfileMap& profile) {
+  return profile_children(profile, "");
+}
+
+static bool parse_profile_children(const data_point& value,
+                                   const std::string& path, ProfileMap& out) {
+  if (value.type() != detail::internal_type::object) {
+    return false;
   }
+  for (const auto& member : *value.as_object()) {
+    if (member.second.type() != detail::internal_type::object) {
+      return false;
+    }
+    const auto& node = *member.second.as_object();
+    ProfileEntry entry;
+    for (const auto& field : {std::make_pair("calls", &entry.calls),
+                              std::make_pair("total", &entry.total),
+                              std::make_pair("self", &entry.self)}) {
+      const auto& it = node.find(field.first);
+      if (it == node.end() ||
+          it->second.type() != detail::internal_type::number_unsigned) {
+        return false;
+      }
+      *field.second = it->second.as_number_unsigned();
+    }
+    const auto& children = node.find("children");
+    const auto& key = path.empty() ? member.first : path + ';' + member.first;
+    if (children == node.end() ||
+        !parse_profile_children(children->second, key, out)) {
+      return false;
+    }
+    out.emplace(key, entry);
+  }
+  return true;
+}
+
+bool profile_from_data_point(const data_point& value, ProfileMap& out) {
+  ProfileMap profile;
+  if (!parse_profile_children(value, "", profile) || profile.empty()) {
+    return false;
+  }
+  out = std::move(profile);
+  return true;
+}
+
+std::int64_t TimerEntry::duration() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(toc - tic)
+      .count();
 }
 
 rapidjson::Value Testcase::Overview::json(
@@ -82,50 +369,79 @@ rapidjson::Value Testcase::Metadata::json(
 }
 
 void Testcase::tic(const std::string& key) {
-  _tics.emplace(key, std::chrono::system_clock::now());
+  const auto& now = std::chrono::system_clock::now();
+  _timersMap.emplace(key, TimerEntry{now, now, false});
   _posted = false;
 }
 
 void Testcase::toc(const std::string& key) {
-  if (!_tics.count(key)) {
+  const auto& it = _timersMap.find(key);
+  if (it == _timersMap.end()) {
     throw std::invalid_argument("timer was never started for given key");
   }
-  _tocs[key] = std::chrono::system_clock::now();
+  it->second.toc = std::chrono::system_clock::now();
+  it->second.stopped = true;
   _posted = false;
 }
 
 void Testcase::check(const std::string& key, const data_point& value) {
-  _resultsMap.emplace(key, ResultEntry{value, ResultCategory::Check});
-  _posted = false;
+  add_result(key, ResultEntry{value, ResultCategory::Check});
 }
 
 void Testcase::assume(const std::string& key, const data_point& value) {
-  _resultsMap.emplace(key, ResultEntry{value, ResultCategory::Assert});
+  add_result(key, ResultEntry{value, ResultCategory::Assert});
+}
+
+void Testcase::add_result(const std::string& key, const ResultEntry& entry) {
   _posted = false;
+  if (is_spilled(key) || !_resultsMap.emplace(key, entry).second) {
+    return;
+  }
+  set_memory_usage(_memoryUsage + key.size() + entry.val.memory_usage());
+  enforce_memory_budget();
 }
 
 void Testcase::add_array_element(const std::string& key,
                                  const data_point& value) {
-  if (!_resultsMap.count(key)) {
+  const auto& it = _resultsMap.find(key);
+  if (it == _resultsMap.end()) {
+    // arrays that were spilled to disk continue in memory and are
+    // concatenated with their spilled elements upon serialization.
+    const auto& spilled = _spilledKeys.find(key);
+    if (spilled != _spilledKeys.end() &&
+        spilled->second.type != detail::internal_type::array) {
+      throw std::invalid_argument("specified key has a different type");
+    }
     _resultsMap.emplace(key,
                         ResultEntry{array().add(value), ResultCategory::Check});
+    set_memory_usage(_memoryUsage + key.size() + sizeof(data_point) +
+                     sizeof(array) + value.memory_usage());
+    enforce_memory_budget();
     return;
   }
-  auto& ivalue = _resultsMap.at(key);
+  auto& ivalue = it->second;
   if (ivalue.val.type() != detail::internal_type::array) {
     throw std::invalid_argument("specified key has a different type");
   }
   ivalue.val.as_array()->push_back(value);
+  set_memory_usage(_memoryUsage + value.memory_usage());
   _posted = false;
+  enforce_memory_budget();
 }
 
 void Testcase::add_hit_count(const std::string& key) {
-  if (!_resultsMap.count(key)) {
+  const auto& it = _resultsMap.find(key);
+  if (it == _resultsMap.end()) {
+    if (is_spilled(key)) {
+      throw std::invalid_argument("specified key has a different type");
+    }
     _resultsMap.emplace(key, ResultEntry{data_point::number_unsigned(1U),
                                          ResultCategory::Check});
+    set_memory_usage(_memoryUsage + key.size() + sizeof(data_point));
+    enforce_memory_budget();
     return;
   }
-  auto& ivalue = _resultsMap.at(key);
+  auto& ivalue = it->second;
   if (ivalue.val.type() != detail::internal_type::number_unsigned) {
     throw std::invalid_argument("specified key has a different type");
   }
@@ -137,23 +453,58 @@ void Testcase::add_metric(const std::string& key, const unsigned duration) {
   namespace chr = std::chrono;
   const auto& tic = chr::system_clock::time_point(chr::milliseconds(0));
   const auto& toc = chr::system_clock::time_point(chr::milliseconds(duration));
-  _tics.emplace(key, tic);
-  _tocs.emplace(key, toc);
+  _timersMap.emplace(key, TimerEntry{tic, toc, true});
+  _posted = false;
+}
+
+void Testcase::add_metric_summary(const std::string& key,
+                                  const MetricSummary& summary) {
+  const auto& inserted = _summariesMap.emplace(key, summary);
+  if (!inserted.second) {
+    inserted.first->second = summary;
+  }
+  _posted = false;
+}
+
+void Testcase::add_counter(const std::string& key,
+                           const detail::number_unsigned_t count) {
+  const auto& inserted = _countersMap.emplace(key, count);
+  if (!inserted.second) {
+    inserted.first->second += count;
+  }
+  _posted = false;
+}
+
+void Testcase::add_profile_sample(const std::string& path,
+                                  const std::uint64_t total,
+                                  const std::uint64_t self) {
+  auto& entry = _profile[path];
+  entry.calls++;
+  entry.total += total;
+  entry.self += self;
   _posted = false;
 }
 
 MetricsMap Testcase::metrics() const {
   MetricsMap metrics;
-  for (const auto& tic : _tics) {
-    if (!_tocs.count(tic.first)) {
+  for (const auto& timer : _timersMap) {
+    if (!timer.second.stopped || _summariesMap.count(timer.first)) {
       continue;
     }
-    const auto& key = tic.first;
-    const auto& diff = _tocs.at(key) - _tics.at(key);
-    const auto& duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(diff);
-    metrics.emplace(
-        key, MetricsMapValue{data_point::number_signed(duration.count())});
+    metrics.emplace(timer.first, MetricsMapValue{data_point::number_signed(
+                                     timer.second.duration())});
+  }
+  for (const auto& summary : _summariesMap) {
+    metrics.emplace(summary.first,
+                    MetricsMapValue{summary.second.to_data_point()});
+  }
+  for (const auto& counter : _countersMap) {
+    metrics.emplace(counter.first, MetricsMapValue{data_point::number_unsigned(
+                                       counter.second)});
+  }
+  if (!_profile.empty()) {
+    metrics.emplace(profile_metric_key,
+                    MetricsMapValue{profile_to_data_point(_profile)});
   }
   return metrics;
 }
@@ -163,35 +514,61 @@ rapidjson::Value Testcase::json(
   rapidjson::Value out(rapidjson::kObjectType);
   out.AddMember("metadata", _metadata.json(allocator), allocator);
 
+  // entries are sorted once and partitioned by category in a single pass
+
+  ResultsMap stitched;
+  if (!_spilledKeys.empty()) {
+    stitched = stitched_results();
+  }
+  const auto& results = _spilledKeys.empty() ? _resultsMap : stitched;
+
   rapidjson::Value rjResults(rapidjson::kArrayType);
-  for (const auto& entry : _resultsMap) {
-    if (entry.second.typ != ResultCategory::Check) {
-      continue;
-    }
+  rapidjson::Value rjAssertions(rapidjson::kArrayType);
+  for (const auto& entry : results.sorted()) {
     rapidjson::Value rjEntry(rapidjson::kObjectType);
-    rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.val.to_string(), allocator);
-    rjResults.PushBack(rjEntry, allocator);
+    rjEntry.AddMember("key", entry->first, allocator);
+    rjEntry.AddMember("value", entry->second.val.to_string(), allocator);
+    auto& rjArray = entry->second.typ == ResultCategory::Assert ? rjAssertions
+                                                                : rjResults;
+    rjArray.PushBack(rjEntry, allocator);
   }
   out.AddMember("results", rjResults, allocator);
+  out.AddMember("assertion", rjAssertions, allocator);
 
-  rapidjson::Value rjAssertions(rapidjson::kArrayType);
-  for (const auto& entry : _resultsMap) {
-    if (entry.second.typ != ResultCategory::Assert) {
+  rapidjson::Value rjMetrics(rapidjson::kArrayType);
+  for (const auto& entry : _timersMap.sorted()) {
+    if (!entry->second.stopped || _summariesMap.count(entry->first)) {
       continue;
     }
     rapidjson::Value rjEntry(rapidjson::kObjectType);
-    rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.val.to_string(), allocator);
-    rjAssertions.PushBack(rjEntry, allocator);
+    rjEntry.AddMember("key", entry->first, allocator);
+    rjEntry.AddMember(
+        "value",
+        data_point::number_signed(entry->second.duration()).to_string(),
+        allocator);
+    rjMetrics.PushBack(rjEntry, allocator);
   }
-  out.AddMember("assertion", rjAssertions, allocator);
-
-  rapidjson::Value rjMetrics(rapidjson::kArrayType);
-  for (const auto& entry : metrics()) {
+  for (const auto& entry : _summariesMap.sorted()) {
+    rapidjson::Value rjEntry(rapidjson::kObjectType);
+    rjEntry.AddMember("key", entry->first, allocator);
+    rjEntry.AddMember("value", entry->second.to_data_point().to_string(),
+                      allocator);
+    rjMetrics.PushBack(rjEntry, allocator);
+  }
+  for (const auto& entry : _countersMap.sorted()) {
     rapidjson::Value rjEntry(rapidjson::kObjectType);
-    rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.value.to_string(), allocator);
+    rjEntry.AddMember("key", entry->first, allocator);
+    rjEntry.AddMember(
+        "value", data_point::number_unsigned(entry->second).to_string(),
+        allocator);
+    rjMetrics.PushBack(rjEntry, allocator);
+  }
+  if (!_profile.empty()) {
+    rapidjson::Value rjEntry(rapidjson::kObjectType);
+    rjEntry.AddMember("key", rapidjson::StringRef(profile_metric_key),
+                      allocator);
+    rjEntry.AddMember("value", profile_to_data_point(_profile).to_string(),
+                      allocator);
     rjMetrics.PushBack(rjEntry, allocator);
   }
   out.AddMember("metrics", rjMetrics, allocator);
@@ -209,26 +586,53 @@ std::vector<uint8_t> Testcase::flatbuffers() const {
   // serialize results map
 
   std::vector<flatbuffers::Offset<fbs::Result>> fbsResultEntries;
-  for (const auto& result : _resultsMap) {
-    const auto& key = result.first.c_str();
-    const auto& value = result.second.val.serialize(builder);
-    const auto& type = result.second.typ == ResultCategory::Assert
-                           ? fbs::ResultType::Assert
-                           : fbs::ResultType::Check;
-    const auto& entry = fbs::CreateResultDirect(builder, key, value, type);
-    fbsResultEntries.push_back(entry);
+  if (_spilledKeys.empty()) {
+    fbsResultEntries.reserve(_resultsMap.size());
+    for (const auto& result : _resultsMap.sorted()) {
+      const auto& key = result->first.c_str();
+      const auto& value = result->second.val.serialize(builder);
+      const auto& type = detail::to_result_type(result->second.typ);
+      const auto& entry = fbs::CreateResultDirect(builder, key, value, type);
+      fbsResultEntries.push_back(entry);
+    }
+  } else {
+    fbsResultEntries =
+        detail::stitch_results(builder, _spillFile->path, _resultsMap);
   }
   const auto& fbsResults = fbs::CreateResultsDirect(builder, &fbsResultEntries);
 
   // serialize metrics
 
   std::vector<flatbuffers::Offset<fbs::Metric>> fbsMetricEntries;
-  for (const auto& metric : metrics()) {
-    const auto& key = metric.first.c_str();
-    const auto& value = metric.second.value.serialize(builder);
+  for (const auto& metric : _timersMap.sorted()) {
+    if (!metric->second.stopped || _summariesMap.count(metric->first)) {
+      continue;
+    }
+    const auto& key = metric->first.c_str();
+    const auto& value =
+        data_point::number_signed(metric->second.duration()).serialize(builder);
+    const auto& entry = fbs::CreateMetricDirect(builder, key, value);
+    fbsMetricEntries.push_back(entry);
+  }
+  for (const auto& metric : _summariesMap.sorted()) {
+    const auto& key = metric->first.c_str();
+    const auto& value = metric->second.to_data_point().serialize(builder);
+    const auto& entry = fbs::CreateMetricDirect(builder, key, value);
+    fbsMetricEntries.push_back(entry);
+  }
+  for (const auto& metric : _countersMap.sorted()) {
+    const auto& key = metric->first.c_str();
+    const auto& value =
+        data_point::number_unsigned(metric->second).serialize(builder);
     const auto& entry = fbs::CreateMetricDirect(builder, key, value);
     fbsMetricEntries.push_back(entry);
   }
+  if (!_profile.empty()) {
+    const auto& value = profile_to_data_point(_profile).serialize(builder);
+    const auto& entry =
+        fbs::CreateMetricDirect(builder, profile_metric_key, value);
+    fbsMetricEntries.push_back(entry);
+  }
   const auto& fbsMetrics = fbs::CreateMetricsDirect(builder, &fbsMetricEntries);
 
   // serialize message object representing this testcase
@@ -248,25 +652,235 @@ std::vector<uint8_t> Testcase::flatbuffers() const {
 Testcase::Overview Testcase::overview() const {
   Testcase::Overview overview;
   overview.keysCount = static_cast<std::int32_t>(_resultsMap.size());
-  for (const auto& tic : _tics) {
-    if (!_tocs.count(tic.first)) {
+  for (const auto& spilled : _spilledKeys) {
+    if (!_resultsMap.count(spilled.first)) {
+      overview.keysCount++;
+    }
+  }
+  for (const auto& timer : _timersMap) {
+    if (!timer.second.stopped || _summariesMap.count(timer.first)) {
       continue;
     }
-    const auto& key = tic.first;
-    const auto& diff = _tocs.at(key) - _tics.at(key);
-    const auto& duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(diff);
-    overview.metricsDuration += static_cast<std::int32_t>(duration.count());
+    overview.metricsDuration +=
+        static_cast<std::int32_t>(timer.second.duration());
     overview.metricsCount++;
   }
+  for (const auto& summary : _summariesMap) {
+    overview.metricsDuration +=
+        static_cast<std::int32_t>(std::llround(summary.second.median));
+    overview.metricsCount++;
+  }
+  overview.metricsCount += static_cast<std::int32_t>(_countersMap.size());
   return overview;
 }
 
+void Testcase::merge(const Testcase& other) {
+  ResultsMap stitched;
+  if (!other._spilledKeys.empty()) {
+    stitched = other.stitched_results();
+  }
+  const auto& results =
+      other._spilledKeys.empty() ? other._resultsMap : stitched;
+  for (const auto& result : results) {
+    add_result(result.first, result.second);
+  }
+  for (const auto& timer : other._timersMap) {
+    _timersMap.emplace(timer.first, timer.second);
+  }
+  for (const auto& summary : other._summariesMap) {
+    _summariesMap.emplace(summary.first, summary.second);
+  }
+  for (const auto& sample : other._profile) {
+    auto& entry = _profile[sample.first];
+    entry.calls += sample.second.calls;
+    entry.total += sample.second.total;
+    entry.self += sample.second.self;
+  }
+  for (const auto& counter : other._countersMap) {
+    add_counter(counter.first, counter.second);
+  }
+  _posted = false;
+}
+
 void Testcase::clear() {
   _posted = false;
   _resultsMap.clear();
-  _tics.clear();
-  _tocs.clear();
+  _timersMap.clear();
+  _summariesMap.clear();
+  _profile.clear();
+  _countersMap.clear();
+  // the spill file is removed unless a copy of this testcase still
+  // refers to it.
+  _spillFile.reset();
+  _spilledKeys.clear();
+  set_memory_usage(0u);
+  _memoryResidual = 0u;
+}
+
+void Testcase::set_memory_budget(const std::size_t budget,
+                                 const std::string& spill_path) {
+  _memoryBudget = budget;
+  _spillPath = spill_path;
+}
+
+std::size_t Testcase::memory_usage() const { return _memoryUsage; }
+
+void Testcase::set_memory_total(
+    const std::shared_ptr<std::atomic<std::size_t>>& total) {
+  _memoryShare.attach(total, _memoryUsage);
+}
+
+void Testcase::set_memory_usage(const std::size_t usage) {
+  _memoryUsage = usage;
+  _memoryShare.update(usage);
+}
+
+void Testcase::MemoryShare::attach(
+    const std::shared_ptr<std::atomic<std::size_t>>& total,
+    const std::size_t bytes) {
+  update(0u);
+  _total = total;
+  update(bytes);
+}
+
+void Testcase::MemoryShare::update(const std::size_t bytes) {
+  if (_total) {
+    if (bytes >= _bytes) {
+      *_total += bytes - _bytes;
+    } else {
+      *_total -= _bytes - bytes;
+    }
+  }
+  _bytes = bytes;
+}
+
+Testcase::SpillFile::SpillFile(const std::string& path) : path(path) {
+  const auto& parent = touca::filesystem::path(path).parent_path();
+  if (!parent.empty()) {
+    touca::filesystem::create_directories(parent);
+  }
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    throw std::runtime_error("failed to create spill file");
+  }
+}
+
+Testcase::SpillFile::~SpillFile() {
+  std::error_code ec;
+  touca::filesystem::remove(path, ec);
+}
+
+void Testcase::own_spill_file() {
+  if (!_spillFile) {
+    _spillFile = std::make_shared<SpillFile>(_spillPath);
+    return;
+  }
+  if (_spillFile.use_count() == 1) {
+    return;
+  }
+  // another copy of this testcase refers to the same file. we continue
+  // in a copy of our own so that neither sees what the other spills.
+  static std::atomic<unsigned> copies{0u};
+  const auto& file = std::make_shared<SpillFile>(
+      fmt::format("{}.{}", _spillPath, ++copies));
+  touca::filesystem::copy_file(
+      _spillFile->path, file->path,
+      touca::filesystem::copy_options::overwrite_existing);
+  _spillFile = file;
+}
+
+bool Testcase::is_spilled(const std::string& key) const {
+  return !_spilledKeys.empty() && _spilledKeys.count(key);
+}
+
+void Testcase::enforce_memory_budget() {
+  // once spilling is triggered, results that cannot be spilled remain in
+  // memory. we wait for at least half a budget worth of new results before
+  // spilling again, to avoid rewriting the spill file on every call.
+  if (_memoryBudget == 0u || _memoryUsage <= _memoryBudget ||
+      _memoryUsage - _memoryResidual <= _memoryBudget / 2) {
+    return;
+  }
+  spill();
+}
+
+std::size_t Testcase::spill() {
+  if (_spillPath.empty() || _memoryUsage <= _memoryResidual) {
+    return 0u;
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<fbs::Result>> fbsResultEntries;
+  ResultsMap remaining;
+  std::size_t remainingUsage = 0u;
+  for (const auto& result : _resultsMap) {
+    const auto& key = result.first;
+    const auto& type = result.second.val.type();
+    if (!detail::is_spillable(type)) {
+      remaining.emplace(key, result.second);
+      remainingUsage += key.size() + result.second.val.memory_usage();
+      continue;
+    }
+    const auto& value = result.second.val.serialize(builder);
+    fbsResultEntries.push_back(
+        fbs::CreateResultDirect(builder, key.c_str(), value,
+                                detail::to_result_type(result.second.typ)));
+    _spilledKeys.emplace(key, SpilledEntry{result.second.typ, type});
+  }
+  if (fbsResultEntries.empty()) {
+    _memoryResidual = _memoryUsage;
+    return 0u;
+  }
+
+  const auto& fbsMetadata = fbs::CreateMetadataDirect(
+      builder, _metadata.testsuite.c_str(), _metadata.version.c_str(),
+      _metadata.testcase.c_str(), _metadata.builtAt.c_str(),
+      _metadata.teamslug.c_str());
+  const auto& fbsResults = fbs::CreateResultsDirect(builder, &fbsResultEntries);
+  std::vector<flatbuffers::Offset<fbs::Metric>> fbsMetricEntries;
+  const auto& fbsMetrics = fbs::CreateMetricsDirect(builder, &fbsMetricEntries);
+  fbs::MessageBuilder fbsMessage_builder(builder);
+  fbsMessage_builder.add_metadata(fbsMetadata);
+  fbsMessage_builder.add_results(fbsResults);
+  fbsMessage_builder.add_metrics(fbsMetrics);
+  builder.Finish(fbsMessage_builder.Finish());
+  own_spill_file();
+  detail::append_spill_chunk(_spillFile->path, builder);
+
+  const auto released =
+      _memoryUsage > remainingUsage ? _memoryUsage - remainingUsage : 0u;
+  _resultsMap = std::move(remaining);
+  set_memory_usage(remainingUsage);
+  _memoryResidual = remainingUsage;
+  return released;
+}
+
+ResultsMap Testcase::stitched_results() const {
+  ResultsMap out;
+  const auto& add = [&out](const std::string& key, const ResultCategory typ,
+                           const data_point& value) {
+    const auto& it = out.find(key);
+    if (it == out.end()) {
+      out.emplace(key, ResultEntry{value, typ});
+      return;
+    }
+    if (it->second.val.type() == detail::internal_type::array &&
+        value.type() == detail::internal_type::array) {
+      for (const auto& element : *value.as_array()) {
+        it->second.val.as_array()->push_back(element);
+      }
+    }
+  };
+  detail::read_spill_file(
+      _spillFile->path, [&add](const fbs::Message& message) {
+        for (const auto&& result : *message.results()->entries()) {
+          add(result->key()->str(), detail::to_category(result->typ()),
+              deserialize_value(result->value()));
+        }
+      });
+  for (const auto& result : _resultsMap) {
+    add(result.first, result.second.typ, result.second.val);
+  }
+  return out;
 }
 
 std::vector<uint8_t> Testcase::serialize(
@@ -283,6 +897,20 @@ std::vector<uint8_t> Testcase::serialize(
   return {ptr, ptr + builder.GetSize()};
 }
 
+std::vector<uint8_t> Testcase::serialize(
+    const std::vector<std::shared_ptr<Testcase>>& testcases) {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<fbs::MessageBuffer>> messageBuffers;
+  for (const auto& tc : testcases) {
+    const auto& out = tc->flatbuffers();
+    messageBuffers.push_back(fbs::CreateMessageBufferDirect(builder, &out));
+  }
+  const auto& messages = fbs::CreateMessagesDirect(builder, &messageBuffers);
+  builder.Finish(messages);
+  const auto& ptr = builder.GetBufferPointer();
+  return {ptr, ptr + builder.GetSize()};
+}
+
 std::string elements_map_to_json(const ElementsMap& elements_map) {
   rapidjson::Document doc(rapidjson::kArrayType);
   rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
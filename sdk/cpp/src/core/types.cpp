@@ -169,6 +169,37 @@ class data_point_to_json_visitor {
   }
 };
 
+class data_point_memory_visitor {
+ public:
+  std::size_t operator()(const detail::deep_copy_ptr<std::string>& str) {
+    return sizeof(std::string) + str->capacity();
+  }
+
+  std::size_t operator()(const detail::deep_copy_ptr<array>& arr) {
+    auto out = sizeof(array);
+    for (const auto& element : *arr) {
+      out += element.memory_usage();
+    }
+    return out;
+  }
+
+  std::size_t operator()(const detail::deep_copy_ptr<object>& obj) {
+    // account for the key and bookkeeping of each node of the underlying
+    // tree in addition to the member value itself.
+    auto out = sizeof(object) + obj->get_name().capacity();
+    for (const auto& member : *obj) {
+      out += 4 * sizeof(void*) + sizeof(std::string) +
+             member.first.capacity() + member.second.memory_usage();
+    }
+    return out;
+  }
+
+  template <typename T>
+  std::size_t operator()(const T&) {
+    return 0u;
+  }
+};
+
 }  // namespace detail
 
 void data_point::increment() noexcept {
@@ -180,6 +211,11 @@ flatbuffers::Offset<fbs::TypeWrapper> data_point::serialize(
   return detail::visit(detail::data_point_serializer_visitor(builder), _value);
 }
 
+std::size_t data_point::memory_usage() const noexcept {
+  return sizeof(data_point) +
+         detail::visit(detail::data_point_memory_visitor(), _value);
+}
+
 std::string data_point::to_string() const {
   rapidjson::Document doc;
   auto& allocator = doc.GetAllocator();
@@ -0,0 +1,169 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "touca/lib_api.hpp"
+#include "touca/runner/detail/helpers.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace touca {
+namespace detail {
+
+constexpr char peak_rss_metric_key[] = "__peak_rss__";
+constexpr char allocations_metric_key[] = "__allocations__";
+constexpr char allocated_bytes_metric_key[] = "__allocated_bytes__";
+
+static std::atomic<bool> allocation_hook{false};
+static std::atomic<bool> allocation_counting{false};
+static std::atomic<std::uint64_t> allocation_count{0u};
+static std::atomic<std::uint64_t> allocation_bytes{0u};
+
+// the following are declared in `touca/extra/allocations.hpp` which cannot
+// be included here since it replaces global operators new and delete.
+
+TOUCA_CLIENT_API bool install_allocation_hook() {
+  allocation_hook.store(true);
+  return true;
+}
+
+TOUCA_CLIENT_API void count_allocation(const std::size_t size) noexcept {
+  if (allocation_counting.load(std::memory_order_relaxed)) {
+    allocation_count.fetch_add(1u, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+#ifdef __linux__
+
+/**
+ * Reads a field of `/proc/self/status` that is reported in kilobytes.
+ *
+ * @return false if the field could not be found
+ */
+static bool read_status_field(const char* field, std::uint64_t& bytes) {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  const auto length = std::strlen(field);
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, length, field) == 0 && line.size() > length &&
+        line[length] == ':') {
+      bytes = std::strtoull(line.c_str() + length + 1, nullptr, 10) * 1024u;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Resets the peak resident set size of the process to its current
+ * resident set size. Supported since Linux 4.0.
+ */
+static bool reset_peak_rss() {
+  auto file = std::fopen("/proc/self/clear_refs", "w");
+  if (!file) {
+    return false;
+  }
+  auto ok = std::fputs("5", file) >= 0;
+  ok &= std::fclose(file) == 0;
+  return ok;
+}
+
+static bool read_baseline(std::uint64_t& bytes) {
+  return reset_peak_rss() ? read_status_field("VmRSS", bytes)
+                          : read_status_field("VmHWM", bytes);
+}
+
+static bool read_peak_rss(std::uint64_t& bytes) {
+  return read_status_field("VmHWM", bytes);
+}
+
+#elif !defined(_WIN32)
+
+static bool read_peak_rss(std::uint64_t& bytes) {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return false;
+  }
+  bytes = static_cast<std::uint64_t>(usage.ru_maxrss);
+#ifndef __APPLE__
+  // reported in kilobytes everywhere but on macOS
+  bytes *= 1024u;
+#endif
+  return true;
+}
+
+static bool read_baseline(std::uint64_t& bytes) { return read_peak_rss(bytes); }
+
+#else
+
+static bool read_peak_rss(std::uint64_t&) { return false; }
+
+static bool read_baseline(std::uint64_t&) { return false; }
+
+#endif
+
+}  // namespace detail
+
+void MemoryUsage::add_to(Testcase& testcase) const {
+  if (has_peak_rss) {
+    testcase.add_counter(detail::peak_rss_metric_key, peak_rss);
+  }
+  if (has_allocations) {
+    testcase.add_counter(detail::allocations_metric_key, allocations);
+    testcase.add_counter(detail::allocated_bytes_metric_key, allocated_bytes);
+  }
+}
+
+MemoryUsage MemoryUsage::from_metrics(const MetricsMap& metrics) {
+  MemoryUsage usage;
+  const auto& find = [&metrics](const char* key, std::uint64_t& value) {
+    const auto& it = metrics.find(key);
+    if (it == metrics.end() ||
+        it->second.value.type() != detail::internal_type::number_unsigned) {
+      return false;
+    }
+    value = it->second.value.as_number_unsigned();
+    return true;
+  };
+  usage.has_peak_rss = find(detail::peak_rss_metric_key, usage.peak_rss);
+  usage.has_allocations =
+      find(detail::allocations_metric_key, usage.allocations) &&
+      find(detail::allocated_bytes_metric_key, usage.allocated_bytes);
+  return usage;
+}
+
+void MemoryProbe::start() {
+  // once started, allocations are counted for the rest of the run so that
+  // measurements of testcases that run at the same time do not interfere.
+  if (detail::allocation_hook.load()) {
+    detail::allocation_counting.store(true);
+  }
+  _has_baseline = detail::read_baseline(_baseline);
+  _allocations = detail::allocation_count.load();
+  _allocated_bytes = detail::allocation_bytes.load();
+}
+
+MemoryUsage MemoryProbe::stop() {
+  MemoryUsage usage;
+  if (detail::allocation_counting.load()) {
+    usage.has_allocations = true;
+    usage.allocations = detail::allocation_count.load() - _allocations;
+    usage.allocated_bytes = detail::allocation_bytes.load() - _allocated_bytes;
+  }
+  std::uint64_t peak = 0u;
+  if (_has_baseline && detail::read_peak_rss(peak)) {
+    usage.has_peak_rss = true;
+    usage.peak_rss = peak > _baseline ? peak - _baseline : 0u;
+  }
+  return usage;
+}
+
+}  // namespace touca
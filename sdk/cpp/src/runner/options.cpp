@@ -61,15 +61,109 @@ static cxxopts::Options cli_options() {
       ("redirect-output",
           "redirect content printed to standard streams to files",
           cxxopts::value<bool>()->default_value("true"))
+      ("redirect-mode",
+          "redirect output of std::cout and std::cerr (\"stream\") or "
+          "everything written to file descriptors 1 and 2 (\"fd\")",
+          cxxopts::value<std::string>())
+      ("redirect-limit",
+          "maximum size of redirected output of each stream in megabytes",
+          cxxopts::value<unsigned>())
       ("offline",
           "do not submit results to Touca server",
           cxxopts::value<bool>()->implicit_value("true"))
       ("overwrite",
           "overwrite result directory for testcase if it already exists",
           cxxopts::value<bool>()->implicit_value("true"))
+      ("result-log",
+          "store binary test results of all testcases in a single file",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("repeat",
+          "number of times to execute the workflow for each testcase, "
+          "reporting summary statistics of metrics across executions",
+          cxxopts::value<unsigned>())
+      ("warmup",
+          "number of times to execute the workflow for each testcase "
+          "before taking measurements",
+          cxxopts::value<unsigned>())
+      ("memory-metrics",
+          "report growth of peak resident set size of each testcase and, "
+          "if allocations are counted, number and size of allocations",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("order",
+          "order in which testcases are executed: as given (\"input\") or "
+          "by decreasing duration in previous runs (\"longest-first\"). "
+          "durations are kept in the output directory of the suite",
+          cxxopts::value<std::string>())
+      ("isolate",
+          "execute each testcase in a separate worker process",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("timeout",
+          "maximum time in seconds that the workflow may take to execute "
+          "each testcase",
+          cxxopts::value<unsigned>())
+      ("shard-index",
+          "zero-based index of the shard of testcases to run",
+          cxxopts::value<unsigned>())
+      ("shard-count",
+          "number of shards to split testcases into",
+          cxxopts::value<unsigned>())
+      ("shard-durations",
+          "json file with durations of testcases in milliseconds, used to "
+          "balance shards by expected duration",
+          cxxopts::value<std::string>())
+      ("shard-sync-dir",
+          "directory shared by all shards, used to seal the version once "
+          "all shards are complete, required with more than one shard",
+          cxxopts::value<std::string>())
+      ("workers",
+          "number of worker processes when testcases are isolated, "
+          "defaults to the number of processor cores",
+          cxxopts::value<unsigned>())
+      ("parallel-workflows",
+          "number of registered workflows to run at the same time, each "
+          "submitting results to a suite named after the workflow",
+          cxxopts::value<unsigned>())
       ("colored-output",
           "use color in standard output",
-          cxxopts::value<bool>()->default_value("true"));
+          cxxopts::value<bool>()->default_value("true"))
+      ("live-progress",
+          "show a single progress line in standard output that is refreshed "
+          "periodically, instead of one line per testcase",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("max-testcase-memory",
+          "memory budget of each testcase in megabytes, beyond which "
+          "captured results are spilled to disk",
+          cxxopts::value<unsigned>())
+      ("max-client-memory",
+          "memory budget of all testcases in megabytes, beyond which "
+          "captured results are spilled to disk",
+          cxxopts::value<unsigned>())
+      ("profile",
+          "record scoped timers as a tree of call paths with their call "
+          "counts and total and self times",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("perf-counters",
+          "record instructions, cycles, cache misses and branch misses "
+          "of each timer using hardware performance counters, on Linux",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("connect-timeout",
+          "seconds to wait for a connection to the server",
+          cxxopts::value<unsigned>())
+      ("read-timeout",
+          "seconds to wait for a response from the server",
+          cxxopts::value<unsigned>())
+      ("max-inflight",
+          "maximum number of test result submissions in flight at once",
+          cxxopts::value<unsigned>())
+      ("spool-dir",
+          "directory to keep test results in until the server accepts "
+          "them, so that they are submitted in the background and survive "
+          "server outages",
+          cxxopts::value<std::string>())
+      ("cache-dir",
+          "directory to cache the list of testcases of the suite in, "
+          "defaults to directory .cache in the output directory",
+          cxxopts::value<std::string>());
   // clang-format on
 
   return options;
@@ -97,6 +191,27 @@ static void parse_file_option(const rapidjson::Value& result,
   }
 }
 
+static void parse_file_option(const rapidjson::Value& result,
+                              const std::string& key, unsigned& field) {
+  if (result.HasMember(key) && result[key].IsUint()) {
+    field = result[key].GetUint();
+  }
+}
+
+static void parse_file_option(const rapidjson::Value& result,
+                              const std::string& key,
+                              std::map<std::string, unsigned>& field) {
+  if (!result.HasMember(key) || !result[key].IsObject()) {
+    return;
+  }
+  const auto& value = result[key];
+  for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+    if (it->name.IsString() && it->value.IsUint()) {
+      field[it->name.GetString()] = it->value.GetUint();
+    }
+  }
+}
+
 /**
  * @param argc number of arguments provided to the application
  * @param argv list of arguments provided to the application
@@ -133,6 +248,33 @@ static bool parse_cli_options(int argc, char* argv[],
     parse_cli_option(result, "skip-logs", options.skip_logs);
     parse_cli_option(result, "offline", options.offline);
     parse_cli_option(result, "overwrite", options.overwrite);
+    parse_cli_option(result, "result-log", options.result_log);
+    parse_cli_option(result, "live-progress", options.live_progress);
+    parse_cli_option(result, "repeat", options.repeat);
+    parse_cli_option(result, "warmup", options.warmup);
+    parse_cli_option(result, "memory-metrics", options.memory_metrics);
+    parse_cli_option(result, "order", options.order);
+    parse_cli_option(result, "isolate", options.isolate);
+    parse_cli_option(result, "workers", options.workers);
+    parse_cli_option(result, "parallel-workflows",
+                     options.parallel_workflows);
+    parse_cli_option(result, "timeout", options.timeout);
+    parse_cli_option(result, "shard-index", options.shard_index);
+    parse_cli_option(result, "shard-count", options.shard_count);
+    parse_cli_option(result, "shard-durations", options.shard_durations);
+    parse_cli_option(result, "shard-sync-dir", options.shard_sync_dir);
+    parse_cli_option(result, "redirect-mode", options.redirect_mode);
+    parse_cli_option(result, "redirect-limit", options.redirect_limit);
+    parse_cli_option(result, "max-testcase-memory",
+                     options.max_testcase_memory);
+    parse_cli_option(result, "max-client-memory", options.max_client_memory);
+    parse_cli_option(result, "profile", options.profile);
+    parse_cli_option(result, "perf-counters", options.perf_counters);
+    parse_cli_option(result, "connect-timeout", options.connect_timeout);
+    parse_cli_option(result, "read-timeout", options.read_timeout);
+    parse_cli_option(result, "max-inflight", options.max_inflight);
+    parse_cli_option(result, "spool-dir", options.spool_dir);
+    parse_cli_option(result, "cache-dir", options.cache_dir);
   } catch (const cxxopts::OptionParseException& ex) {
     touca::print_error("failed to parse command line arguments: {}\n",
                        ex.what());
@@ -214,7 +356,36 @@ static bool parse_file_options(FrameworkOptions& options) {
       parse_file_option(result, "skip-logs", options.skip_logs);
       parse_file_option(result, "redirect-output", options.redirect);
       parse_file_option(result, "overwrite", options.overwrite);
+      parse_file_option(result, "result-log", options.result_log);
+      parse_file_option(result, "live-progress", options.live_progress);
+      parse_file_option(result, "repeat", options.repeat);
+      parse_file_option(result, "warmup", options.warmup);
+      parse_file_option(result, "memory-metrics", options.memory_metrics);
+      parse_file_option(result, "order", options.order);
+      parse_file_option(result, "isolate", options.isolate);
+      parse_file_option(result, "workers", options.workers);
+      parse_file_option(result, "parallel-workflows",
+                        options.parallel_workflows);
+      parse_file_option(result, "timeout", options.timeout);
+      parse_file_option(result, "timeouts", options.timeouts);
+      parse_file_option(result, "shard-index", options.shard_index);
+      parse_file_option(result, "shard-count", options.shard_count);
+      parse_file_option(result, "shard-durations", options.shard_durations);
+      parse_file_option(result, "shard-sync-dir", options.shard_sync_dir);
+      parse_file_option(result, "redirect-mode", options.redirect_mode);
+      parse_file_option(result, "redirect-limit", options.redirect_limit);
       parse_file_option(result, "testcase-file", options.testcase_file);
+      parse_file_option(result, "max-testcase-memory",
+                        options.max_testcase_memory);
+      parse_file_option(result, "max-client-memory",
+                        options.max_client_memory);
+      parse_file_option(result, "profile", options.profile);
+      parse_file_option(result, "perf-counters", options.perf_counters);
+      parse_file_option(result, "connect-timeout", options.connect_timeout);
+      parse_file_option(result, "read-timeout", options.read_timeout);
+      parse_file_option(result, "max-inflight", options.max_inflight);
+      parse_file_option(result, "spool-dir", options.spool_dir);
+      parse_file_option(result, "cache-dir", options.cache_dir);
       continue;
     }
     if (result.IsString()) {
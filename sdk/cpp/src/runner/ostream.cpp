@@ -1,7 +1,29 @@
 // Copyright 2021 Touca, Inc. Subject to Apache-2.0 License.
 
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
 #include "touca/runner/detail/helpers.hpp"
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define touca_close _close
+#define touca_dup _dup
+#define touca_dup2 _dup2
+#define touca_read _read
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#define touca_close close
+#define touca_dup dup
+#define touca_dup2 dup2
+#define touca_read read
+#endif
+
 namespace touca {
 OutputCapturer::OutputCapturer() {}
 
@@ -32,4 +54,163 @@ void OutputCapturer::stop_capture() {
 std::string OutputCapturer::cerr() const { return _buferr.str(); }
 
 std::string OutputCapturer::cout() const { return _bufout.str(); }
+
+/**
+ * Creates a pipe whose descriptors are not inherited by child processes.
+ * The write end is still inherited once it replaces a standard descriptor.
+ */
+static bool make_pipe(int fds[2]) {
+#if defined(_WIN32)
+  return _pipe(fds, 1 << 16, _O_BINARY | _O_NOINHERIT) == 0;
+#elif defined(__linux__)
+  return pipe2(fds, O_CLOEXEC) == 0;
+#else
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+#endif
+}
+
+/** Duplicates a descriptor into one that is not inherited by children. */
+static int save_descriptor(const int fd) {
+#ifdef _WIN32
+  return touca_dup(fd);
+#else
+  return fcntl(fd, F_DUPFD_CLOEXEC, 0);
+#endif
+}
+
+/**
+ * Waits until the given pipe has some input or the given time passes.
+ *
+ * @return false if there is no input to read yet
+ */
+static bool wait_for_input(const int fd,
+                           const std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+  // reads block until there is some input or every write end is closed.
+  (void)fd;
+  (void)timeout;
+  return true;
+#else
+  pollfd entry{fd, POLLIN, 0};
+  const auto ready = poll(&entry, 1, static_cast<int>(timeout.count()));
+  return ready > 0 || (ready == -1 && errno != EINTR);
+#endif
+}
+
+DescriptorCapturer::DescriptorCapturer(const touca::filesystem::path& dir,
+                                       const std::uint64_t limit)
+    : _limit(limit) {
+  _channels[0].fd = 1;
+  _channels[0].path = dir / "stdout.txt";
+  _channels[1].fd = 2;
+  _channels[1].path = dir / "stderr.txt";
+}
+
+DescriptorCapturer::~DescriptorCapturer() {
+  if (_capturing) {
+    stop_capture();
+  }
+}
+
+void DescriptorCapturer::start_capture() {
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(stdout);
+  std::fflush(stderr);
+  _stopping = false;
+  for (auto& channel : _channels) {
+    int fds[2];
+    if (!make_pipe(fds)) {
+      stop_capture();
+      throw std::runtime_error("failed to create pipe to capture output");
+    }
+    channel.saved = save_descriptor(channel.fd);
+    touca_dup2(fds[1], channel.fd);
+    touca_close(fds[1]);
+    channel.pipe = fds[0];
+    channel.reader = std::thread(&DescriptorCapturer::drain, this,
+                                 std::ref(channel));
+  }
+  _capturing = true;
+}
+
+void DescriptorCapturer::stop_capture() {
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(stdout);
+  std::fflush(stderr);
+  // restoring the original descriptor closes the write end of the pipe,
+  // which lets the reader thread reach the end of its input, unless child
+  // processes still hold it. readers give up on them after a grace period.
+  for (auto& channel : _channels) {
+    if (channel.saved != -1) {
+      touca_dup2(channel.saved, channel.fd);
+      touca_close(channel.saved);
+      channel.saved = -1;
+    }
+  }
+  _deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  _stopping.store(true, std::memory_order_release);
+  for (auto& channel : _channels) {
+    if (channel.reader.joinable()) {
+      channel.reader.join();
+    }
+  }
+  _capturing = false;
+}
+
+void DescriptorCapturer::drain(Channel& channel) {
+  std::FILE* file = nullptr;
+  std::uint64_t written = 0u;
+  std::uint64_t dropped = 0u;
+  char buffer[1 << 16];
+  while (true) {
+    if (_stopping.load(std::memory_order_acquire) &&
+        std::chrono::steady_clock::now() >= _deadline) {
+      break;
+    }
+    if (!wait_for_input(channel.pipe, std::chrono::milliseconds(100))) {
+      continue;
+    }
+    const auto count = touca_read(channel.pipe, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    auto size = static_cast<std::uint64_t>(count);
+    if (_limit != 0u && written + size > _limit) {
+      dropped += written + size - _limit;
+      size = _limit - written;
+    }
+    if (size == 0u) {
+      continue;
+    }
+    if (!file) {
+      std::error_code ec;
+      touca::filesystem::create_directories(channel.path.parent_path(), ec);
+      file = std::fopen(channel.path.string().c_str(), "wb");
+    }
+    if (file) {
+      std::fwrite(buffer, 1, static_cast<std::size_t>(size), file);
+    }
+    written += size;
+  }
+  if (file && dropped != 0u) {
+    std::fprintf(file, "\n[output truncated: %llu bytes omitted]\n",
+                 static_cast<unsigned long long>(dropped));
+  }
+  if (file) {
+    std::fclose(file);
+  }
+  touca_close(channel.pipe);
+  channel.pipe = -1;
+}
+
 }  // namespace touca
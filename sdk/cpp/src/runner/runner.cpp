@@ -2,12 +2,21 @@
 
 #include "touca/runner/runner.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <thread>
 #include <unordered_map>
 
@@ -15,6 +24,7 @@
 #include "fmt/ostream.h"
 #include "fmt/printf.h"
 #include "touca/core/config.hpp"
+#include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
 #include "touca/core/platform.hpp"
 #include "touca/core/utils.hpp"
@@ -29,6 +39,7 @@
 namespace touca {
 
 struct {
+  std::mutex mutex;  // guards members used by workflows run in parallel
   std::function<void(FrameworkOptions&)> config;
   std::vector<std::pair<std::unique_ptr<Sink>, Sink::Level>> sinks;
   std::map<std::string, Runner::Workflow> workflows;
@@ -52,34 +63,14 @@ void reset_test_runner() {
   _meta.workflows.clear();
 }
 
-int run(int argc, char* argv[]) {
-  auto status = 0U;
-  for (const auto& workflow : _meta.workflows) {
-    try {
-      status += touca::Runner(argc, argv).run(workflow.second);
-    } catch (const std::exception& ex) {
-      touca::print_error("failed to run workflow: {}\n", ex.what());
-      status++;
-    } catch (...) {
-      touca::print_error("failed to run workflow: unknown error\n");
-      status++;
-    }
-  }
-  return status ? EXIT_FAILURE : EXIT_SUCCESS;
-}
-
 static bool skip_testcase(const FrameworkOptions& options,
+                          const ResultLog* result_log,
+                          const std::unordered_set<std::string>& processed,
                           const std::string& testcase) {
-  auto output_dir_case = touca::filesystem::path(options.output_dir) /
-                         options.suite / options.revision / testcase;
-  if (options.save_binary) {
-    output_dir_case /= "touca.bin";
-  } else if (options.save_json) {
-    output_dir_case /= "touca.json";
-  } else {
-    return false;
+  if (result_log && options.save_binary) {
+    return result_log->contains(testcase);
   }
-  return touca::filesystem::exists(output_dir_case.string());
+  return processed.count(testcase);
 }
 
 static bool expect_options(const std::map<std::string, std::string>& options) {
@@ -108,11 +99,17 @@ static bool validate_api_url(const FrameworkOptions& options) {
 }
 
 static bool validate_options(const FrameworkOptions& options) {
-  // we always expect a value for the following options.
-  if (!expect_options({{"team", options.team},
-                       {"suite", options.suite},
-                       {"revision", options.revision},
-                       {"output-dir", options.output_dir}})) {
+  // we always expect a value for the following options. `suite` is not
+  // expected if multiple workflows run in parallel, in which case results
+  // of each workflow are submitted to a suite named after it.
+  std::map<std::string, std::string> expected = {
+      {"team", options.team},
+      {"revision", options.revision},
+      {"output-dir", options.output_dir}};
+  if (options.parallel_workflows <= 1 || _meta.workflows.size() <= 1) {
+    expected.emplace("suite", options.suite);
+  }
+  if (!expect_options(expected)) {
     return false;
   }
 
@@ -136,32 +133,116 @@ static bool validate_options(const FrameworkOptions& options) {
     return false;
   }
 
-  return true;
-}
+  // expect `redirect-mode` to be one of `stream` or `fd`.
+  if (options.redirect_mode != "stream" && options.redirect_mode != "fd") {
+    touca::print_error(
+        "value of option \"--redirect-mode\" must be one of \"stream\" or "
+        "\"fd\".\n");
+    return false;
+  }
 
-void Logger::debug(const std::string& msg) const {
-  publish(Sink::Level::Debug, msg);
-}
-void Logger::info(const std::string& msg) const {
-  publish(Sink::Level::Info, msg);
-}
-void Logger::warn(const std::string& msg) const {
-  publish(Sink::Level::Warn, msg);
-}
-void Logger::error(const std::string& msg) const {
-  publish(Sink::Level::Error, msg);
-}
+  // expect the workflow to be executed at least once.
+  if (options.repeat == 0) {
+    touca::print_error("value of option \"--repeat\" must be positive.\n");
+    return false;
+  }
 
-void Logger::add_sink(std::unique_ptr<Sink> sink, const Sink::Level level) {
-  _sinks.push_back(std::make_pair(std::move(sink), level));
+  // expect results to be submitted over at least one connection.
+  if (options.max_inflight == 0) {
+    touca::print_error(
+        "value of option \"--max-inflight\" must be positive.\n");
+    return false;
+  }
+
+  // expect workflows to run one at a time or at the same time.
+  if (options.parallel_workflows == 0) {
+    touca::print_error(
+        "value of option \"--parallel-workflows\" must be positive.\n");
+    return false;
+  }
+
+  // workflows that run at the same time share this process and must
+  // submit their results to different suites.
+  if (options.parallel_workflows > 1 && _meta.workflows.size() > 1) {
+    if (!options.suite.empty()) {
+      touca::print_error(
+          "option \"--suite\" is not supported when workflows run in "
+          "parallel, since results of each workflow are submitted to a "
+          "suite named after it.\n");
+      return false;
+    }
+    if (options.isolate || options.memory_metrics) {
+      touca::print_error(
+          "options \"--isolate\" and \"--memory-metrics\" are not "
+          "supported when workflows run in parallel.\n");
+      return false;
+    }
+  }
+
+  // expect `order` to be one of `input` or `longest-first`.
+  if (options.order != "input" && options.order != "longest-first") {
+    touca::print_error(
+        "value of option \"--order\" must be one of \"input\" or "
+        "\"longest-first\".\n");
+    return false;
+  }
+
+  // expect `shard-index` to identify one of `shard-count` shards.
+  if (options.shard_count != 0 && options.shard_index >= options.shard_count) {
+    touca::print_error(
+        "value of option \"--shard-index\" must be less than the value of "
+        "option \"--shard-count\".\n");
+    return false;
+  }
+  if (options.shard_count == 0 &&
+      (options.shard_index != 0 || !options.shard_durations.empty())) {
+    touca::print_error("option \"--shard-count\" is required for sharding.\n");
+    return false;
+  }
+  // shards that run on different machines can only tell that all of them
+  // are complete through a directory that they share.
+  if (options.shard_count > 1 && !options.offline &&
+      options.shard_sync_dir.empty()) {
+    touca::print_error(
+        "option \"--shard-sync-dir\" is required when testcases are split "
+        "into more than one shard.\n");
+    return false;
+  }
+
+  return true;
 }
 
-void Logger::publish(const Sink::Level level, const std::string& msg) const {
-  for (const auto& kvp : _sinks) {
-    if (kvp.second <= level) {
-      kvp.first->log(level, msg);
+/**
+ * Records that the shard of testcases run by this process is complete and
+ * checks whether this process should seal the version.
+ *
+ * @details Each shard creates a marker file in a directory shared by all
+ *          shards. Once all markers exist, the first shard to exclusively
+ *          create the seal marker is responsible for sealing the version,
+ *          so that it is sealed exactly once, after all shards reported.
+ */
+static bool claim_seal(const FrameworkOptions& options,
+                       const touca::filesystem::path& sync_dir) {
+  const auto& dir = sync_dir / ".shards";
+  touca::filesystem::create_directories(dir);
+  const auto& marker = [&dir, &options](const unsigned index) {
+    return dir / fmt::format("{}-of-{}.done", index, options.shard_count);
+  };
+  const auto& tmp_path = marker(options.shard_index).string() + ".tmp";
+  std::ofstream(tmp_path, std::ios::trunc) << options.revision << '\n';
+  touca::filesystem::rename(tmp_path, marker(options.shard_index));
+  for (auto i = 0u; i < options.shard_count; ++i) {
+    if (!touca::filesystem::exists(marker(i))) {
+      return false;
     }
   }
+  const auto& sealed = dir / fmt::format("sealed-{}", options.shard_count);
+  const auto file = std::fopen(sealed.string().c_str(), "wx");
+  if (!file) {
+    return false;
+  }
+  std::fclose(file);
+  return true;
 }
 
 static std::string stringify(const Sink::Level& log_level) {
@@ -194,22 +275,165 @@ struct FileSink : public Sink {
   ~FileSink() { _ofs.close(); }
 
   void log(const Sink::Level level, const std::string& msg) override {
-    char timestamp[32];
-    std::time_t point_t = std::time(nullptr);
-    std::strftime(timestamp, sizeof(timestamp), "%FT%TZ",
-                  std::gmtime(&point_t));
+    write({level, std::chrono::system_clock::now(), std::this_thread::get_id(),
+           msg});
+  }
 
-    std::stringstream threadstamp;
-    threadstamp << std::this_thread::get_id();
+  /**
+   * Writes a log event published on another thread. The timestamp is
+   * only formatted again when the second changes and the label of each
+   * thread is formatted once.
+   */
+  void write(const LogRecord& record) {
+    const auto point_t = std::chrono::system_clock::to_time_t(record.time);
+    if (point_t != _last_time) {
+      std::strftime(_timestamp, sizeof(_timestamp), "%FT%TZ",
+                    std::gmtime(&point_t));
+      _last_time = point_t;
+    }
 
-    _ofs << fmt::format("{} {} {:<8} {}\n", timestamp, threadstamp.str(),
-                        stringify(level), msg);
+    auto it = _threadstamps.find(record.thread);
+    if (it == _threadstamps.end()) {
+      std::stringstream threadstamp;
+      threadstamp << record.thread;
+      it = _threadstamps.emplace(record.thread, threadstamp.str()).first;
+    }
+
+    _ofs << fmt::format("{} {} {:<8} {}\n", _timestamp, it->second,
+                        stringify(record.level), record.msg);
   }
 
+  void flush() { _ofs.flush(); }
+
  private:
   std::ofstream _ofs;
+  std::time_t _last_time = -1;
+  char _timestamp[32];
+  std::unordered_map<std::thread::id, std::string> _threadstamps;
 };
 
+Logger::~Logger() {
+  if (!_thread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+}
+
+void Logger::debug(const std::string& msg) {
+  publish(Sink::Level::Debug, msg);
+}
+void Logger::info(const std::string& msg) { publish(Sink::Level::Info, msg); }
+void Logger::warn(const std::string& msg) { publish(Sink::Level::Warn, msg); }
+void Logger::error(const std::string& msg) {
+  publish(Sink::Level::Error, msg);
+}
+
+void Logger::add_sink(std::unique_ptr<Sink> sink, const Sink::Level level) {
+  if (dynamic_cast<ConsoleSink*>(sink.get())) {
+    _sinks.push_back({std::move(sink), level, nullptr});
+    return;
+  }
+  const auto file = dynamic_cast<FileSink*>(sink.get());
+  {
+    std::lock_guard<std::mutex> lock(_sinks_mutex);
+    _async_sinks.push_back({std::move(sink), level, file});
+  }
+  _async_level =
+      _async_sinks.size() == 1u ? level : std::min(_async_level, level);
+  if (!_thread.joinable()) {
+    _queue = touca::detail::make_unique<detail::ring_buffer<LogRecord>>(8192u);
+    _thread = std::thread(&Logger::run, this);
+  }
+}
+
+void Logger::publish(const Sink::Level level, const std::string& msg) {
+  for (const auto& entry : _sinks) {
+    if (entry.level <= level) {
+      entry.sink->log(level, msg);
+    }
+  }
+  if (!_queue || level < _async_level) {
+    return;
+  }
+  LogRecord record{level, std::chrono::system_clock::now(),
+                   std::this_thread::get_id(), msg};
+  while (!_queue->try_push(record)) {
+    if (level < Sink::Level::Warn) {
+      _dropped.fetch_add(1u, std::memory_order_relaxed);
+      return;
+    }
+    _cv.notify_one();
+    std::this_thread::yield();
+  }
+  _pushed.fetch_add(1u);
+  _cv.notify_one();
+}
+
+void Logger::flush() {
+  if (!_thread.joinable()) {
+    return;
+  }
+  const auto target = _pushed.load();
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cv.notify_one();
+  _cv_flushed.wait(lock, [this, target] { return _written >= target; });
+}
+
+void Logger::dispatch(const LogRecord& record) {
+  for (const auto& entry : _async_sinks) {
+    if (entry.level > record.level) {
+      continue;
+    }
+    if (entry.file) {
+      entry.file->write(record);
+    } else {
+      entry.sink->log(record.level, record.msg);
+    }
+  }
+}
+
+void Logger::run() {
+  LogRecord record;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    lock.unlock();
+    auto count = 0ull;
+    {
+      std::lock_guard<std::mutex> sinks_lock(_sinks_mutex);
+      while (_queue->try_pop(record)) {
+        dispatch(record);
+        ++count;
+      }
+      const auto dropped = _dropped.load(std::memory_order_relaxed);
+      if (dropped != _reported) {
+        dispatch({Sink::Level::Warn, std::chrono::system_clock::now(),
+                  std::this_thread::get_id(),
+                  fmt::format("dropped {} log events", dropped - _reported)});
+        _reported = dropped;
+      }
+      for (const auto& entry : _async_sinks) {
+        if (entry.file) {
+          entry.file->flush();
+        }
+      }
+    }
+    lock.lock();
+    _written += count;
+    _cv_flushed.notify_all();
+    if (_stopping && count == 0u) {
+      break;
+    }
+    _cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
+      return _stopping || _pushed.load() > _written;
+    });
+  }
+}
+
 Sink::Level find_log_level(const std::string& name) {
   static const std::unordered_map<std::string, Sink::Level> values = {
       {"debug", Sink::Level::Debug},
@@ -244,45 +468,116 @@ long long Timer::count(const std::string& key) const {
 }
 
 void Printer::update(const touca::filesystem::path& path,
-                     const bool colored_output) {
+                     const bool colored_output, const bool live_progress) {
   _color = colored_output;
+  _live = live_progress;
   _file = std::ofstream(path.string(), std::ios::trunc);
 }
 
+void Printer::flush(const bool to_console) {
+  _file.write(_plain.data(), static_cast<std::streamsize>(_plain.size()));
+  if (to_console) {
+    // printers of workflows that run in parallel share standard output
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout.write(_styled.data(),
+                    static_cast<std::streamsize>(_styled.size()));
+    std::cout.flush();
+  }
+  _plain.clear();
+  _styled.clear();
+}
+
+void Printer::print_live_line(const bool force) {
+  const auto& now = std::chrono::steady_clock::now();
+  if (!force && now - _last_refresh < std::chrono::milliseconds(100)) {
+    return;
+  }
+  _last_refresh = now;
+  const auto done = _counts[Status::Pass] + _counts[Status::Skip] +
+                    _counts[Status::Fail] + _counts[Status::Timeout];
+  auto line = fmt::format(
+      "\r\033[2K Progress: {}/{}, {} passed, {} skipped, {} failed", done,
+      testcase_count, _counts[Status::Pass], _counts[Status::Skip],
+      _counts[Status::Fail]);
+  if (_counts[Status::Timeout]) {
+    line += fmt::format(", {} timed out", _counts[Status::Timeout]);
+  }
+  std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+  std::cout.flush();
+  _live_line = true;
+}
+
 void Printer::print_header(const FrameworkOptions& options) {
   print("\nTouca Test Framework\nSuite: {}/{}\n\n", options.suite,
         options.revision);
+  flush();
 }
 
 void Printer::print_progress(const unsigned index, const Status status,
                              const std::string& testcase, const Timer& timer,
-                             const std::vector<std::string>& errors) {
+                             const std::vector<std::string>& errors,
+                             const MemoryUsage& memory) {
   const auto& row_pad = std::floor(std::log10(testcase_count)) + 1;
   const auto& badge_color = fmt::bg(std::get<0>(_states.at(status)));
   const auto& badge_text = std::get<1>(_states.at(status));
 
+  if (!label.empty()) {
+    print(fmt::fg(fmt::terminal_color::bright_black), " [{}]", label);
+  }
   print(" {:>{}}", index + 1, static_cast<int>(row_pad));
   print(fmt::fg(fmt::terminal_color::bright_black), ". ");
   print(badge_color, " {} ", badge_text);
   print("  {:<{}}", testcase, testcase_width);
 
   if (status != Status::Skip) {
-    print(fmt::fg(fmt::terminal_color::bright_black), "    ({:d} ms)",
-          timer.count(testcase));
+    std::string details = fmt::format("{:d} ms", timer.count(testcase));
+    if (memory.has_peak_rss) {
+      details += fmt::format(", {:.1f} MB peak",
+                             static_cast<double>(memory.peak_rss) / 1048576.0);
+    }
+    if (memory.has_allocations) {
+      details += fmt::format(", {} allocations", memory.allocations);
+    }
+    print(fmt::fg(fmt::terminal_color::bright_black), "    ({})", details);
   }
   print("\n");
-  if (errors.empty()) {
+  if (!errors.empty()) {
+    print(fmt::fg(fmt::terminal_color::bright_black),
+          "\n   Exception Raised:\n");
+    for (const auto& err : errors) {
+      print("      - {}\n", err);
+    }
+    print("\n");
+  }
+
+  _counts[status]++;
+  if (!_live) {
+    flush();
     return;
   }
-  print(fmt::fg(fmt::terminal_color::bright_black), "\n   Exception Raised:\n");
-  for (const auto& err : errors) {
-    print("      - {}\n", err);
+  // in live mode, failed testcases are reported in full in place of the
+  // summary line, which is then printed again below them.
+  const auto is_last = index + 1 == testcase_count;
+  if (status != Status::Fail && status != Status::Timeout) {
+    flush(false);
+    print_live_line(is_last);
+    return;
   }
-  print("\n");
+  if (_live_line) {
+    _styled.insert(0, "\r\033[2K");
+  }
+  flush();
+  print_live_line(true);
 }
 
 void Printer::print_footer(const Statistics& stats, Timer& timer,
                            const unsigned suiteSize) {
+  if (_live_line) {
+    print_live_line(true);
+    _styled += "\n";
+    _live_line = false;
+  }
   const auto duration = timer.count("__workflow__") / 1000.0;
   const auto report = [&](const Status state, const fmt::terminal_color color,
                           const std::string& name) {
@@ -291,28 +586,195 @@ void Printer::print_footer(const Statistics& stats, Timer& timer,
       print(", ");
     }
   };
+  if (!label.empty()) {
+    print("\nSuite:      {}", label);
+  }
   print("\nTests:      ");
   report(Status::Pass, fmt::terminal_color::green, "passed");
   report(Status::Skip, fmt::terminal_color::yellow, "skipped");
   report(Status::Fail, fmt::terminal_color::red, "failed");
+  report(Status::Timeout, fmt::terminal_color::magenta, "timed out");
   print("{} total\n", suiteSize);
   print("Time:       {:.2f} s\n", duration);
   print("\n✨   Ran all test suites.\n\n");
+  flush();
+  _file.flush();
+}
+
+Trash::Trash(const touca::filesystem::path& root) : _root(root) {
+  _prefix = std::to_string(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  touca::filesystem::create_directories(_root);
+  // content left behind by a previous run that was interrupted
+  for (const auto& entry : touca::filesystem::directory_iterator(_root)) {
+    _queue.push_back(entry.path());
+  }
+  _thread = std::thread(&Trash::run, this);
+}
+
+Trash::~Trash() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+  std::error_code ec;
+  touca::filesystem::remove_all(_root, ec);
+}
+
+void Trash::discard(const touca::filesystem::path& path) {
+  std::error_code ec;
+  const auto& target = _root / fmt::format("{}-{}", _prefix, _counter++);
+  touca::filesystem::rename(path, target, ec);
+  if (ec) {
+    touca::filesystem::remove_all(path, ec);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.push_back(target);
+  }
+  _cv.notify_one();
 }
 
-Runner::Runner(int argc, char* argv[]) {
+void Trash::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _cv.wait(lock, [this] { return _stopping || !_queue.empty(); });
+    if (_queue.empty()) {
+      return;
+    }
+    const auto path = std::move(_queue.front());
+    _queue.pop_front();
+    lock.unlock();
+    std::error_code ec;
+    touca::filesystem::remove_all(path, ec);
+    lock.lock();
+  }
+}
+
+/**
+ * Parses and validates options of the test runner.
+ *
+ * @throw std::runtime_error if options are invalid
+ */
+static FrameworkOptions parse_and_validate(int argc, char* argv[]) {
+  FrameworkOptions options;
   if (!parse_options(argc, argv, options)) {
     fmt::print(std::cerr, cli_help_description());
     throw std::runtime_error("failed to parse options");
   }
   if (options.has_help || options.has_version) {
-    return;
+    return options;
   }
   if (!validate_options(options)) {
     throw std::runtime_error("failed to validate configuration options.");
   }
+  return options;
+}
+
+/**
+ * Runs a registered workflow. When workflows run in parallel, results of
+ * each workflow are submitted to a suite named after the workflow.
+ *
+ * @return zero if the workflow ran to completion
+ */
+static unsigned run_workflow(const FrameworkOptions& options,
+                             const std::string& name,
+                             const Runner::Workflow& workflow,
+                             const std::shared_ptr<ClientImpl>& client) {
+  auto workflow_options = options;
+  if (workflow_options.suite.empty()) {
+    workflow_options.suite = name;
+  }
+  try {
+    return touca::Runner(workflow_options, client).run(workflow);
+  } catch (const std::exception& ex) {
+    touca::print_error("failed to run workflow: {}\n", ex.what());
+  } catch (...) {
+    touca::print_error("failed to run workflow: unknown error\n");
+  }
+  return 1u;
+}
+
+int run(int argc, char* argv[]) {
+  if (_meta.workflows.empty()) {
+    return EXIT_SUCCESS;
+  }
+  // options are parsed and validated once for all workflows.
+  FrameworkOptions options;
+  try {
+    options = parse_and_validate(argc, argv);
+  } catch (const std::exception& ex) {
+    touca::print_error("failed to run workflow: {}\n", ex.what());
+    return EXIT_FAILURE;
+  }
+  if (options.has_help || options.has_version) {
+    return touca::Runner(options).run(nullptr);
+  }
+
+  const std::vector<std::pair<std::string, Runner::Workflow>> workflows(
+      _meta.workflows.begin(), _meta.workflows.end());
+  const auto parallel =
+      std::min<std::size_t>(options.parallel_workflows, workflows.size());
+  std::atomic<unsigned> status{0u};
+  if (parallel <= 1) {
+    for (const auto& workflow : workflows) {
+      status += run_workflow(options, workflow.first, workflow.second, nullptr);
+    }
+    return status ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  // each workflow has its own client to capture and submit results of
+  // its suite, while clients share one session with the server. output
+  // of the workflows cannot be told apart and is not redirected.
+  options.redirect = false;
+  options.live_progress = false;
+  std::atomic<std::size_t> next{0u};
+  const auto& work = [&]() {
+    for (auto i = next++; i < workflows.size(); i = next++) {
+      status += run_workflow(options, workflows[i].first, workflows[i].second,
+                             std::make_shared<ClientImpl>());
+    }
+  };
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < parallel; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Options of a client that keeps results of testcases in memory without
+ * submitting them, for workflows that run apart from the runner and hand
+ * their results over to it.
+ */
+static ClientOptions make_private_options(const FrameworkOptions& options) {
+  auto client_options = static_cast<const ClientOptions&>(options);
+  client_options.offline = true;
+  client_options.spool_dir.clear();
+  return client_options;
 }
 
+static std::shared_ptr<ClientImpl> make_private_client(
+    const FrameworkOptions& options) {
+  const auto& client = std::make_shared<ClientImpl>();
+  client->configure(make_private_options(options));
+  return client;
+}
+
+Runner::Runner(int argc, char* argv[])
+    : options(parse_and_validate(argc, argv)) {}
+
+Runner::Runner(const FrameworkOptions& options,
+               std::shared_ptr<ClientImpl> client)
+    : options(options), client(std::move(client)) {}
+
 int Runner::run(const Runner::Workflow workflow) {
   // if user asks for help, print help message and exit
   if (options.has_help) {
@@ -327,6 +789,10 @@ int Runner::run(const Runner::Workflow workflow) {
     return EXIT_SUCCESS;
   }
 
+  // functions of the client that are called on this thread capture and
+  // submit results for this runner.
+  ClientScope scope(client);
+
   // always print warning and errors log events to console
   logger.add_sink(touca::detail::make_unique<ConsoleSink>(), Sink::Level::Warn);
 
@@ -336,6 +802,35 @@ int Runner::run(const Runner::Workflow workflow) {
                                    options.suite / options.revision;
   touca::filesystem::create_directories(output_dir_version);
 
+  {
+    std::lock_guard<std::mutex> lock(_meta.mutex);
+    if (_meta.config) {
+      _meta.config(options);
+    }
+  }
+  // results spilled to disk are kept in the output directory of their
+  // testcase and are removed when the testcase is forgotten or cleared.
+  if (options.spill_dir.empty()) {
+    options.spill_dir = output_dir_version.string();
+  }
+  // the list of testcases of the suite is kept next to the results of
+  // previous runs, to skip downloading it when it has not changed.
+  if (options.cache_dir.empty()) {
+    options.cache_dir =
+        (touca::filesystem::path(options.output_dir) / ".cache").string();
+  }
+  // testcases listed in a file are known before configuring the client,
+  // so that the client does not ask the server for them.
+  if (options.testcases.empty() && !options.testcase_file.empty()) {
+    options.testcases = touca::get_testsuite_local(options.testcase_file);
+  }
+
+  // worker processes are forked while this process has no other thread,
+  // that is before the file logger, the client and the trash start theirs.
+  if (options.isolate) {
+    start_workers(workflow);
+  }
+
   // unless explicitly instructed not to do so, register a separate
   // file logger to write our events to a file in the output directory.
   if (!options.skip_logs) {
@@ -344,8 +839,13 @@ int Runner::run(const Runner::Workflow workflow) {
     logger.debug("registered default file logger");
   }
 
-  for (auto& sink : _meta.sinks) {
-    logger.add_sink(std::move(sink.first), sink.second);
+  {
+    std::lock_guard<std::mutex> lock(_meta.mutex);
+    for (auto& sink : _meta.sinks) {
+      if (sink.first) {
+        logger.add_sink(std::move(sink.first), sink.second);
+      }
+    }
   }
 
   for (const auto& opt : options.extra) {
@@ -355,17 +855,43 @@ int Runner::run(const Runner::Workflow workflow) {
   // Create a stream that simultaneously writes certain output
   // information printed on console to a file `Console.log` in
   // output directory for this revision.
-  printer.update(output_dir_version / "Console.log", options.colored_output);
+  printer.update(output_dir_version / "Console.log", options.colored_output,
+                 options.live_progress);
+  // progress of workflows that run in parallel is told apart by suite
+  if (client) {
+    printer.label = options.suite;
+  }
 
   // Provide feedback to user that regression test is starting.
   // We perform this operation prior to configuring Touca client,
   // which may take a noticeable time.
   printer.print_header(options);
 
-  if (_meta.config) {
-    _meta.config(options);
+  // configuring the client authenticates to the server and fetches the
+  // list of testcases, which may take a while. meanwhile, we look for the
+  // results of previous runs. neither modifies the options.
+  auto configured = std::async(std::launch::async, [this] {
+    ClientScope scope(client);
+    touca::configure(options);
+  });
+
+  // durations of testcases in previous runs of this suite are kept in a
+  // history file, to start testcases that take the longest first. they
+  // are kept in every run, so that they are at hand once they are needed.
+  const auto& history_path = touca::filesystem::path(options.output_dir) /
+                             options.suite / "durations.json";
+  std::unordered_map<std::string, unsigned long long> history;
+  std::string history_error;
+  if (options.order == "longest-first" &&
+      touca::filesystem::exists(history_path)) {
+    try {
+      history = load_durations(history_path);
+    } catch (const std::exception& ex) {
+      history_error = ex.what();
+    }
   }
-  touca::configure(options);
+  scan_output_dir(output_dir_version);
+  configured.get();
 
   // check that the client is properly configured
   if (!touca::is_configured()) {
@@ -375,16 +901,47 @@ int Runner::run(const Runner::Workflow workflow) {
   }
   logger.info("configured touca client");
 
-  if (options.testcases.empty() && !options.testcase_file.empty()) {
-    options.testcases = touca::get_testsuite_local(options.testcase_file);
-  }
+  // the client has already fetched the testcases from the server, if
+  // they were not given.
   if (options.testcases.empty() && !options.offline) {
-    options.testcases = touca::get_testsuite_remote(options);
+    options.testcases = touca::get_testcases();
   }
   if (options.testcases.empty()) {
     logger.error("unable to proceed with empty list of testcases");
     return EXIT_FAILURE;
   }
+  if (options.shard_count != 0) {
+    std::unordered_map<std::string, unsigned long long> durations;
+    try {
+      if (!options.shard_durations.empty()) {
+        durations = load_durations(options.shard_durations);
+      }
+    } catch (const std::exception& ex) {
+      logger.error(ex.what());
+      return EXIT_FAILURE;
+    }
+    options.testcases =
+        select_shard(options.testcases, options.shard_index,
+                     options.shard_count, durations);
+    logger.info(fmt::format("running {} testcases of shard {} of {}",
+                            options.testcases.size(), options.shard_index,
+                            options.shard_count));
+  }
+
+  if (!history_error.empty()) {
+    logger.warn(
+        fmt::format("ignoring durations of previous runs: {}", history_error));
+  }
+  if (options.order == "longest-first") {
+    options.testcases = order_by_duration(options.testcases, history);
+  }
+
+  // when requested, store binary results of all testcases in a single
+  // append-only file instead of a separate file for each testcase.
+  if (options.result_log) {
+    result_log = touca::detail::make_unique<ResultLog>(
+        (output_dir_version / "touca.results").string());
+  }
 
   printer.testcase_count = options.testcases.size();
   printer.testcase_width =
@@ -395,56 +952,218 @@ int Runner::run(const Runner::Workflow workflow) {
 
   // iterate over testcases and execute the workflow for each testcase.
   timer.tic("__workflow__");
-  auto index = 0U;
-  for (const auto& testcase : options.testcases) {
-    run_testcase(workflow, testcase, index++);
+  if (pool) {
+    run_isolated();
+  } else {
+    auto index = 0U;
+    for (const auto& testcase : options.testcases) {
+      run_testcase(workflow, testcase, index++);
+    }
   }
   timer.toc("__workflow__");
 
+  if (result_log) {
+    result_log->close();
+  }
+  pool.reset();
+  trash.reset();
+
+  if (!durations.empty()) {
+    // durations of testcases that did not run this time are kept too.
+    if (options.order != "longest-first" &&
+        touca::filesystem::exists(history_path)) {
+      try {
+        history = load_durations(history_path);
+      } catch (const std::exception& ex) {
+        logger.warn(fmt::format("replacing durations of previous runs: {}",
+                                ex.what()));
+      }
+    }
+    for (const auto& kvp : durations) {
+      history[kvp.first] = kvp.second;
+    }
+    try {
+      save_durations(history_path, history);
+    } catch (const std::exception& ex) {
+      logger.warn(ex.what());
+    }
+  }
+
   printer.print_footer(stats, timer, options.testcases.size());
 
-  if (!options.offline && !touca::seal()) {
+  // when testcases are split into shards, only seal the version once
+  // all shards are complete.
+  auto should_seal = !options.offline;
+  if (should_seal && options.shard_count != 0) {
+    should_seal = claim_seal(options, options.shard_sync_dir.empty()
+                                          ? output_dir_version
+                                          : touca::filesystem::path(
+                                                options.shard_sync_dir));
+    if (!should_seal) {
+      logger.info(fmt::format(
+          "not sealing this version: shard {} of {} is complete but other "
+          "shards are still running or another shard seals it",
+          options.shard_index, options.shard_count));
+    }
+  }
+  if (should_seal && !touca::seal()) {
     touca::print_warning("failed to seal this version\n");
   }
 
   logger.info("completed workflow");
+  logger.flush();
   return EXIT_SUCCESS;
 }
 
+void Runner::scan_output_dir(
+    const touca::filesystem::path& output_dir_version) {
+  const auto& trash_dir = output_dir_version / ".trash";
+  for (const auto& entry :
+       touca::filesystem::directory_iterator(output_dir_version)) {
+    const auto& name = entry.path().filename().string();
+    // hidden directories such as `.trash` and `.shards` hold bookkeeping
+    // of the runner and are never results of a testcase.
+    if (!entry.is_directory() || name.empty() || name[0] == '.') {
+      continue;
+    }
+    existing_dirs.insert(name);
+    if (options.overwrite) {
+      continue;
+    }
+    if ((options.save_binary &&
+         touca::filesystem::exists(entry.path() / "touca.bin")) ||
+        (!options.save_binary && options.save_json &&
+         touca::filesystem::exists(entry.path() / "touca.json"))) {
+      processed.insert(name);
+    }
+  }
+  if (!existing_dirs.empty() || touca::filesystem::exists(trash_dir)) {
+    trash = touca::detail::make_unique<Trash>(trash_dir);
+  }
+}
+
 void Runner::run_testcase(const Runner::Workflow workflow,
                           const std::string& testcase, const unsigned index) {
+  if (!prepare_testcase(testcase, index)) {
+    return;
+  }
   std::vector<std::string> errors;
-  auto output_dir_case = touca::filesystem::path(options.output_dir) /
-                         options.suite / options.revision / testcase;
+  logger.info(fmt::format("processing testcase: {}", testcase));
+  timer.tic(testcase);
+  const auto status =
+      execute_testcase(workflow, testcase, errors, find_timeout(testcase));
+  timer.toc(testcase);
+  finish_testcase(testcase, index, status, errors);
+}
+
+void Runner::start_workers(const Runner::Workflow workflow) {
+  const auto size =
+      options.workers ? options.workers
+                      : std::max(1u, std::thread::hardware_concurrency());
+  // workers capture results with the client shared by the whole worker
+  // process, so that threads spawned by the workflow capture results too.
+  // it neither submits results nor starts any thread. workers send their
+  // results to the runner.
+  const auto& client_options = make_private_options(options);
+  pool = touca::detail::make_unique<WorkerPool>(
+      size, [this, workflow, client_options](
+                const std::string& testcase, std::vector<std::string>& errors,
+                std::vector<std::uint8_t>& message) {
+        static std::once_flag configured;
+        std::call_once(configured, [&client_options] {
+          ClientScope::reset();
+          touca::configure(client_options);
+        });
+        execute_testcase(workflow, testcase, errors, 0u);
+        message = touca::find_testcase(testcase)->flatbuffers();
+        touca::forget_testcase(testcase);
+      });
+}
+
+void Runner::run_isolated() {
+  auto& pool = *this->pool;
+  // results of testcases are saved and submitted by the runner, in the
+  // order in which workers complete them.
+  const auto& collect = [this, &pool]() {
+    auto result = pool.wait();
+    timer.toc(result.testcase);
+    if (result.message.empty()) {
+      touca::declare_testcase(result.testcase);
+    } else {
+      touca::adopt_testcase(std::make_shared<Testcase>(
+          touca::deserialize_testcase(result.message)));
+    }
+    if (result.timed_out) {
+      result.errors = {fmt::format("timed out after {} s",
+                                   find_timeout(result.testcase))};
+    }
+    const auto status = result.timed_out        ? Status::Timeout
+                        : result.errors.empty() ? Status::Pass
+                                                : Status::Fail;
+    finish_testcase(result.testcase, result.index, status, result.errors);
+  };
+
+  auto index = 0U;
+  for (const auto& testcase : options.testcases) {
+    const auto current = index++;
+    if (!prepare_testcase(testcase, current)) {
+      continue;
+    }
+    if (!pool.has_idle_worker()) {
+      collect();
+    }
+    logger.info(fmt::format("processing testcase: {}", testcase));
+    timer.tic(testcase);
+    pool.submit(current, testcase,
+                std::chrono::seconds(find_timeout(testcase)));
+  }
+  while (pool.has_busy_worker()) {
+    collect();
+  }
+}
 
+bool Runner::prepare_testcase(const std::string& testcase,
+                              const unsigned index) {
   // unless `overwrite` is specified, check whether to skip this testcase.
-  if (!options.overwrite && skip_testcase(options, testcase)) {
+  if (!options.overwrite &&
+      skip_testcase(options, result_log.get(), processed, testcase)) {
     logger.info(fmt::format("skipping processed testcase: {}", testcase));
     stats.inc(Status::Skip);
     printer.print_progress(index, Status::Skip, testcase, timer);
-    return;
+    return false;
   }
 
-  touca::declare_testcase(testcase);
-
-  // remove result directory for this testcase if it already exists.
-  // since subsequent operations may expect to write into this directory,
-  // we wait a few milliseconds to ensure it is entirely removed from disk.
-  if (touca::filesystem::exists(output_dir_case.string())) {
-    touca::filesystem::remove_all(output_dir_case);
+  // move result directory for this testcase out of the way if it already
+  // exists. it is renamed in a single operation so that a new directory
+  // can be created right away, and is deleted in the background.
+  if (existing_dirs.erase(testcase)) {
+    const auto& output_dir_case = touca::filesystem::path(options.output_dir) /
+                                  options.suite / options.revision / testcase;
+    trash->discard(output_dir_case);
     logger.debug(fmt::format("removed result directory for {}", testcase));
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
   }
-  touca::filesystem::create_directories(output_dir_case);
+  return true;
+}
 
-  // execute workflow for this testcase
-  logger.info(fmt::format("processing testcase: {}", testcase));
-  timer.tic(testcase);
-  OutputCapturer capturer;
-  if (options.redirect) {
-    capturer.start_capture();
-  }
+unsigned Runner::find_timeout(const std::string& testcase) const {
+  const auto& it = options.timeouts.find(testcase);
+  return it == options.timeouts.end() ? options.timeout : it->second;
+}
 
+/**
+ * Holds the outcome of a workflow that runs on a separate thread, so that
+ * the thread can be abandoned if it runs out of time.
+ */
+struct Execution {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::string> errors;
+  bool done = false;
+};
+
+static void execute_workflow(const Runner::Workflow& workflow,
+                             const std::string& testcase,
+                             std::vector<std::string>& errors) {
   try {
     workflow(testcase);
   } catch (const std::exception& ex) {
@@ -452,30 +1171,192 @@ void Runner::run_testcase(const Runner::Workflow workflow,
   } catch (...) {
     errors = {"unknown exception"};
   }
+}
+
+/**
+ * Executes the workflow a given number of times after discarding results
+ * of some warm-up executions. Results of the last execution are kept and
+ * each metric is reported as summary statistics of all measurements.
+ */
+static void execute_workflow(const Runner::Workflow& workflow,
+                             const std::string& testcase,
+                             const unsigned warmup, const unsigned repeat,
+                             std::vector<std::string>& errors) {
+  if (warmup == 0u && repeat <= 1u) {
+    execute_workflow(workflow, testcase, errors);
+    return;
+  }
+  std::map<std::string, std::vector<double>> samples;
+  for (auto i = 0u; i < warmup + repeat; ++i) {
+    if (i != 0u) {
+      touca::find_testcase(testcase)->clear();
+    }
+    execute_workflow(workflow, testcase, errors);
+    if (!errors.empty()) {
+      return;
+    }
+    if (i < warmup) {
+      continue;
+    }
+    for (const auto& metric : touca::find_testcase(testcase)->metrics()) {
+      const auto& value = metric.second.value;
+      if (value.type() == detail::internal_type::number_signed) {
+        samples[metric.first].push_back(
+            static_cast<double>(value.as_number_signed()));
+      }
+    }
+  }
+  const auto& tc = touca::find_testcase(testcase);
+  for (const auto& metric : samples) {
+    tc->add_metric_summary(metric.first,
+                           MetricSummary::from_samples(metric.second));
+  }
+}
+
+Status Runner::execute_testcase(const Runner::Workflow workflow,
+                                const std::string& testcase,
+                                std::vector<std::string>& errors,
+                                const unsigned timeout) {
+  const auto& output_dir_case = touca::filesystem::path(options.output_dir) /
+                                options.suite / options.revision / testcase;
+  auto status = Status::Pass;
+  touca::declare_testcase(testcase);
+  // when results are stored in the result log, the directory for this
+  // testcase is only created if there is some other file to write into it.
+  // workers check the option since they are forked before the log opens.
+  if (!options.result_log) {
+    touca::filesystem::create_directories(output_dir_case);
+  }
+
+  // unlike streams, output captured from file descriptors is written
+  // straight into the output directory of this testcase.
+  const auto redirect_limit =
+      static_cast<std::uint64_t>(options.redirect_limit) * 1024u * 1024u;
+  const auto redirect_fd = options.redirect && options.redirect_mode == "fd";
+  OutputCapturer capturer;
+  DescriptorCapturer fd_capturer(output_dir_case, redirect_limit);
+  if (redirect_fd) {
+    fd_capturer.start_capture();
+  } else if (options.redirect) {
+    capturer.start_capture();
+  }
+
+  MemoryProbe memory;
+  if (options.memory_metrics) {
+    memory.start();
+  }
+  const auto warmup = options.warmup;
+  const auto repeat = options.repeat;
+  if (!timeout) {
+    execute_workflow(workflow, testcase, warmup, repeat, errors);
+  } else {
+    // the workflow runs on its own thread with a client of its own, which
+    // no other thread uses. if the workflow is abandoned, the thread keeps
+    // the client alive and whatever it captures afterwards is never seen.
+    // threads that the workflow spawns without `touca::bind_client` still
+    // capture results with the client of the runner, as they would without
+    // a timeout. results of a workflow that completes in time are merged
+    // with theirs and adopted by the client of the runner.
+    const auto& private_client = make_private_client(options);
+    const auto& execution = std::make_shared<Execution>();
+    std::thread thread([execution, private_client, workflow, testcase, warmup,
+                        repeat]() {
+      ClientScope scope(private_client);
+      touca::declare_testcase(testcase);
+      std::vector<std::string> errors;
+      execute_workflow(workflow, testcase, warmup, repeat, errors);
+      std::lock_guard<std::mutex> lock(execution->mutex);
+      execution->errors = std::move(errors);
+      execution->done = true;
+      execution->cv.notify_one();
+    });
+    std::unique_lock<std::mutex> lock(execution->mutex);
+    if (execution->cv.wait_for(lock, std::chrono::seconds(timeout),
+                               [&execution] { return execution->done; })) {
+      errors = execution->errors;
+      lock.unlock();
+      thread.join();
+      const auto& results = private_client->find_testcase(testcase);
+      const auto& spawned = touca::find_testcase(testcase);
+      if (results && spawned) {
+        results->merge(*spawned);
+        touca::adopt_testcase(results);
+      }
+    } else {
+      lock.unlock();
+      thread.detach();
+      errors = {fmt::format("timed out after {} s", timeout)};
+      status = Status::Timeout;
+    }
+  }
+
+  if (options.memory_metrics && status != Status::Timeout) {
+    memory.stop().add_to(*touca::find_testcase(testcase));
+  }
 
-  if (options.redirect) {
+  if (redirect_fd) {
+    fd_capturer.stop_capture();
+  } else if (options.redirect) {
     capturer.stop_capture();
   }
-  timer.toc(testcase);
-  stats.inc(errors.empty() ? Status::Pass : Status::Fail);
-  logger.info(fmt::format("processed testcase: {}", testcase));
 
-  if (!capturer.cerr().empty()) {
-    const auto resultFile = output_dir_case / "stderr.txt";
-    touca::detail::save_string_file(resultFile.string(), capturer.cerr());
+  // logged once output is no longer captured, so that it reaches the
+  // console instead of the output of this testcase.
+  if (status == Status::Timeout) {
+    logger.warn(fmt::format("abandoned workflow of testcase {} after {} s",
+                            testcase, timeout));
+  }
+
+  const auto& save_output = [&](const std::string& filename,
+                                const std::string& content) {
+    if (content.empty()) {
+      return;
+    }
+    touca::filesystem::create_directories(output_dir_case);
+    const auto resultFile = output_dir_case / filename;
+    if (redirect_limit == 0u || content.size() <= redirect_limit) {
+      touca::detail::save_string_file(resultFile.string(), content);
+      return;
+    }
+    touca::detail::save_string_file(
+        resultFile.string(),
+        fmt::format("{}\n[output truncated: {} bytes omitted]\n",
+                    content.substr(0, redirect_limit),
+                    content.size() - redirect_limit));
+  };
+  save_output("stderr.txt", capturer.cerr());
+  save_output("stdout.txt", capturer.cout());
+  if (status == Status::Pass && !errors.empty()) {
+    status = Status::Fail;
   }
+  return status;
+}
 
-  if (!capturer.cout().empty()) {
-    const auto resultFile = output_dir_case / "stdout.txt";
-    touca::detail::save_string_file(resultFile.string(), capturer.cout());
+void Runner::finish_testcase(const std::string& testcase, const unsigned index,
+                             const Status status,
+                             const std::vector<std::string>& errors) {
+  const auto& output_dir_case = touca::filesystem::path(options.output_dir) /
+                                options.suite / options.revision / testcase;
+  stats.inc(status);
+  durations[testcase] = static_cast<unsigned long long>(timer.count(testcase));
+  logger.info(fmt::format("processed testcase: {}", testcase));
+
+  // results of a workflow that ran out of time are neither saved nor
+  // submitted. workflows abandoned in this process capture them with a
+  // client of their own, while isolated ones leave an empty testcase.
+  if (status == Status::Timeout && touca::find_testcase(testcase)) {
+    touca::forget_testcase(testcase);
   }
 
-  if (errors.empty() && options.save_binary) {
+  if (errors.empty() && options.save_binary && result_log) {
+    result_log->append(testcase, touca::find_testcase(testcase)->flatbuffers());
+  } else if (errors.empty() && options.save_binary) {
     const auto resultFile = output_dir_case / "touca.bin";
     touca::save_binary(resultFile.string(), {testcase});
   }
 
   if (errors.empty() && options.save_json) {
+    touca::filesystem::create_directories(output_dir_case);
     const auto resultFile = output_dir_case / "touca.json";
     touca::save_json(resultFile.string(), {testcase});
   }
@@ -484,9 +1365,15 @@ void Runner::run_testcase(const Runner::Workflow workflow,
     logger.error("failed to submit results");
   }
 
-  const auto& status = errors.empty() ? Status::Pass : Status::Fail;
-  printer.print_progress(index, status, testcase, timer, errors);
-  touca::forget_testcase(testcase);
+  MemoryUsage memory;
+  if (options.memory_metrics && status != Status::Timeout) {
+    memory = MemoryUsage::from_metrics(
+        touca::find_testcase(testcase)->metrics());
+  }
+  printer.print_progress(index, status, testcase, timer, errors, memory);
+  if (status != Status::Timeout) {
+    touca::forget_testcase(testcase);
+  }
 }
 
 }  // namespace touca
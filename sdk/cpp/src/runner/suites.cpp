@@ -1,10 +1,19 @@
 // Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <map>
+#include <numeric>
 #include <vector>
 
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "touca/client/detail/client.hpp"
+#include "touca/core/filesystem.hpp"
 #include "touca/core/platform.hpp"
+#include "touca/runner/detail/helpers.hpp"
 #include "touca/runner/runner.hpp"
 
 namespace touca {
@@ -20,11 +29,22 @@ std::vector<std::string> get_testsuite_remote(const FrameworkOptions& options) {
   if (!api_url.confirm(options.team, options.suite, options.revision)) {
     throw std::runtime_error(api_url._error);
   }
-  Platform platform(api_url);
-  if (!platform.auth(options.api_key)) {
-    throw std::runtime_error(platform.get_error());
+  // sign in through the session shared with clients of this process,
+  // which is usually already signed in when this function is called.
+  std::string error;
+  const auto& session = find_session(api_url, options, error);
+  if (!session) {
+    throw std::runtime_error(error);
   }
-  for (const auto& element : platform.elements()) {
+  Platform platform(api_url, *session);
+  platform.set_params(options.team, options.suite, options.revision);
+  const auto& cache_path =
+      options.cache_dir.empty()
+          ? std::string()
+          : (touca::filesystem::path(options.cache_dir) / options.team /
+             options.suite / "elements.json")
+                .string();
+  for (const auto& element : platform.elements(cache_path)) {
     out.push_back(element);
   }
   return out;
@@ -49,4 +69,144 @@ std::vector<std::string> get_testsuite_local(
   return out;
 }
 
+std::unordered_map<std::string, unsigned long long> load_durations(
+    const touca::filesystem::path& path) {
+  if (!touca::filesystem::is_regular_file(path)) {
+    throw std::runtime_error("durations file not found: " + path.string());
+  }
+  const auto& content = touca::detail::load_string_file(path.string());
+  rapidjson::Document parsed;
+  if (parsed.Parse<0>(content.c_str()).HasParseError() ||
+      !parsed.IsObject()) {
+    throw std::runtime_error("durations file is not a json object: " +
+                             path.string());
+  }
+  std::unordered_map<std::string, unsigned long long> out;
+  for (auto it = parsed.MemberBegin(); it != parsed.MemberEnd(); ++it) {
+    if (it->name.IsString() && it->value.IsUint64()) {
+      out.emplace(it->name.GetString(), it->value.GetUint64());
+    }
+  }
+  return out;
+}
+
+void save_durations(
+    const touca::filesystem::path& path,
+    const std::unordered_map<std::string, unsigned long long>& durations) {
+  // sort entries so that the file does not change needlessly between runs
+  const std::map<std::string, unsigned long long> sorted(durations.begin(),
+                                                         durations.end());
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  for (const auto& kvp : sorted) {
+    writer.Key(kvp.first.c_str(), kvp.first.size());
+    writer.Uint64(kvp.second);
+  }
+  writer.EndObject();
+  const auto& tmp_path = path.string() + ".tmp";
+  std::ofstream ofs(tmp_path, std::ios::trunc);
+  ofs << buffer.GetString() << '\n';
+  ofs.close();
+  if (!ofs) {
+    throw std::runtime_error("failed to write durations file: " + tmp_path);
+  }
+  touca::filesystem::rename(tmp_path, path);
+}
+
+/**
+ * Finds the expected duration of each testcase, using the average of
+ * known durations for testcases that have not been timed before.
+ */
+static std::vector<unsigned long long> expected_durations(
+    const std::vector<std::string>& testcases,
+    const std::unordered_map<std::string, unsigned long long>& durations) {
+  auto known_sum = 0ull;
+  auto known_count = 0ull;
+  for (const auto& testcase : testcases) {
+    const auto& it = durations.find(testcase);
+    if (it != durations.end()) {
+      known_sum += it->second;
+      known_count++;
+    }
+  }
+  const auto fallback = known_count ? known_sum / known_count : 1ull;
+  std::vector<unsigned long long> expected(testcases.size());
+  for (auto i = 0u; i < testcases.size(); i++) {
+    const auto& it = durations.find(testcases[i]);
+    expected[i] = it == durations.end() ? fallback : it->second;
+  }
+  return expected;
+}
+
+std::vector<std::string> order_by_duration(
+    const std::vector<std::string>& testcases,
+    const std::unordered_map<std::string, unsigned long long>& durations) {
+  if (durations.empty()) {
+    return testcases;
+  }
+  const auto& expected = expected_durations(testcases, durations);
+  std::vector<std::size_t> order(testcases.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+                   [&expected](const std::size_t a, const std::size_t b) {
+                     return expected[a] > expected[b];
+                   });
+  std::vector<std::string> out;
+  out.reserve(testcases.size());
+  for (const auto i : order) {
+    out.push_back(testcases[i]);
+  }
+  return out;
+}
+
+static std::uint64_t fnv1a(const std::string& value) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const auto ch : value) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::vector<std::string> select_shard(
+    const std::vector<std::string>& testcases, const unsigned shard_index,
+    const unsigned shard_count,
+    const std::unordered_map<std::string, unsigned long long>& durations) {
+  std::vector<std::string> out;
+  if (durations.empty()) {
+    for (const auto& testcase : testcases) {
+      if (fnv1a(testcase) % shard_count == shard_index) {
+        out.push_back(testcase);
+      }
+    }
+    return out;
+  }
+
+  const auto& expected = expected_durations(testcases, durations);
+  std::vector<std::size_t> order(testcases.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(),
+            [&](const std::size_t a, const std::size_t b) {
+              if (expected[a] != expected[b]) {
+                return expected[a] > expected[b];
+              }
+              return testcases[a] < testcases[b];
+            });
+
+  std::vector<unsigned long long> loads(shard_count, 0u);
+  std::vector<bool> selected(testcases.size(), false);
+  for (const auto i : order) {
+    const auto& shard = std::min_element(loads.begin(), loads.end());
+    *shard += expected[i];
+    selected[i] = shard - loads.begin() == shard_index;
+  }
+  for (auto i = 0u; i < testcases.size(); i++) {
+    if (selected[i]) {
+      out.push_back(testcases[i]);
+    }
+  }
+  return out;
+}
+
 }  // namespace touca
@@ -0,0 +1,514 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "fmt/format.h"
+#include "touca/runner/detail/helpers.hpp"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace touca {
+
+#ifndef _WIN32
+
+static bool write_all(const int fd, const void* data, std::size_t size) {
+  auto ptr = static_cast<const char*>(data);
+  while (size != 0u) {
+    const auto count = write(fd, ptr, size);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    ptr += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+static bool read_all(const int fd, void* data, std::size_t size) {
+  auto ptr = static_cast<char*>(data);
+  while (size != 0u) {
+    const auto count = read(fd, ptr, size);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    ptr += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+static bool write_u32(const int fd, const std::uint32_t value) {
+  return write_all(fd, &value, sizeof(value));
+}
+
+static bool read_u32(const int fd, std::uint32_t& value) {
+  return read_all(fd, &value, sizeof(value));
+}
+
+static bool write_bytes(const int fd, const void* data,
+                        const std::size_t size) {
+  return write_u32(fd, static_cast<std::uint32_t>(size)) &&
+         write_all(fd, data, size);
+}
+
+template <typename Buffer>
+static bool read_bytes(const int fd, Buffer& buffer) {
+  std::uint32_t size = 0u;
+  if (!read_u32(fd, size)) {
+    return false;
+  }
+  buffer.resize(size);
+  return size == 0u || read_all(fd, &buffer[0], size);
+}
+
+/**
+ * Sends a request to the process that forks workers, along with the given
+ * descriptors, if any, for the next worker to use.
+ */
+static bool send_command(const int socket, char command, const int* fds,
+                         const std::size_t count) {
+  iovec io{&command, 1u};
+  union {
+    char buffer[CMSG_SPACE(2u * sizeof(int))];
+    cmsghdr align;
+  } control;
+  std::memset(&control, 0, sizeof(control));
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &io;
+  msg.msg_iovlen = 1;
+  if (count != 0u) {
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = CMSG_SPACE(count * sizeof(int));
+    auto header = CMSG_FIRSTHDR(&msg);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(count * sizeof(int));
+    std::memcpy(CMSG_DATA(header), fds, count * sizeof(int));
+  }
+  while (true) {
+    const auto sent = sendmsg(socket, &msg, 0);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    return sent == 1;
+  }
+}
+
+/**
+ * Receives a request sent by `send_command`. Only calls functions that are
+ * safe to call in a process forked from a multi-threaded program.
+ */
+static bool receive_command(const int socket, char& command, int* fds,
+                            const std::size_t count) {
+  iovec io{&command, 1u};
+  union {
+    char buffer[CMSG_SPACE(2u * sizeof(int))];
+    cmsghdr align;
+  } control;
+  std::memset(&control, 0, sizeof(control));
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &io;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+  ssize_t received = 0;
+  while ((received = recvmsg(socket, &msg, 0)) < 0 && errno == EINTR) {
+  }
+  if (received != 1) {
+    return false;
+  }
+  for (auto i = 0u; i < count; ++i) {
+    fds[i] = -1;
+  }
+  for (auto header = CMSG_FIRSTHDR(&msg); header != nullptr;
+       header = CMSG_NXTHDR(&msg, header)) {
+    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS &&
+        header->cmsg_len == CMSG_LEN(count * sizeof(int))) {
+      std::memcpy(fds, CMSG_DATA(header), count * sizeof(int));
+    }
+  }
+  return true;
+}
+
+static std::string describe_exit(const int status) {
+  if (WIFSIGNALED(status)) {
+    const auto signal = WTERMSIG(status);
+    return fmt::format("worker process terminated by signal {} ({})", signal,
+                       strsignal(signal));
+  }
+  if (WIFEXITED(status)) {
+    return fmt::format("worker process exited with code {}",
+                       WEXITSTATUS(status));
+  }
+  return "worker process terminated unexpectedly";
+}
+
+WorkerPool::WorkerPool(const unsigned size, Task task)
+    : _task(std::move(task)), _workers(size == 0u ? 1u : size) {
+  // writing to the pipe of a worker that has crashed should fail with an
+  // error instead of terminating the runner.
+  _sigpipe = std::signal(SIGPIPE, SIG_IGN);
+  start_spawner();
+  try {
+    for (auto& worker : _workers) {
+      spawn(worker);
+    }
+  } catch (...) {
+    for (auto& worker : _workers) {
+      stop(worker);
+    }
+    stop_spawner();
+    std::signal(SIGPIPE, _sigpipe);
+    throw;
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  for (auto& worker : _workers) {
+    stop(worker);
+  }
+  stop_spawner();
+  std::signal(SIGPIPE, _sigpipe);
+}
+
+void WorkerPool::start_spawner() {
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+    throw std::runtime_error("failed to create socket for worker processes");
+  }
+  // content buffered in the runner would otherwise be written once more
+  // by every worker process.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  const auto pid = fork();
+  if (pid < 0) {
+    close(sockets[0]);
+    close(sockets[1]);
+    throw std::runtime_error("failed to create worker process");
+  }
+  if (pid == 0) {
+    close(sockets[0]);
+    run_spawner(sockets[1]);
+  }
+  close(sockets[1]);
+  _spawner = pid;
+  _control = sockets[0];
+}
+
+void WorkerPool::stop_spawner() {
+  if (_spawner == -1) {
+    return;
+  }
+  // the spawner exits once it reads the end of its socket.
+  close(_control);
+  int status = 0;
+  while (waitpid(_spawner, &status, 0) < 0 && errno == EINTR) {
+  }
+  _spawner = -1;
+  _control = -1;
+}
+
+void WorkerPool::run_spawner(const int control) {
+  while (true) {
+    char command = 0;
+    int fds[2];
+    if (!receive_command(control, command, fds, 2u)) {
+      break;
+    }
+    std::uint32_t value = 0u;
+    if (command == 's') {
+      if (fds[0] == -1 || fds[1] == -1) {
+        break;
+      }
+      const auto pid = fork();
+      if (pid == 0) {
+        close(control);
+        serve(fds[0], fds[1]);
+      }
+      close(fds[0]);
+      close(fds[1]);
+      value = static_cast<std::uint32_t>(pid);
+    } else if (command == 'w') {
+      if (!read_u32(control, value)) {
+        break;
+      }
+      int status = 0;
+      while (waitpid(static_cast<pid_t>(value), &status, 0) < 0 &&
+             errno == EINTR) {
+      }
+      value = static_cast<std::uint32_t>(status);
+    } else {
+      break;
+    }
+    if (!write_u32(control, value)) {
+      break;
+    }
+  }
+  // workers that are still running exit once the runner closes their pipes.
+  _exit(0);
+}
+
+int WorkerPool::reap(Worker& worker) {
+  close(worker.request);
+  close(worker.response);
+  std::uint32_t status = 0u;
+  const auto pid = static_cast<std::uint32_t>(worker.pid);
+  worker.pid = -1;
+  worker.busy = false;
+  if (!send_command(_control, 'w', nullptr, 0u) || !write_u32(_control, pid) ||
+      !read_u32(_control, status)) {
+    throw std::runtime_error("lost connection to worker processes");
+  }
+  return static_cast<int>(status);
+}
+
+bool WorkerPool::has_idle_worker() const {
+  for (const auto& worker : _workers) {
+    if (!worker.busy) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WorkerPool::has_busy_worker() const {
+  for (const auto& worker : _workers) {
+    if (worker.busy) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkerPool::spawn(Worker& worker) {
+  int request[2];
+  int response[2];
+  if (pipe(request) != 0) {
+    throw std::runtime_error("failed to create pipe for worker process");
+  }
+  if (pipe(response) != 0) {
+    close(request[0]);
+    close(request[1]);
+    throw std::runtime_error("failed to create pipe for worker process");
+  }
+  const int fds[] = {request[0], response[1]};
+  const auto sent = send_command(_control, 's', fds, 2u);
+  close(request[0]);
+  close(response[1]);
+  std::uint32_t value = 0u;
+  if (!sent || !read_u32(_control, value)) {
+    close(request[1]);
+    close(response[0]);
+    throw std::runtime_error("lost connection to worker processes");
+  }
+  const auto pid = static_cast<int>(value);
+  if (pid < 0) {
+    close(request[1]);
+    close(response[0]);
+    throw std::runtime_error("failed to create worker process");
+  }
+  worker.pid = pid;
+  worker.request = request[1];
+  worker.response = response[0];
+  worker.busy = false;
+}
+
+void WorkerPool::stop(Worker& worker) {
+  if (worker.pid == -1) {
+    return;
+  }
+  // closing the request pipe lets the worker exit once it is done.
+  reap(worker);
+}
+
+void WorkerPool::serve(const int request, const int response) {
+  while (true) {
+    std::string testcase;
+    if (!read_bytes(request, testcase)) {
+      break;
+    }
+    std::vector<std::string> errors;
+    std::vector<std::uint8_t> message;
+    try {
+      _task(testcase, errors, message);
+    } catch (const std::exception& ex) {
+      errors.emplace_back(ex.what());
+    } catch (...) {
+      errors.emplace_back("unknown exception");
+    }
+    auto ok = write_u32(response, static_cast<std::uint32_t>(errors.size()));
+    for (const auto& error : errors) {
+      ok = ok && write_bytes(response, error.data(), error.size());
+    }
+    ok = ok && write_bytes(response, message.data(), message.size());
+    if (!ok) {
+      break;
+    }
+  }
+  // skip destructors and exit handlers inherited from the runner.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  _exit(0);
+}
+
+void WorkerPool::submit(const unsigned index, const std::string& testcase,
+                        const std::chrono::milliseconds timeout) {
+  for (auto& worker : _workers) {
+    if (worker.busy) {
+      continue;
+    }
+    if (!write_bytes(worker.request, testcase.data(), testcase.size())) {
+      stop(worker);
+      spawn(worker);
+      if (!write_bytes(worker.request, testcase.data(), testcase.size())) {
+        throw std::runtime_error("failed to send testcase to worker process");
+      }
+    }
+    worker.busy = true;
+    worker.index = index;
+    worker.testcase = testcase;
+    worker.has_deadline = timeout.count() != 0;
+    worker.deadline = std::chrono::steady_clock::now() + timeout;
+    return;
+  }
+  throw std::logic_error("no idle worker process");
+}
+
+WorkerPool::Result WorkerPool::wait() {
+  std::vector<pollfd> fds;
+  std::vector<Worker*> busy;
+  for (auto& worker : _workers) {
+    if (worker.busy) {
+      fds.push_back({worker.response, POLLIN, 0});
+      busy.push_back(&worker);
+    }
+  }
+  if (busy.empty()) {
+    throw std::logic_error("no busy worker process");
+  }
+
+  Result result;
+  while (true) {
+    // wait no longer than the earliest deadline of busy workers
+    const auto& now = std::chrono::steady_clock::now();
+    auto wait_ms = -1;
+    for (const auto& worker : busy) {
+      if (!worker->has_deadline) {
+        continue;
+      }
+      if (worker->deadline <= now) {
+        expire(*worker, result);
+        return result;
+      }
+      const auto& remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              worker->deadline - now)
+              .count() +
+          1;
+      if (wait_ms == -1 || remaining < wait_ms) {
+        wait_ms = static_cast<int>(remaining);
+      }
+    }
+    const auto ready = poll(fds.data(), fds.size(), wait_ms);
+    if (ready < 0 && errno != EINTR) {
+      throw std::runtime_error("failed to wait for worker processes");
+    }
+    if (ready > 0) {
+      break;
+    }
+  }
+  auto pos = 0u;
+  while (fds[pos].revents == 0) {
+    ++pos;
+  }
+  auto& worker = *busy[pos];
+  result.index = worker.index;
+  result.testcase = worker.testcase;
+  worker.busy = false;
+
+  std::uint32_t count = 0u;
+  auto ok = read_u32(worker.response, count);
+  for (auto i = 0u; ok && i < count; ++i) {
+    std::string error;
+    ok = read_bytes(worker.response, error);
+    result.errors.push_back(std::move(error));
+  }
+  ok = ok && read_bytes(worker.response, result.message);
+  if (ok) {
+    return result;
+  }
+
+  result.errors = {describe_exit(reap(worker))};
+  result.message.clear();
+  spawn(worker);
+  return result;
+}
+
+void WorkerPool::expire(Worker& worker, Result& result) {
+  result.index = worker.index;
+  result.testcase = worker.testcase;
+  result.timed_out = true;
+  ::kill(worker.pid, SIGKILL);
+  stop(worker);
+  spawn(worker);
+}
+
+#else
+
+WorkerPool::WorkerPool(const unsigned, Task) {
+  throw std::runtime_error(
+      "isolating testcases is not supported on this platform");
+}
+
+WorkerPool::~WorkerPool() {}
+
+bool WorkerPool::has_idle_worker() const { return false; }
+
+bool WorkerPool::has_busy_worker() const { return false; }
+
+void WorkerPool::start_spawner() {}
+
+void WorkerPool::stop_spawner() {}
+
+void WorkerPool::run_spawner(const int) {}
+
+int WorkerPool::reap(Worker&) { return 0; }
+
+void WorkerPool::spawn(Worker&) {}
+
+void WorkerPool::stop(Worker&) {}
+
+void WorkerPool::serve(const int, const int) {}
+
+void WorkerPool::expire(Worker&, Result&) {}
+
+void WorkerPool::submit(const unsigned, const std::string&,
+                        const std::chrono::milliseconds) {}
+
+WorkerPool::Result WorkerPool::wait() { return {}; }
+
+#endif
+
+}  // namespace touca
@@ -2,6 +2,9 @@
 
 #include "touca/touca.hpp"
 
+#include <atomic>
+#include <mutex>
+
 #include "touca/client/detail/client.hpp"
 #include "touca/core/utils.hpp"
 
@@ -9,76 +12,139 @@ namespace touca {
 
 static ClientImpl instance;
 
-void configure(const ClientImpl::OptionsMap& opts) { instance.configure(opts); }
+/** scope whose client calls made on this thread are routed to, if any */
+static thread_local ClientScope* scoped = nullptr;
+
+/** number of scopes that route calls to clients other than `instance` */
+static std::atomic<unsigned> active_scopes{0u};
+
+static ClientImpl& current() {
+  if (scoped) {
+    return *scoped->client();
+  }
+  // threads spawned by workflows that run in parallel do not inherit the
+  // client of their workflow. their results would be silently dropped.
+  if (active_scopes.load(std::memory_order_relaxed) &&
+      !instance.is_configured()) {
+    static std::once_flag warned;
+    std::call_once(warned, [] {
+      touca::print_warning(
+          "results captured on a thread without a client are dropped. use "
+          "touca::bind_client to run tasks of a workflow on other "
+          "threads.\n");
+    });
+  }
+  return instance;
+}
+
+ClientScope::ClientScope(const std::shared_ptr<ClientImpl>& client)
+    : _client(client), _previous(scoped) {
+  if (_client) {
+    scoped = this;
+    ++active_scopes;
+  }
+}
+
+ClientScope::~ClientScope() {
+  if (_client) {
+    --active_scopes;
+  }
+  scoped = _previous;
+}
+
+void ClientScope::reset() {
+  scoped = nullptr;
+  active_scopes = 0u;
+}
+
+std::function<void()> bind_client(const std::function<void()>& task) {
+  const auto& client = scoped ? scoped->client() : nullptr;
+  return [client, task]() {
+    ClientScope scope(client);
+    task();
+  };
+}
+
+void configure(const ClientImpl::OptionsMap& opts) {
+  current().configure(opts);
+}
 
-void configure(const ClientOptions& options) { instance.configure(options); }
+void configure(const ClientOptions& options) { current().configure(options); }
 
-void configure(const std::string& path) { instance.configure_by_file(path); }
+void configure(const std::string& path) { current().configure_by_file(path); }
 
-bool is_configured() { return instance.is_configured(); }
+bool is_configured() { return current().is_configured(); }
 
-std::string configuration_error() { return instance.configuration_error(); }
+std::string configuration_error() { return current().configuration_error(); }
 
 void add_logger(const std::shared_ptr<logger> logger) {
-  instance.add_logger(logger);
+  current().add_logger(logger);
 }
 
-std::vector<std::string> get_testcases() { return instance.get_testcases(); }
+std::vector<std::string> get_testcases() { return current().get_testcases(); }
 
 void declare_testcase(const std::string& name) {
-  instance.declare_testcase(name);
+  current().declare_testcase(name);
 }
 
 void forget_testcase(const std::string& name) {
-  instance.forget_testcase(name);
+  current().forget_testcase(name);
+}
+
+std::shared_ptr<Testcase> find_testcase(const std::string& name) {
+  return current().find_testcase(name);
+}
+
+void adopt_testcase(const std::shared_ptr<Testcase>& testcase) {
+  current().adopt_testcase(testcase);
 }
 
 namespace detail {
 
 void check(const std::string& key, const data_point& value) {
-  instance.check(key, value);
+  current().check(key, value);
 }
 
 void assume(const std::string& key, const data_point& value) {
-  instance.assume(key, value);
+  current().assume(key, value);
 }
 
 void add_array_element(const std::string& key, const data_point& value) {
-  instance.add_array_element(key, value);
+  current().add_array_element(key, value);
 }
 
 }  // namespace detail
 
-void add_hit_count(const std::string& key) { instance.add_hit_count(key); }
+void add_hit_count(const std::string& key) { current().add_hit_count(key); }
 
 void add_metric(const std::string& key, const unsigned duration) {
-  instance.add_metric(key, duration);
+  current().add_metric(key, duration);
 }
 
-void start_timer(const std::string& key) { instance.start_timer(key); }
+void start_timer(const std::string& key) { current().start_timer(key); }
 
-void stop_timer(const std::string& key) { instance.stop_timer(key); }
+void stop_timer(const std::string& key) { current().stop_timer(key); }
 
 void save_binary(const std::string& path,
                  const std::vector<std::string>& testcases,
                  const bool overwrite) {
-  return instance.save(path, testcases, DataFormat::FBS, overwrite);
+  return current().save(path, testcases, DataFormat::FBS, overwrite);
 }
 
 void save_json(const std::string& path,
                const std::vector<std::string>& testcases,
                const bool overwrite) {
-  return instance.save(path, testcases, DataFormat::JSON, overwrite);
+  return current().save(path, testcases, DataFormat::JSON, overwrite);
 }
 
-bool post() { return instance.post(); }
+bool post() { return current().post(); }
 
-bool seal() { return instance.seal(); }
+bool seal() { return current().seal(); }
 
 scoped_timer::scoped_timer(const std::string& name) : _name(name) {
-  instance.start_timer(_name);
+  current().start_scope(_name);
 }
 
-scoped_timer::~scoped_timer() { instance.stop_timer(_name); }
+scoped_timer::~scoped_timer() { current().stop_scope(_name); }
 
 }  // namespace touca
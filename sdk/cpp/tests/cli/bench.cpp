@@ -0,0 +1,62 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/cli/operations.hpp"
+#include "touca/cli/resultfile.hpp"
+#include "touca/cli/server.hpp"
+
+static bool run_bench(std::vector<std::string> args) {
+  args.insert(args.begin(), {"touca_cli", "--mode=bench-submit"});
+  std::vector<char*> argv;
+  for (auto& arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  const auto& operation = Operation::make(Operation::Command::bench_submit);
+  return operation->parse(static_cast<int>(argv.size()), argv.data()) &&
+         operation->run();
+}
+
+TEST_CASE("bench-submit") {
+  TmpFile dir;
+  touca::SubmissionServer::Options server_options;
+  server_options.dir = dir.path;
+  server_options.api_key = "some-key";
+
+  SECTION("submits synthesized testcases") {
+    touca::SubmissionServer server(server_options);
+    server.start();
+    CHECK(run_bench({"--api-url", server.url() + "/@/some-team/some-suite/1.0",
+                     "--api-key", "some-key", "--testcases", "25", "--keys",
+                     "3", "--shape", "object", "--batch", "10",
+                     "--concurrency", "2"}));
+    server.stop();
+
+    const auto& stats = server.stats();
+    CHECK(stats.submissions == 3u);
+    CHECK(stats.testcases == 25u);
+    CHECK(stats.rejected == 0u);
+    touca::ResultFile file(dir.path / "some-team" / "some-suite" / "1.0" /
+                           "touca.results");
+    REQUIRE(file.validate());
+    const auto& testcases = file.parse();
+    CHECK(testcases.size() == 25u);
+    CHECK(testcases.count("case-0"));
+    CHECK(testcases.count("case-24"));
+  }
+
+  SECTION("invalid-api-key") {
+    touca::SubmissionServer server(server_options);
+    server.start();
+    CHECK_FALSE(run_bench({"--api-url", server.url(), "--api-key",
+                           "some-other-key", "--testcases", "5"}));
+    CHECK(server.stats().submissions == 0u);
+  }
+
+  SECTION("invalid-shape") {
+    CHECK_FALSE(run_bench({"--shape", "some-shape"}));
+  }
+}
@@ -2,8 +2,11 @@
 
 #include "touca/cli/comparison.hpp"
 
+#include <sstream>
+
 #include "catch2/catch.hpp"
 #include "tests/core/shared.hpp"
+#include "touca/impl/comparison_schema.hpp"
 
 using touca::data_point;
 using touca::detail::internal_type;
@@ -82,4 +85,262 @@ TEST_CASE("Testcase Serialization") {
         R"({"keysCountCommon":1,"keysCountFresh":1,"keysCountMissing":1,"keysScore":0.0,"metricsCountCommon":1,"metricsCountFresh":1,"metricsCountMissing":1,"metricsDurationCommonDst":0,"metricsDurationCommonSrc":0})";
     CHECK_THAT(overview, Catch::Contains(check4));
   }
+
+  SECTION("compare: metric summaries") {
+    touca::Testcase dst("team", "suite", "version", "case");
+    dst.add_metric_summary("same", touca::MetricSummary::from_samples(
+                                       {100, 104, 98, 102, 101}));
+    dst.add_metric_summary("slower", touca::MetricSummary::from_samples(
+                                         {100, 104, 98, 102, 101}));
+    testcase.add_metric_summary("same", touca::MetricSummary::from_samples(
+                                            {101, 99, 105, 100, 103}));
+    testcase.add_metric_summary("slower", touca::MetricSummary::from_samples(
+                                              {150, 149, 155, 152, 151}));
+    touca::TestcaseComparison cmp(testcase, dst);
+    CHECK(cmp.overview().metricsCountCommon == 2);
+    CHECK(cmp.overview().metricsDurationCommonDst == 202);
+    CHECK(cmp.overview().metricsDurationCommonSrc == 252);
+
+    const auto& output = make_json(
+        [&cmp](touca::RJAllocator& allocator) { return cmp.json(allocator); });
+    CHECK_THAT(output, Catch::Contains(R"({"name":"same","score":1.0,)"));
+    CHECK_THAT(output, Catch::Contains("statistically significant"));
+  }
+
+  SECTION("compare: counters") {
+    touca::Testcase dst("team", "suite", "version", "case");
+    dst.add_counter("same.instructions", 100000u);
+    dst.add_counter("more.instructions", 100000u);
+    testcase.add_counter("same.instructions", 100500u);
+    testcase.add_counter("more.instructions", 103000u);
+    touca::TestcaseComparison cmp(testcase, dst);
+    CHECK(cmp.overview().metricsCountCommon == 2);
+    CHECK(cmp.overview().metricsDurationCommonSrc == 0);
+
+    const auto& output = make_json(
+        [&cmp](touca::RJAllocator& allocator) { return cmp.json(allocator); });
+    CHECK_THAT(output,
+               Catch::Contains(R"({"name":"same.instructions","score":1.0,)"));
+    CHECK_THAT(output, Catch::Contains("3.000000 percent"));
+  }
+
+  SECTION("compare: call trees") {
+    touca::Testcase dst("team", "suite", "version", "case");
+    dst.add_profile_sample("main", 10000, 2000);
+    dst.add_profile_sample("main;parse", 3000, 3000);
+    dst.add_profile_sample("main;solve", 5000, 5000);
+    testcase.add_profile_sample("main", 12000, 1000);
+    testcase.add_profile_sample("main;parse", 3100, 3100);
+    testcase.add_profile_sample("main;solve", 6000, 6000);
+    testcase.add_profile_sample("main;solve", 1900, 1900);
+    testcase.add_profile_sample("main;print", 100, 100);
+    touca::TestcaseComparison cmp(testcase, dst);
+    CHECK(cmp.overview().metricsDurationCommonDst == 10);
+    CHECK(cmp.overview().metricsDurationCommonSrc == 12);
+
+    const auto& output = make_json(
+        [&cmp](touca::RJAllocator& allocator) { return cmp.json(allocator); });
+    CHECK_THAT(output, Catch::Contains("new call path main;print"));
+    CHECK_THAT(output, Catch::Contains(
+                           "main;solve: number of calls changed from 1 to 2"));
+    CHECK_THAT(output,
+               Catch::Contains("main: total duration changed from 10.0ms"));
+    CHECK_THAT(output, Catch::Contains(R"("score":0.25)"));
+  }
+}
+
+TEST_CASE("binary-comparison") {
+  touca::Testcase src("team", "suite", "v1", "case");
+  touca::Testcase dst("team", "suite", "v2", "case");
+  src.check("same", data_point::string("leo-ferre"));
+  dst.check("same", data_point::string("leo-ferre"));
+  src.check("changed", data_point::number_signed(1));
+  dst.check("changed", data_point::number_signed(2));
+  src.check("new", data_point::boolean(true));
+  const touca::Testcase other("team", "suite", "v2", "other-case");
+
+  std::stringstream stream;
+  touca::ComparisonWriter writer(stream,
+                                 touca::ComparisonWriter::Format::binary);
+  writer.add_missing(other.metadata());
+  writer.add_common(touca::TestcaseComparison(src, dst));
+  writer.close();
+
+  touca::ComparisonReader reader(stream);
+  const auto missing = reader.next();
+  REQUIRE(missing);
+  CHECK(missing->category() == touca::fbs::ComparisonCategory::Missing);
+  CHECK_FALSE(missing->src());
+  CHECK(missing->dst()->testcase()->str() == "other-case");
+
+  const auto common = reader.next();
+  REQUIRE(common);
+  CHECK(common->category() == touca::fbs::ComparisonCategory::Common);
+  CHECK(common->src()->version()->str() == "v1");
+  CHECK(common->overview()->keysCountCommon() == 2);
+  CHECK(common->overview()->keysCountFresh() == 1);
+  CHECK(common->overview()->keysScore() == Approx(0.5));
+  const auto& keys = *common->results()->commonKeys();
+  REQUIRE(keys.size() == 2u);
+  for (const auto&& key : keys) {
+    if (key->name()->str() == "same") {
+      CHECK(key->match() == touca::fbs::MatchType::Perfect);
+      CHECK_FALSE(key->srcValue());
+      CHECK_FALSE(key->dstValue());
+    } else {
+      CHECK(key->match() == touca::fbs::MatchType::None);
+      CHECK(key->srcType() == touca::fbs::ValueType::Number);
+      CHECK(key->srcValue()->str() == "1");
+      CHECK(key->dstValue()->str() == "2");
+    }
+  }
+  REQUIRE(common->results()->newKeys()->size() == 1u);
+  CHECK(common->results()->newKeys()->Get(0)->value()->str() == "true");
+
+  CHECK_FALSE(reader.next());
+
+  std::istringstream invalid("some-content");
+  CHECK_THROWS_AS(touca::ComparisonReader(invalid), std::runtime_error);
+}
+
+TEST_CASE("Compare Deserialized Data Types") {
+  using namespace touca;
+
+  // comparing a value with its own deserialized copy reports a perfect
+  // match and only describes the source value.
+  const auto& check_perfect = [](const data_point& value,
+                                 const internal_type type,
+                                 const std::string& expected) {
+    const auto& cmp = compare(value, deserialize(serialize(value)));
+    CHECK(type == cmp.srcType);
+    CHECK(internal_type::unknown == cmp.dstType);
+    CHECK(cmp.srcValue == expected);
+    CHECK(cmp.dstValue == "");
+    CHECK(MatchType::Perfect == cmp.match);
+    CHECK(cmp.score == 1.0);
+    CHECK(cmp.desc.empty());
+  };
+
+  SECTION("type: bool") {
+    check_perfect(data_point::boolean(true), internal_type::boolean, "true");
+  }
+
+  SECTION("type: number integer") {
+    check_perfect(data_point::number_signed(42), internal_type::number_signed,
+                  "42");
+  }
+
+  SECTION("type: double") {
+    check_perfect(data_point::number_double(1.0), internal_type::number_double,
+                  "1.0");
+  }
+
+  SECTION("type: string") {
+    check_perfect(data_point::string("some_value"), internal_type::string,
+                  "some_value");
+  }
+
+  SECTION("type: array") {
+    SECTION("compare: match value of type int") {
+      touca::array value;
+      for (const auto& v : {41, 42, 43, 44}) {
+        value.add(v);
+      }
+      check_perfect(value, internal_type::array, R"([41,42,43,44])");
+    }
+
+    SECTION("compare: match value of type float") {
+      touca::array value;
+      for (const auto& v : {1.1f, 1.2f, 1.3f, 1.4f}) {
+        value.add(v);
+      }
+      check_perfect(value, internal_type::array, R"([1.1,1.2,1.299,1.399])");
+    }
+
+    SECTION("compare: match value of type string") {
+      touca::array value;
+      for (const auto& v : {"a", "b", "c", "d"}) {
+        value.add(std::string(v));
+      }
+      check_perfect(value, internal_type::array, R"(["a","b","c","d"])");
+    }
+
+    SECTION("compare: match value of type bool") {
+      touca::array value;
+      for (const auto& v : {false, true, false, true}) {
+        value.add(serializer<bool>().serialize(v));
+      }
+      check_perfect(value, internal_type::array, R"([false,true,false,true])");
+    }
+  }
+
+  SECTION("type: object") {
+    SECTION("initialize: add number to object") {
+      touca::object value("creature");
+      CHECK_NOTHROW(data_point(value));
+      CHECK(flatten(value).empty());
+      CHECK(data_point(value).to_string() == R"({"creature":{}})");
+      value.add("number of heads", 1);
+      CHECK(flatten(value).count("number of heads"));
+      CHECK(data_point(value).to_string() ==
+            R"({"creature":{"number of heads":1}})");
+      value.add("number of tails", 0);
+      CHECK(flatten(value).count("number of tails"));
+      CHECK(data_point(value).to_string() ==
+            R"({"creature":{"number of heads":1,"number of tails":0}})");
+    }
+
+    SECTION("initialize: add object to object") {
+      touca::object value("creature");
+      CHECK(flatten(value).empty());
+      Head head1(2);
+      value.add("first_head", head1);
+      CHECK(flatten(value).count("first_head.eyes"));
+      CHECK(data_point(value).to_string() ==
+            R"({"creature":{"first_head":{"head":{"eyes":2}}}})");
+    }
+
+    SECTION("compare: match") {
+      touca::object value("creature");
+      value.add("first_head", Head(2));
+      touca::object right("some_other_creature");
+      right.add("first_head", Head(2));
+      const auto& cmp = compare(value, right);
+
+      CHECK(internal_type::object == cmp.srcType);
+      CHECK(internal_type::unknown == cmp.dstType);
+      CHECK(cmp.srcValue ==
+            R"({"creature":{"first_head":{"head":{"eyes":2}}}})");
+      CHECK(cmp.dstValue == R"()");
+      CHECK(MatchType::Perfect == cmp.match);
+      CHECK(cmp.score == 1.0);
+      CHECK(cmp.desc.empty());
+    }
+
+    SECTION("compare: mismatch value") {
+      touca::object value("creature");
+      value.add("first_head", Head(2));
+      touca::object right("some_other_creature");
+      right.add("first_head", Head(3));
+      const auto& cmp = compare(value, right);
+
+      CHECK(internal_type::object == cmp.srcType);
+      CHECK(internal_type::unknown == cmp.dstType);
+      CHECK(cmp.srcValue ==
+            R"({"creature":{"first_head":{"head":{"eyes":2}}}})");
+      CHECK(cmp.dstValue ==
+            R"({"some_other_creature":{"first_head":{"head":{"eyes":3}}}})");
+      CHECK(MatchType::None == cmp.match);
+      CHECK(cmp.score == 0.0);
+      CHECK(cmp.desc.size() == 1u);
+      CHECK(cmp.desc.count("first_head.eyes: value is smaller by 1.000000"));
+    }
+
+    SECTION("compare: match deserialized value") {
+      touca::object value("creature");
+      value.add("first_head", Head(2));
+      check_perfect(value, internal_type::object,
+                    R"({"creature":{"first_head":{"head":{"eyes":2}}}})");
+    }
+  }
 }
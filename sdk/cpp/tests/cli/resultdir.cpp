@@ -0,0 +1,88 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/cli/resultdir.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/cli/resultfile.hpp"
+
+using namespace touca;
+
+static std::shared_ptr<Testcase> make_testcase(const std::string& name,
+                                               const double value) {
+  const auto& testcase = std::make_shared<Testcase>(
+      "some-team", "some-suite", "some-version", name);
+  testcase->check("some-key", data_point::number_double(value));
+  return testcase;
+}
+
+static void save_testcase(const touca::filesystem::path& dir,
+                          const Testcase& testcase) {
+  const auto& case_dir = dir / testcase.metadata().testcase;
+  touca::filesystem::create_directories(case_dir);
+  ResultFile(case_dir / "touca.bin").save({testcase});
+}
+
+TEST_CASE("directory-comparison") {
+  TmpFile src_dir;
+  TmpFile dst_dir;
+  ElementsMap src_cases;
+  ElementsMap dst_cases;
+  for (const auto& name : {"case-1", "case-2", "case-3", "case-4"}) {
+    src_cases.emplace(name, make_testcase(name, 1.0));
+  }
+  for (const auto& name : {"case-2", "case-3", "case-4", "case-5"}) {
+    dst_cases.emplace(name, make_testcase(name, name[5] == '3' ? 2.0 : 1.0));
+  }
+  for (const auto& item : src_cases) {
+    save_testcase(src_dir.path, *item.second);
+  }
+  save_testcase(src_dir.path / ".trash", *make_testcase("case-6", 1.0));
+  save_testcase(dst_dir.path, *dst_cases.at("case-2"));
+  {
+    ResultLog log((dst_dir.path / "touca.results").string());
+    for (const auto& name : {"case-3", "case-4", "case-5"}) {
+      log.append(name, dst_cases.at(name)->flatbuffers());
+    }
+  }
+
+  ResultDirectory src(src_dir.path);
+  ResultDirectory dst(dst_dir.path);
+  CHECK(src.names() ==
+        std::vector<std::string>{"case-1", "case-2", "case-3", "case-4"});
+  CHECK(dst.names() ==
+        std::vector<std::string>{"case-2", "case-3", "case-4", "case-5"});
+  CHECK_FALSE(src.contains("case-6"));
+  CHECK(dst.read("case-5").metadata().testcase == "case-5");
+
+  SECTION("json") {
+    std::ostringstream out;
+    ComparisonWriter writer(out, ComparisonWriter::Format::json);
+    const auto& summary = compare(src, dst, writer, 3u);
+    writer.close();
+    CHECK(out.str() == compare(src_cases, dst_cases).json());
+    CHECK(summary.fresh == 1u);
+    CHECK(summary.missing == 1u);
+    CHECK(summary.common == 3u);
+    CHECK(summary.perfect == 2u);
+    CHECK(summary.errors.empty());
+  }
+
+  SECTION("unreadable-testcase") {
+    std::ofstream((src_dir.path / "case-2" / "touca.bin").string())
+        << "some-content";
+    std::ostringstream out;
+    ComparisonWriter writer(out, ComparisonWriter::Format::ndjson);
+    const auto& summary = compare(src, dst, writer, 2u);
+    writer.close();
+    CHECK(summary.common == 2u);
+    REQUIRE(summary.errors.size() == 1u);
+    CHECK_THAT(summary.errors.front(), Catch::StartsWith("case-2: "));
+    const auto& output = out.str();
+    CHECK(std::count(output.begin(), output.end(), '\n') == 4);
+  }
+}
@@ -2,9 +2,12 @@
 
 #include "touca/cli/resultfile.hpp"
 
+#include <sstream>
+
 #include "catch2/catch.hpp"
 #include "tests/core/tmpfile.hpp"
 #include "touca/client/detail/client.hpp"
+#include "touca/core/resultlog.hpp"
 
 using namespace touca;
 
@@ -40,3 +43,68 @@ TEST_CASE("Deserialize file") {
     CHECK(content.at("some-other-case")->overview().keysCount == 1);
   }
 }
+
+static Testcase make_testcase(const std::string& name, const double value) {
+  Testcase testcase("some-team", "some-suite", "some-version", name);
+  testcase.check("some-key", data_point::number_double(value));
+  return testcase;
+}
+
+TEST_CASE("streamed-comparison") {
+  TmpFile src_file;
+  TmpFile dst_file;
+  ResultFile(src_file.path)
+      .save({make_testcase("some-case", 1.0),
+             make_testcase("some-other-case", 2.0)});
+  {
+    ResultLog log(dst_file.path.string());
+    for (const auto& name : {"some-other-case", "some-third-case"}) {
+      log.append(name, make_testcase(name, 3.0).flatbuffers());
+    }
+  }
+  ResultReader src(src_file.path);
+  ResultReader dst(dst_file.path);
+  CHECK(src.names() ==
+        std::vector<std::string>{"some-case", "some-other-case"});
+  CHECK(dst.names() ==
+        std::vector<std::string>{"some-other-case", "some-third-case"});
+  CHECK(dst.read("some-third-case").metadata().testcase == "some-third-case");
+  CHECK_THROWS_AS(dst.read("some-case"), std::runtime_error);
+
+  SECTION("json") {
+    std::ostringstream out;
+    ComparisonWriter writer(out, ComparisonWriter::Format::json);
+    compare(src, dst, writer);
+    writer.close();
+    const auto& expected = touca::compare(ResultFile(src_file.path).parse(),
+                                          ResultFile(dst_file.path).parse());
+    CHECK(out.str() == expected.json());
+    CHECK_THROWS_AS(writer.add_fresh(src.read("some-case").metadata()),
+                    std::logic_error);
+  }
+
+  SECTION("ndjson") {
+    std::ostringstream out;
+    ComparisonWriter writer(out, ComparisonWriter::Format::ndjson);
+    compare(src, dst, writer);
+    writer.close();
+    std::istringstream in(out.str());
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+      lines.push_back(line);
+    }
+    REQUIRE(lines.size() == 3u);
+    CHECK_THAT(lines[0], Catch::StartsWith(R"({"newCase":{)"));
+    CHECK_THAT(lines[0], Catch::Contains(R"("testcase":"some-case")"));
+    CHECK_THAT(lines[1], Catch::StartsWith(R"({"missingCase":{)"));
+    CHECK_THAT(lines[2], Catch::StartsWith(R"({"commonCase":{)"));
+  }
+
+  SECTION("out-of-order") {
+    std::ostringstream out;
+    ComparisonWriter writer(out, ComparisonWriter::Format::json);
+    writer.add_missing(dst.read("some-third-case").metadata());
+    CHECK_THROWS_AS(writer.add_fresh(src.read("some-case").metadata()),
+                    std::logic_error);
+  }
+}
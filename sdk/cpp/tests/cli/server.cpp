@@ -0,0 +1,101 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/cli/server.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/cli/resultfile.hpp"
+#include "touca/client/detail/client.hpp"
+#include "touca/core/platform.hpp"
+
+static touca::ClientOptions make_options(const touca::SubmissionServer& server,
+                                         const std::string& version) {
+  touca::ClientOptions options;
+  options.api_url = server.url() + "/@/some-team/some-suite/" + version;
+  options.api_key = "some-key";
+  return options;
+}
+
+TEST_CASE("submission-server") {
+  TmpFile dir;
+  touca::SubmissionServer::Options server_options;
+  server_options.dir = dir.path;
+  server_options.api_key = "some-key";
+
+  SECTION("post-and-seal") {
+    touca::SubmissionServer server(server_options);
+    server.start();
+    touca::ClientImpl client;
+    auto options = make_options(server, "1.0");
+    options.testcases = {"some-case"};
+    REQUIRE(client.configure(options));
+    for (const auto& name : {"some-case", "some-other-case"}) {
+      client.declare_testcase(name);
+      client.check("some-key", touca::data_point::string(name));
+    }
+    CHECK(client.post());
+    CHECK(client.seal());
+    server.stop();
+
+    const auto& stats = server.stats();
+    CHECK(stats.submissions == 1u);
+    CHECK(stats.testcases == 2u);
+    CHECK(stats.rejected == 0u);
+    touca::ResultFile file(dir.path / "some-team" / "some-suite" / "1.0" /
+                           "touca.results");
+    REQUIRE(file.validate());
+    const auto& testcases = file.parse();
+    CHECK(testcases.count("some-case"));
+    CHECK(testcases.count("some-other-case"));
+  }
+
+  SECTION("elements-of-earlier-session") {
+    {
+      touca::SubmissionServer server(server_options);
+      server.start();
+      touca::ClientImpl client;
+      auto options = make_options(server, "1.0");
+      options.testcases = {"some-case"};
+      REQUIRE(client.configure(options));
+      client.declare_testcase("some-case");
+      CHECK(client.post());
+    }
+    touca::SubmissionServer server(server_options);
+    server.start();
+    touca::ClientImpl client;
+    REQUIRE(client.configure(make_options(server, "2.0")));
+    CHECK(client.get_testcases() == std::vector<std::string>{"some-case"});
+  }
+
+  SECTION("invalid-submission") {
+    touca::SubmissionServer server(server_options);
+    server.start();
+    touca::Platform platform(touca::ApiUrl(server.url()));
+    CHECK_FALSE(platform.auth("some-other-key"));
+    REQUIRE(platform.auth("some-key"));
+    touca::RetryPolicy policy;
+    policy.max_retries = 0u;
+    CHECK_FALSE(platform.submit("some-content", policy).empty());
+    CHECK(server.stats().rejected == 1u);
+    CHECK(server.stats().submissions == 0u);
+  }
+
+  SECTION("retried-submission") {
+    touca::SubmissionServer server(server_options);
+    server.start();
+    touca::ClientImpl client;
+    auto options = make_options(server, "1.0");
+    options.offline = true;
+    REQUIRE(client.configure(options));
+    client.declare_testcase("some-case");
+    const auto& content =
+        touca::Testcase::serialize({client.find_testcase("some-case")});
+    touca::Platform platform(touca::ApiUrl(server.url()));
+    REQUIRE(platform.auth("some-key"));
+    const std::string body(content.begin(), content.end());
+    CHECK(platform.submit(body, touca::RetryPolicy(), "some-key").empty());
+    CHECK(platform.submit(body, touca::RetryPolicy(), "some-key").empty());
+    CHECK(server.stats().submissions == 1u);
+    CHECK(server.stats().duplicates == 1u);
+  }
+}
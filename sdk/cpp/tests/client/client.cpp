@@ -4,6 +4,7 @@
 
 #include "catch2/catch.hpp"
 #include "tests/core/tmpfile.hpp"
+#include "touca/client/detail/counters.hpp"
 #include "touca/core/utils.hpp"
 
 using namespace touca;
@@ -108,6 +109,21 @@ TEST_CASE("using a configured client") {
     CHECK_THAT(content, Catch::Contains(expected));
   }
 
+  SECTION("perf counters") {
+    auto options = client.options();
+    options.perf_counters = true;
+    REQUIRE(client.configure(options));
+    const auto& tc = client.declare_testcase("some-case");
+    CHECK_NOTHROW(client.start_timer("a"));
+    CHECK_NOTHROW(client.stop_timer("a"));
+    CHECK(tc->metrics().count("a"));
+    // counters are only reported if the host lets us open them
+    const auto& counters = touca::detail::PerfCounters::local();
+    CHECK(tc->metrics().count("a.instructions") ==
+          (counters.available(touca::detail::PerfEvent::Instructions) ? 1u
+                                                                       : 0u));
+  }
+
   SECTION("forget_testcase") {
     client.declare_testcase("some-case");
     const auto& v1 = data_point::boolean(true);
@@ -0,0 +1,137 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/deserialize.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/serializer.hpp"
+
+using touca::detail::internal_type;
+
+TEST_CASE("Serialize and Deserialize Data Types") {
+  using namespace touca;
+
+  SECTION("type: null") {
+    auto value = data_point::null();
+    SECTION("initialize") {
+      CHECK(value.to_string() == "null");
+      CHECK(internal_type::null == value.type());
+    }
+  }
+
+  SECTION("type: bool") {
+    const auto& value = data_point::boolean(true);
+    SECTION("serialize") {
+      const auto& buffer = serialize(value);
+      const auto& deserialized = deserialize(buffer);
+      CHECK(internal_type::boolean == deserialized.type());
+      CHECK(deserialized.to_string() == "true");
+    }
+  }
+
+  SECTION("type: number integer") {
+    SECTION("serialize") {
+      const auto& value = data_point::number_signed(42);
+      const auto& buffer = serialize(value);
+      const auto& deserialized = deserialize(buffer);
+      CHECK(internal_type::number_signed == deserialized.type());
+      CHECK(deserialized.to_string() == "42");
+    }
+  }
+
+  SECTION("type: double") {
+    SECTION("serialize") {
+      const auto& value = data_point::number_double(1.0);
+      const auto& buffer = serialize(value);
+      const auto& deserialized = deserialize(buffer);
+      CHECK(internal_type::number_double == deserialized.type());
+      CHECK(deserialized.to_string() == "1.0");
+    }
+  }
+
+  SECTION("type: string") {
+    SECTION("serialize") {
+      const auto& value = data_point::string("some_value");
+      const auto& buffer = serialize(value);
+      const auto& deserialized = deserialize(buffer);
+      CHECK(internal_type::string == deserialized.type());
+      CHECK(deserialized.to_string() == "some_value");
+    }
+  }
+
+  SECTION("type: array") {
+    SECTION("serialize: value of type int") {
+      const auto& makeArray = [](const std::vector<int>& vec) -> data_point {
+        touca::array ret;
+        for (const auto& v : vec) {
+          ret.add(v);
+        }
+        return ret;
+      };
+      const auto& value = makeArray({41, 42, 43, 44});
+      const auto& buffer = serialize(value);
+      const auto& itype = deserialize(buffer);
+      CHECK(internal_type::array == itype.type());
+      CHECK(itype.to_string() == R"([41,42,43,44])");
+    }
+
+    SECTION("serialize: value of type float") {
+      const auto& makeArray = [](const std::vector<float>& vec) -> data_point {
+        touca::array ret;
+        for (const auto& v : vec) {
+          ret.add(v);
+        }
+        return ret;
+      };
+      const auto& value = makeArray({1.1f, 1.2f, 1.3f, 1.4f});
+      const auto& buffer = serialize(value);
+      const auto& itype = deserialize(buffer);
+      CHECK(internal_type::array == itype.type());
+      CHECK(itype.to_string() == R"([1.1,1.2,1.299,1.399])");
+    }
+
+    SECTION("serialize: value of type string") {
+      const auto& makeArray =
+          [](const std::vector<std::string>& vec) -> data_point {
+        touca::array ret;
+        for (const auto& v : vec) {
+          ret.add(v);
+        }
+        return ret;
+      };
+      const auto& value = makeArray({"a", "b", "c", "d"});
+      const auto& buffer = serialize(value);
+      const auto& itype = deserialize(buffer);
+      CHECK(internal_type::array == itype.type());
+      CHECK(itype.to_string() == R"(["a","b","c","d"])");
+    }
+
+    SECTION("serialize: value of type bool") {
+      const auto& makeArray = [](const std::vector<bool>& vec) -> data_point {
+        touca::array ret;
+        for (const auto&& v : vec) {
+          ret.add(serializer<bool>().serialize(v));
+        }
+        return ret;
+      };
+      const auto& value = makeArray({false, true, false, true});
+      const auto& buffer = serialize(value);
+      const auto& itype = deserialize(buffer);
+      CHECK(internal_type::array == itype.type());
+      CHECK(itype.to_string() == R"([false,true,false,true])");
+    }
+  }
+
+  SECTION("type: object") {
+    SECTION("serialize") {
+      touca::object value("creature");
+      value.add("first_head", Head(2));
+      const auto& buffer = serialize(value);
+      const auto& itype = deserialize(buffer);
+      CHECK(internal_type::object == itype.type());
+      CHECK(itype.to_string() ==
+            R"({"creature":{"first_head":{"head":{"eyes":2}}}})");
+    }
+  }
+}
@@ -127,6 +127,20 @@ TEST_CASE("configure") {
     CHECK(client.configure(input) == true);
     CHECK(opts.single_thread);
   }
+  SECTION("transport") {
+    CHECK(client.configure(input) == true);
+    CHECK(opts.max_inflight == 4);
+    input.emplace("connect-timeout", "3");
+    input.emplace("read-timeout", "30");
+    input.emplace("max-inflight", "8");
+    CHECK(client.configure(input) == true);
+    CHECK(opts.connect_timeout == 3);
+    CHECK(opts.read_timeout == 30);
+    CHECK(opts.max_inflight == 8);
+    input["max-inflight"] = "0";
+    CHECK(client.configure(input) == false);
+    CHECK_THAT(client.configuration_error(), Catch::Contains("max-inflight"));
+  }
 }
 
 TEST_CASE("configure-by-file") {
@@ -2,10 +2,15 @@
 
 #include "touca/core/platform.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/core/spool.hpp"
 
 void check_api(const touca::ApiUrl& api, const std::vector<std::string> parts) {
   REQUIRE(!api.root().empty());
@@ -112,3 +117,206 @@ TEST_CASE("platform") {
     CHECK(platform.has_token() == false);
   }
 }
+
+/**
+ * Transport that replies to queries, sign-ins and submissions with a given
+ * sequence of responses and records the entity tag of each query and the
+ * idempotency key of each submission.
+ */
+class ScriptedTransport : public touca::Transport {
+ public:
+  ScriptedTransport(const std::vector<touca::Response>& responses,
+                    std::vector<std::string>& keys)
+      : _responses(responses), _keys(keys) {}
+  void set_token(const std::string&) {}
+  touca::Response get(const std::string&,
+                      const touca::HttpHeaders& headers) const {
+    const auto& response = _responses.at(_keys.size());
+    const auto& it = headers.find("If-None-Match");
+    _keys.push_back(it == headers.end() ? "" : it->second);
+    return response;
+  }
+  touca::Response patch(const std::string&, const std::string&) const {
+    return {404, ""};
+  }
+  touca::Response post(const std::string&, const std::string&) const {
+    const auto& response = _responses.at(_keys.size());
+    _keys.push_back("");
+    return response;
+  }
+  touca::Response binary(const std::string&, const std::string&,
+                         const std::string& key) const {
+    const auto& response = _responses.at(_keys.size());
+    _keys.push_back(key);
+    return response;
+  }
+
+ private:
+  std::vector<touca::Response> _responses;
+  std::vector<std::string>& _keys;
+};
+
+TEST_CASE("platform-submit") {
+  touca::ApiUrl api("https://api.example.com/@/team/suite/revision");
+  touca::RetryPolicy policy;
+  policy.max_retries = 2u;
+  policy.base_delay = 1u;
+  policy.max_delay = 2u;
+  std::vector<std::string> keys;
+  const auto& make_platform =
+      [&api, &keys](const std::vector<touca::Response>& responses) {
+        return std::unique_ptr<touca::Platform>(new touca::Platform(
+            api, std::unique_ptr<touca::Transport>(
+                     new ScriptedTransport(responses, keys))));
+      };
+
+  SECTION("retries transient failures with the same key") {
+    const auto& platform = make_platform(
+        {{-1, "connection refused"}, {503, ""}, {204, ""}});
+    CHECK(platform->submit("content", policy).empty());
+    REQUIRE(keys.size() == 3u);
+    CHECK(keys.at(0).size() == 36u);
+    CHECK(keys.at(1) == keys.at(0));
+    CHECK(keys.at(2) == keys.at(0));
+  }
+
+  SECTION("uses a new key for each submission") {
+    const auto& platform = make_platform({{204, ""}, {204, ""}});
+    CHECK(platform->submit("content", policy).empty());
+    CHECK(platform->submit("content", policy).empty());
+    REQUIRE(keys.size() == 2u);
+    CHECK(keys.at(0) != keys.at(1));
+  }
+
+  SECTION("does not retry rejected submissions") {
+    const auto& platform = make_platform({{400, ""}, {204, ""}});
+    const auto& errors = platform->submit("content", policy);
+    CHECK(keys.size() == 1u);
+    REQUIRE(errors.size() == 2u);
+    CHECK_THAT(errors.at(0), Catch::Contains("400"));
+    CHECK_THAT(errors.at(1), Catch::Contains("giving up"));
+  }
+
+  SECTION("gives up after all retries") {
+    const auto& platform =
+        make_platform({{500, ""}, {429, ""}, {502, ""}, {204, ""}});
+    const auto& errors = platform->submit("content", policy);
+    CHECK(keys.size() == 3u);
+    CHECK(errors.size() == 4u);
+  }
+
+  SECTION("signs in again when the token is rejected") {
+    const auto& platform =
+        make_platform({{200, R"({"token":"some-token"})"},
+                       {401, ""},
+                       {200, R"({"token":"some-other-token"})"},
+                       {204, ""}});
+    REQUIRE(platform->auth("some-key"));
+    CHECK(platform->submit("content", policy).empty());
+    REQUIRE(keys.size() == 4u);
+    CHECK(keys.at(3) == keys.at(1));
+    CHECK(platform->has_token());
+  }
+
+  SECTION("keeps submissions that are not authorized") {
+    const auto& platform = make_platform(
+        {{200, R"({"token":"some-token"})"}, {401, ""}, {401, ""}});
+    REQUIRE(platform->auth("some-key"));
+    auto rejected = true;
+    CHECK_FALSE(platform->submit("content", policy, "", &rejected).empty());
+    CHECK_FALSE(rejected);
+    CHECK(keys.size() == 3u);
+    CHECK_FALSE(platform->has_token());
+  }
+
+  SECTION("honors retry-after") {
+    const auto& platform =
+        make_platform({{429, "", {{"retry-after", "1"}}}, {204, ""}});
+    const auto& tic = std::chrono::steady_clock::now();
+    CHECK(platform->submit("content", policy).empty());
+    CHECK(std::chrono::steady_clock::now() - tic >= std::chrono::seconds(1));
+  }
+
+  SECTION("bounds retry-after") {
+    policy.max_retry_after = 1u;
+    const auto& platform = make_platform(
+        {{503, "", {{"retry-after", "3600"}}},
+         {503, "", {{"retry-after", "184467440737095516160"}}},
+         {204, ""}});
+    const auto& tic = std::chrono::steady_clock::now();
+    CHECK(platform->submit("content", policy).empty());
+    const auto& elapsed = std::chrono::steady_clock::now() - tic;
+    CHECK(elapsed >= std::chrono::seconds(2));
+    CHECK(elapsed < std::chrono::seconds(10));
+  }
+}
+
+TEST_CASE("spool") {
+  TmpFile dir;
+  touca::Spool spool(dir.path);
+  spool.push("first");
+  spool.push("second");
+  spool.push("third");
+  REQUIRE(spool.pending().size() == 3u);
+  touca::ApiUrl api("https://api.example.com/@/team/suite/revision");
+  std::vector<std::string> keys;
+  const auto& make_transport =
+      [&keys](const std::vector<touca::Response>& responses) {
+        return std::unique_ptr<touca::Transport>(
+            new ScriptedTransport(responses, keys));
+      };
+
+  SECTION("moves rejected submissions aside") {
+    touca::Platform platform(
+        api, make_transport({{204, ""}, {400, ""}, {204, ""}}));
+    std::vector<std::string> errors;
+    std::vector<std::string> rejections;
+    CHECK(spool.replay(platform, errors, rejections) == 2u);
+    CHECK(errors.empty());
+    REQUIRE_FALSE(rejections.empty());
+    CHECK_THAT(rejections.back(),
+               Catch::Contains("moved rejected submission"));
+    CHECK(spool.pending().empty());
+    REQUIRE(keys.size() == 3u);
+    CHECK(keys.at(0) < keys.at(1));
+    CHECK(keys.at(1) < keys.at(2));
+    const auto& failed = dir.path / "failed" / (keys.at(1) + ".bin");
+    CHECK(touca::filesystem::is_regular_file(failed));
+  }
+
+  SECTION("replays submissions in the background") {
+    touca::Platform platform(
+        api, make_transport({{204, ""}, {204, ""}, {204, ""}, {204, ""}}));
+    touca::SpoolSubmitter submitter(platform, spool);
+    spool.push("fourth");
+    submitter.notify();
+    std::vector<std::string> rejections;
+    CHECK(submitter.flush(&rejections).empty());
+    CHECK(rejections.empty());
+    CHECK(spool.pending().empty());
+    CHECK(keys.size() == 4u);
+    CHECK(std::is_sorted(keys.begin(), keys.end()));
+  }
+}
+
+TEST_CASE("platform-elements") {
+  TmpFile dir;
+  const auto& cache_path = (dir.path / "elements.json").string();
+  touca::ApiUrl api("https://api.example.com/@/team/suite/revision");
+  std::vector<std::string> keys;
+  const auto& body = R"([{"name":"case-1"},{"name":"case-2"}])";
+  touca::Platform platform(
+      api, std::unique_ptr<touca::Transport>(new ScriptedTransport(
+               {{200, body, {{"etag", "\"v1\""}}},
+                {304, ""},
+                {200, R"([{"name":"case-3"}])", {{"etag", "\"v2\""}}}},
+               keys)));
+  const std::vector<std::string> expected = {"case-1", "case-2"};
+  CHECK(platform.elements(cache_path) == expected);
+  CHECK(platform.elements(cache_path) == expected);
+  CHECK(platform.elements(cache_path) == std::vector<std::string>{"case-3"});
+  REQUIRE(keys.size() == 3u);
+  CHECK(keys.at(0).empty());
+  CHECK(keys.at(1) == "\"v1\"");
+  CHECK(keys.at(2) == "\"v1\"");
+}
@@ -0,0 +1,87 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/resultlog.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/tmpfile.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/testcase.hpp"
+
+static std::vector<uint8_t> make_message(const std::string& name,
+                                         const std::int64_t value) {
+  touca::Testcase testcase("some-team", "some-suite", "some-version", name);
+  testcase.check("some-key", touca::data_point::number_signed(value));
+  return testcase.flatbuffers();
+}
+
+static std::map<std::string, std::string> read_all(const std::string& path) {
+  std::map<std::string, std::string> out;
+  touca::ResultLog::read(path, [&out](const touca::ResultLog::Entry& entry,
+                                      const std::vector<uint8_t>& data) {
+    const auto& testcase = touca::deserialize_testcase(data);
+    CHECK(testcase.metadata().testcase == entry.testcase);
+    out.emplace(entry.testcase, testcase.overview().keysCount == 1
+                                    ? "valid"
+                                    : "invalid");
+  });
+  return out;
+}
+
+TEST_CASE("result log") {
+  TmpFile file;
+  const auto& path = file.path.string();
+
+  SECTION("missing file") {
+    CHECK_FALSE(touca::ResultLog::is_result_log(path));
+    CHECK_THROWS_AS(touca::ResultLog::read_index(path), std::runtime_error);
+  }
+
+  SECTION("not a result log") {
+    file.write("some content that is long enough to hold a trailer");
+    CHECK_FALSE(touca::ResultLog::is_result_log(path));
+    CHECK_THROWS_AS(touca::ResultLog(path), std::runtime_error);
+  }
+
+  SECTION("write and read") {
+    {
+      touca::ResultLog log(path);
+      log.append("some-case", make_message("some-case", 1));
+      log.append("other-case", make_message("other-case", 2));
+      log.append("some-case", make_message("some-case", 3));
+      CHECK(log.contains("some-case"));
+      CHECK_FALSE(log.contains("missing-case"));
+    }
+    CHECK(touca::ResultLog::is_result_log(path));
+    const auto& index = touca::ResultLog::read_index(path);
+    REQUIRE(index.size() == 2u);
+    CHECK(index[0].testcase == "some-case");
+    CHECK(index[1].testcase == "other-case");
+    CHECK(index[0].offset > index[1].offset);
+    CHECK(read_all(path).size() == 2u);
+  }
+
+  SECTION("resume after incomplete write") {
+    {
+      touca::ResultLog log(path);
+      log.append("some-case", make_message("some-case", 1));
+      log.append("other-case", make_message("other-case", 2));
+    }
+    // drop part of the index as if the run was interrupted while
+    // closing the log.
+    touca::filesystem::resize_file(
+        file.path, touca::filesystem::file_size(file.path) - 5u);
+    CHECK(touca::ResultLog::read_index(path).size() == 2u);
+    {
+      touca::ResultLog log(path);
+      CHECK(log.contains("some-case"));
+      CHECK(log.contains("other-case"));
+      log.append("third-case", make_message("third-case", 3));
+      log.close();
+    }
+    const auto& index = touca::ResultLog::read_index(path);
+    REQUIRE(index.size() == 3u);
+    CHECK(index[2].testcase == "third-case");
+    CHECK(read_all(path).size() == 3u);
+  }
+}
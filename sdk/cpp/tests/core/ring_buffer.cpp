@@ -0,0 +1,70 @@
+// Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/ring_buffer.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+TEST_CASE("ring buffer") {
+  SECTION("capacity") {
+    touca::detail::ring_buffer<int> buffer(5u);
+    CHECK(buffer.capacity() == 8u);
+  }
+
+  SECTION("push and pop") {
+    touca::detail::ring_buffer<std::string> buffer(4u);
+    std::string value;
+    CHECK_FALSE(buffer.try_pop(value));
+    for (auto i = 0; i < 4; ++i) {
+      value = std::to_string(i);
+      CHECK(buffer.try_push(value));
+    }
+    value = "overflow";
+    CHECK_FALSE(buffer.try_push(value));
+    CHECK(value == "overflow");
+    for (auto i = 0; i < 4; ++i) {
+      REQUIRE(buffer.try_pop(value));
+      CHECK(value == std::to_string(i));
+    }
+    CHECK_FALSE(buffer.try_pop(value));
+  }
+
+  SECTION("multiple producers") {
+    constexpr auto producer_count = 4;
+    constexpr auto item_count = 10000;
+    touca::detail::ring_buffer<int> buffer(64u);
+    std::vector<std::thread> producers;
+    for (auto p = 0; p < producer_count; ++p) {
+      producers.emplace_back([&buffer, p] {
+        for (auto i = 0; i < item_count; ++i) {
+          auto value = p * item_count + i;
+          while (!buffer.try_push(value)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    std::vector<int> last(producer_count, -1);
+    auto received = 0;
+    auto in_order = true;
+    while (received < producer_count * item_count) {
+      int value;
+      if (!buffer.try_pop(value)) {
+        std::this_thread::yield();
+        continue;
+      }
+      const auto producer = value / item_count;
+      in_order &= last[producer] < value % item_count;
+      last[producer] = value % item_count;
+      ++received;
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    CHECK(in_order);
+    CHECK(received == producer_count * item_count);
+  }
+}
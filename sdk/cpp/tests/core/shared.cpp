@@ -2,8 +2,11 @@
 
 #include "tests/core/shared.hpp"
 
+#include "catch2/catch.hpp"
 #include "rapidjson/document.h"
 #include "rapidjson/writer.h"
+#include "touca/core/deserialize.hpp"
+#include "touca/impl/schema.hpp"
 
 std::string make_json(
     const std::function<rapidjson::Value(touca::RJAllocator&)> func) {
@@ -17,3 +20,20 @@ std::string make_json(
   value.Accept(writer);
   return strbuf.GetString();
 }
+
+std::string serialize(const touca::data_point& value) {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto& wrapper = value.serialize(builder);
+  builder.Finish(wrapper);
+  const auto& ptr = builder.GetBufferPointer();
+  return {ptr, ptr + builder.GetSize()};
+}
+
+touca::data_point deserialize(const std::string& buffer) {
+  using namespace touca;
+  using namespace flatbuffers;
+  Verifier verifier((const uint8_t*)buffer.data(), buffer.size());
+  CHECK(verifier.VerifyBuffer<fbs::TypeWrapper>());
+  const auto& wrapper = GetRoot<fbs::TypeWrapper>(buffer.data());
+  return deserialize_value(wrapper);
+}
@@ -27,3 +27,11 @@ struct touca::serializer<Head> {
  */
 std::string make_json(
     const std::function<rapidjson::Value(touca::RJAllocator&)> func);
+
+/**
+ * Helper functions to serialize a value into a flatbuffers buffer and
+ * to read it back, as done when saving and loading result files.
+ */
+std::string serialize(const touca::data_point& value);
+
+touca::data_point deserialize(const std::string& buffer);
@@ -6,7 +6,10 @@
 
 #include "catch2/catch.hpp"
 #include "tests/core/shared.hpp"
+#include "tests/core/tmpfile.hpp"
 #include "touca/core/comparison.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/filesystem.hpp"
 
 using touca::data_point;
 using touca::detail::internal_type;
@@ -188,5 +191,174 @@ TEST_CASE("Testcase") {
       const auto metric = testcase.metrics().at("b");
       CHECK(internal_type::number_signed == metric.value.type());
     }
+
+    SECTION("add_metric_summary") {
+      const auto& summary =
+          touca::MetricSummary::from_samples({14, 10, 12, 11, 13});
+      CHECK(summary.count == 5u);
+      CHECK(summary.min == 10.0);
+      CHECK(summary.median == 12.0);
+      CHECK(summary.mean == 12.0);
+      CHECK(summary.p90 == Approx(13.6));
+      CHECK(summary.stddev == Approx(1.5811).epsilon(1e-4));
+
+      testcase.add_metric("some-key", 1000);
+      testcase.add_metric_summary("some-key", summary);
+      REQUIRE(testcase.metrics().size() == 1);
+      const auto& value = testcase.metrics().at("some-key").value;
+      CHECK(internal_type::object == value.type());
+      CHECK(testcase.overview().metricsDuration == 12);
+
+      const auto& copy = touca::deserialize_testcase(testcase.flatbuffers());
+      touca::MetricSummary parsed;
+      REQUIRE(touca::MetricSummary::from_data_point(
+          copy.metrics().at("some-key").value, parsed));
+      CHECK(parsed.count == 5u);
+      CHECK(parsed.p90 == Approx(13.6));
+    }
+
+    SECTION("add_counter") {
+      testcase.add_metric("some-key", 10);
+      testcase.add_counter("some-key.instructions", 1000u);
+      testcase.add_counter("some-key.instructions", 500u);
+      REQUIRE(testcase.metrics().size() == 2);
+      CHECK(testcase.overview().metricsCount == 2);
+      CHECK(testcase.overview().metricsDuration == 10);
+
+      const auto& copy = touca::deserialize_testcase(testcase.flatbuffers());
+      const auto& value = copy.metrics().at("some-key.instructions").value;
+      REQUIRE(internal_type::number_unsigned == value.type());
+      CHECK(value.as_number_unsigned() == 1500u);
+    }
+
+    SECTION("add_profile_sample") {
+      testcase.add_profile_sample("outer;inner", 300, 300);
+      testcase.add_profile_sample("outer;inner", 200, 200);
+      testcase.add_profile_sample("outer", 1000, 500);
+      REQUIRE(testcase.metrics().size() == 1);
+      CHECK(testcase.metrics().count("__profile__"));
+
+      const auto& copy = touca::deserialize_testcase(testcase.flatbuffers());
+      touca::ProfileMap parsed;
+      REQUIRE(touca::profile_from_data_point(
+          copy.metrics().at("__profile__").value, parsed));
+      REQUIRE(parsed.size() == 2u);
+      CHECK(parsed.at("outer").calls == 1u);
+      CHECK(parsed.at("outer").self == 500u);
+      CHECK(parsed.at("outer;inner").calls == 2u);
+      CHECK(parsed.at("outer;inner").total == 500u);
+    }
+  }
+
+  SECTION("many keys") {
+    for (auto i = 0; i < 10000; ++i) {
+      testcase.check(touca::detail::format("key-{:05}", 9999 - i),
+                     data_point::number_signed(i));
+    }
+    testcase.add_metric("metric-b", 20);
+    testcase.add_metric("metric-a", 10);
+    testcase.tic("metric-c");
+    const auto& overview = testcase.overview();
+    CHECK(overview.keysCount == 10000);
+    CHECK(overview.metricsCount == 2);
+    CHECK(overview.metricsDuration == 30);
+    const auto output = make_json([&testcase](touca::RJAllocator& allocator) {
+      return testcase.json(allocator);
+    });
+    CHECK_THAT(output,
+               Catch::Contains(
+                   R"("results":[{"key":"key-00000","value":"9999"},{"key":"key-00001","value":"9998"},)"));
+    CHECK_THAT(
+        output,
+        Catch::Contains(
+            R"("metrics":[{"key":"metric-a","value":"10"},{"key":"metric-b","value":"20"}])"));
+  }
+
+  SECTION("spill to disk") {
+    TmpFile spillFile;
+    // left behind by a previous run that did not remove it
+    spillFile.write("stale");
+    touca::Testcase expected = testcase;
+    testcase.set_memory_budget(64, spillFile.path.string());
+    const auto& capture = [](touca::Testcase& tc) {
+      for (auto i = 0; i < 100; ++i) {
+        tc.add_array_element("some-array", data_point::number_signed(i));
+        tc.add_hit_count("some-hit-count");
+      }
+      tc.check("some-string", data_point::string("some-value"));
+      tc.check("some-string", data_point::string("some-other-value"));
+      tc.assume("some-assumption", data_point::string("some-value"));
+    };
+    capture(expected);
+    capture(testcase);
+    CHECK(touca::filesystem::exists(spillFile.path));
+    CHECK(testcase.memory_usage() < expected.memory_usage());
+    CHECK(testcase.overview().keysCount == 4);
+    CHECK_THROWS_AS(testcase.add_hit_count("some-array"),
+                    std::invalid_argument);
+
+    const auto& to_json = [](const touca::Testcase& tc) {
+      return make_json([&tc](touca::RJAllocator& allocator) {
+        return tc.json(allocator);
+      });
+    };
+    CHECK(to_json(testcase) == to_json(expected));
+    const auto& restored = touca::deserialize_testcase(testcase.flatbuffers());
+    CHECK(to_json(restored) == to_json(expected));
+
+    {
+      touca::Testcase copy = testcase;
+      testcase.clear();
+      CHECK(touca::filesystem::exists(spillFile.path));
+      CHECK(to_json(copy) == to_json(expected));
+    }
+    CHECK_FALSE(touca::filesystem::exists(spillFile.path));
+    CHECK(testcase.memory_usage() == 0u);
+  }
+
+  SECTION("merge") {
+    testcase.check("some-key", data_point::string("some-value"));
+    testcase.add_counter("some-counter", 1u);
+    touca::Testcase other("some-team", "some-suite", "some-version",
+                          "some-case");
+    other.check("some-key", data_point::string("some-other-value"));
+    other.check("other-key", data_point::boolean(true));
+    other.add_counter("some-counter", 2u);
+    other.add_metric("some-metric", 10u);
+    testcase.merge(other);
+    const auto& output = make_json([&testcase](touca::RJAllocator& allocator) {
+      return testcase.json(allocator);
+    });
+    CHECK_THAT(output,
+               Catch::Contains(R"({"key":"some-key","value":"some-value"})"));
+    CHECK_THAT(output,
+               Catch::Contains(R"({"key":"other-key","value":"true"})"));
+    const auto& metrics = testcase.metrics();
+    CHECK(metrics.count("some-metric"));
+    CHECK(metrics.at("some-counter").value.as_number_unsigned() == 3u);
+  }
+
+  SECTION("memory total") {
+    TmpFile spillFile;
+    const auto& total = std::make_shared<std::atomic<std::size_t>>(0u);
+    testcase.set_memory_total(total);
+    testcase.check("some-string", data_point::string("some-value"));
+    testcase.add_hit_count("some-hit-count");
+    CHECK(*total == testcase.memory_usage());
+    {
+      touca::Testcase other("some-team", "some-suite", "some-version",
+                            "some-other-case");
+      other.set_memory_total(total);
+      other.check("some-string", data_point::string("some-value"));
+      touca::Testcase copy = other;
+      copy.check("some-other-string", data_point::string("some-value"));
+      CHECK(*total == testcase.memory_usage() + other.memory_usage());
+    }
+    CHECK(*total == testcase.memory_usage());
+    testcase.set_memory_budget(0u, spillFile.path.string());
+    CHECK(testcase.spill() != 0u);
+    CHECK(*total == testcase.memory_usage());
+    testcase.clear();
+    CHECK(*total == 0u);
   }
 }
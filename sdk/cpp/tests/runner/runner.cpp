@@ -2,7 +2,15 @@
 
 #include "touca/runner/runner.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "catch2/catch.hpp"
 #include "fmt/ostream.h"
@@ -10,6 +18,7 @@
 #include "tests/core/tmpfile.hpp"
 #include "touca/core/config.hpp"
 #include "touca/core/utils.hpp"
+#include "touca/extra/allocations.hpp"
 #include "touca/runner/detail/helpers.hpp"
 #include "touca/touca.hpp"
 
@@ -282,7 +291,8 @@ TEST_CASE("framework-simple-workflow-valid-use") {
         ResultChecker(fnames({outputDir.path})).get_regular_files("some-suite");
     fnames suiteDirs =
         ResultChecker(fnames({outputDir.path})).get_directories("some-suite");
-    CHECK(suiteFiles.empty());
+    CHECK_THAT(suiteFiles,
+               Catch::UnorderedEquals(fnames({"durations.json"})));
     CHECK_THAT(suiteDirs, Catch::UnorderedEquals(fnames({"1.0"})));
 
     fnames revisionFiles = ResultChecker(fnames({outputDir.path, "some-suite"}))
@@ -367,3 +377,424 @@ TEST_CASE("framework-redirect-output-disabled") {
   }
   touca::reset_test_runner();
 }
+
+TEST_CASE("framework-result-log") {
+  using fnames = std::vector<touca::filesystem::path>;
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  const std::vector<std::string> args = {
+      "--offline", "-r", "1.0", "-o", outputDir.path.string(), "--team",
+      "some-team", "--suite", "some-suite", "--testcase", "4,8,15,16,23,42",
+      "--result-log", "--colored-output=false"};
+  caller.call_with(args);
+
+  SECTION("first-run") {
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("5 passed, 1 failed, 6 total"));
+    CHECK(caller.cerr().empty());
+  }
+
+  SECTION("directory-structure") {
+    fnames revisionFiles = ResultChecker(fnames({outputDir.path, "some-suite"}))
+                               .get_regular_files("1.0");
+    fnames revisionDirs = ResultChecker(fnames({outputDir.path, "some-suite"}))
+                              .get_directories("1.0");
+    CHECK_THAT(revisionFiles,
+               Catch::UnorderedEquals(
+                   fnames({"Console.log", "touca.log", "touca.results"})));
+    CHECK_THAT(revisionDirs, Catch::UnorderedEquals(fnames({"8"})));
+
+    const auto& logFile =
+        outputDir.path / "some-suite" / "1.0" / "touca.results";
+    const auto& index = touca::ResultLog::read_index(logFile.string());
+    CHECK(index.size() == 5u);
+  }
+
+  SECTION("second-run-without-overwrite") {
+    caller.call_with(args);
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("5.  SKIP   23"));
+    CHECK_THAT(caller.cout(), Catch::Contains("5 skipped, 1 failed, 6 total"));
+    CHECK(caller.cerr().empty());
+  }
+  touca::reset_test_runner();
+}
+
+struct CollectingSink : public touca::Sink {
+  CollectingSink(std::vector<std::string>& events) : _events(events) {}
+
+  void log(const touca::Sink::Level, const std::string& event) override {
+    _events.push_back(event);
+  }
+
+ private:
+  std::vector<std::string>& _events;
+};
+
+TEST_CASE("framework-custom-sink") {
+  std::vector<std::string> events;
+  touca::workflow("dummy_workflow", dummy_workflow);
+  touca::add_sink(touca::detail::make_unique<CollectingSink>(events),
+                  touca::Sink::Level::Info);
+  MainCaller caller;
+  TmpFile outputDir;
+  caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                    "--team", "some-team", "--suite", "some-suite",
+                    "--testcase", "some-case", "--colored-output=false"});
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(events, Catch::VectorContains(
+                         std::string("processing testcase: some-case")));
+  CHECK_THAT(events, Catch::VectorContains(std::string("completed workflow")));
+  touca::reset_test_runner();
+}
+
+TEST_CASE("framework-live-progress") {
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                    "--team", "some-team", "--suite", "some-suite",
+                    "--testcase", "4,8,15,16,23,42", "--live-progress",
+                    "--colored-output=false"});
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(caller.cout(), !Catch::Contains("5.  PASS   23"));
+  CHECK_THAT(caller.cout(), Catch::Contains("6.  FAIL   42    (0 ms)"));
+  CHECK_THAT(caller.cout(), Catch::Contains("- some-error"));
+  CHECK_THAT(caller.cout(),
+             Catch::Contains(
+                 "Progress: 6/6, 5 passed, 0 skipped, 1 failed\n"));
+  CHECK_THAT(caller.cout(), Catch::Contains("5 passed, 1 failed, 6 total"));
+  CHECK(caller.cerr().empty());
+
+  const auto& content = touca::detail::load_string_file(
+      (outputDir.path / "some-suite" / "1.0" / "Console.log").string());
+  CHECK_THAT(content, Catch::Contains("5.  PASS   23    (0 ms)"));
+  CHECK_THAT(content, Catch::Contains("6.  FAIL   42    (0 ms)"));
+  CHECK_THAT(content, !Catch::Contains("Progress:"));
+  touca::reset_test_runner();
+}
+
+TEST_CASE("framework-descriptor-capturer") {
+  TmpFile outputDir;
+  const auto& stdout_path = outputDir.path / "stdout.txt";
+  const auto& stderr_path = outputDir.path / "stderr.txt";
+
+  SECTION("no output") {
+    touca::DescriptorCapturer capturer(outputDir.path, 0u);
+    capturer.start_capture();
+    capturer.stop_capture();
+    CHECK_FALSE(touca::filesystem::exists(stdout_path));
+    CHECK_FALSE(touca::filesystem::exists(stderr_path));
+  }
+
+  SECTION("output of c functions") {
+    touca::DescriptorCapturer capturer(outputDir.path, 0u);
+    capturer.start_capture();
+    std::printf("message in output stream\n");
+    std::fprintf(stderr, "message in error stream\n");
+    capturer.stop_capture();
+    CHECK(touca::detail::load_string_file(stdout_path.string()) ==
+          "message in output stream\n");
+    CHECK(touca::detail::load_string_file(stderr_path.string()) ==
+          "message in error stream\n");
+  }
+
+  SECTION("size limit") {
+    touca::DescriptorCapturer capturer(outputDir.path, 10u);
+    capturer.start_capture();
+    std::printf("0123456789abcdef");
+    capturer.stop_capture();
+    CHECK(touca::detail::load_string_file(stdout_path.string()) ==
+          "0123456789\n[output truncated: 6 bytes omitted]\n");
+    CHECK_FALSE(touca::filesystem::exists(stderr_path));
+  }
+
+#ifndef _WIN32
+  SECTION("child processes that outlive the capture") {
+    touca::DescriptorCapturer capturer(outputDir.path, 0u);
+    capturer.start_capture();
+    const auto status = std::system("sleep 5 &");
+    const auto& tic = std::chrono::steady_clock::now();
+    capturer.stop_capture();
+    CHECK(status == 0);
+    CHECK(std::chrono::steady_clock::now() - tic < std::chrono::seconds(4));
+  }
+#endif
+}
+
+#ifndef _WIN32
+TEST_CASE("framework-isolate") {
+  using fnames = std::vector<touca::filesystem::path>;
+  touca::workflow("crashing_workflow", [](const std::string& testcase) {
+    if (testcase == "crash") {
+      std::abort();
+    }
+    simple_workflow(testcase);
+    std::thread([] { touca::check("spawned-number", 2048); }).join();
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                    "--team", "some-team", "--suite", "some-suite",
+                    "--testcase", "4,crash,15,42", "--isolate", "--workers",
+                    "2", "--save-as-json", "--colored-output=false"});
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(caller.cout(), Catch::Contains("FAIL   crash"));
+  CHECK_THAT(caller.cout(), Catch::Contains("terminated by signal"));
+  CHECK_THAT(caller.cout(), Catch::Contains("- some-error"));
+  CHECK_THAT(caller.cout(), Catch::Contains("2 passed, 2 failed, 4 total"));
+  CHECK(caller.cerr().empty());
+
+  const auto& caseFiles =
+      ResultChecker(fnames({outputDir.path, "some-suite", "1.0"}))
+          .get_regular_files("4");
+  CHECK_THAT(caseFiles,
+             Catch::UnorderedEquals(fnames({"touca.bin", "touca.json"})));
+  const auto& content = touca::detail::load_string_file(
+      (outputDir.path / "some-suite" / "1.0" / "4" / "touca.json").string());
+  CHECK_THAT(content, Catch::Contains("some-number"));
+  CHECK_THAT(content, Catch::Contains("spawned-number"));
+  touca::reset_test_runner();
+}
+#endif
+
+TEST_CASE("framework-timeout") {
+  touca::workflow("slow_workflow", [](const std::string& testcase) {
+    if (testcase == "slow") {
+      std::this_thread::sleep_for(std::chrono::seconds(2));
+    }
+    touca::check("some-number", 1024);
+    std::thread([] { touca::check("spawned-number", 2048); }).join();
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  std::vector<std::string> args = {
+      "--offline", "-r", "1.0", "-o", outputDir.path.string(), "--team",
+      "some-team", "--suite", "some-suite", "--testcase", "4,slow,15",
+      "--timeout", "1", "--save-as-json", "--colored-output=false"};
+
+  SECTION("in-process") {
+    caller.call_with(args);
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("TIME   slow"));
+    CHECK_THAT(caller.cout(), Catch::Contains("- timed out after 1 s"));
+    CHECK_THAT(caller.cout(),
+               Catch::Contains("2 passed, 1 timed out, 3 total"));
+    const auto& version_dir = outputDir.path / "some-suite" / "1.0";
+    CHECK(touca::filesystem::exists(version_dir / "15" / "touca.bin"));
+    CHECK_FALSE(touca::filesystem::exists(version_dir / "slow" / "touca.bin"));
+    const auto& content = touca::detail::load_string_file(
+        (version_dir / "15" / "touca.json").string());
+    CHECK_THAT(content, Catch::Contains("some-number"));
+    CHECK_THAT(content, Catch::Contains("spawned-number"));
+  }
+
+#ifndef _WIN32
+  SECTION("isolated") {
+    args.push_back("--isolate");
+    caller.call_with(args);
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("TIME   slow"));
+    CHECK_THAT(caller.cout(), Catch::Contains("- timed out after 1 s"));
+    CHECK_THAT(caller.cout(),
+               Catch::Contains("2 passed, 1 timed out, 3 total"));
+  }
+#endif
+  touca::reset_test_runner();
+}
+
+TEST_CASE("framework-shards") {
+  const std::vector<std::string> testcases = {"a", "b", "c", "d", "e", "f"};
+
+  SECTION("hash") {
+    std::vector<std::string> all;
+    for (auto i = 0u; i < 3u; ++i) {
+      const auto& shard = touca::select_shard(testcases, i, 3u, {});
+      CHECK(shard == touca::select_shard(testcases, i, 3u, {}));
+      all.insert(all.end(), shard.begin(), shard.end());
+    }
+    std::sort(all.begin(), all.end());
+    CHECK(all == testcases);
+  }
+
+  SECTION("durations") {
+    const std::unordered_map<std::string, unsigned long long> durations = {
+        {"a", 10}, {"b", 9}, {"c", 2}, {"d", 1}, {"f", 4}};
+    // "e" is expected to take the average duration of the others.
+    const auto& first = touca::select_shard(testcases, 0u, 2u, durations);
+    const auto& second = touca::select_shard(testcases, 1u, 2u, durations);
+    CHECK(first == std::vector<std::string>{"a", "c", "f"});
+    CHECK(second == std::vector<std::string>{"b", "d", "e"});
+  }
+
+  SECTION("sync-dir") {
+    touca::workflow("simple_workflow", simple_workflow);
+    MainCaller caller;
+    TmpFile outputDir;
+    caller.call_with({"--api-url", "https://api.example.com/@/some-team",
+                      "-r", "1.0", "-o", outputDir.path.string(), "--team",
+                      "some-team", "--suite", "some-suite", "--testcase", "4",
+                      "--shard-count", "2"});
+    CHECK(caller.exit_code() == EXIT_FAILURE);
+    CHECK_THAT(caller.cerr(),
+               Catch::Contains("option \"--shard-sync-dir\" is required"));
+    touca::reset_test_runner();
+  }
+}
+
+TEST_CASE("framework-order") {
+  SECTION("order-by-duration") {
+    const std::vector<std::string> testcases = {"a", "b", "c", "d"};
+    CHECK(touca::order_by_duration(testcases, {}) == testcases);
+    const std::unordered_map<std::string, unsigned long long> durations = {
+        {"a", 1}, {"b", 7}, {"d", 7}};
+    // "c" is expected to take the average duration of the others.
+    CHECK(touca::order_by_duration(testcases, durations) ==
+          std::vector<std::string>{"b", "d", "c", "a"});
+  }
+
+  SECTION("longest-first") {
+    touca::workflow("simple_workflow", simple_workflow);
+    MainCaller caller;
+    TmpFile outputDir;
+    const auto& history = outputDir.path / "some-suite" / "durations.json";
+    touca::filesystem::create_directories(history.parent_path());
+    std::ofstream(history.string()) << R"({"4": 1, "15": 100})";
+    caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                      "--team", "some-team", "--suite", "some-suite",
+                      "--testcase", "4,42,15", "--order", "longest-first",
+                      "--colored-output=false"});
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("1.  PASS   15"));
+    CHECK_THAT(caller.cout(), Catch::Contains("2.  FAIL   42"));
+    CHECK_THAT(caller.cout(), Catch::Contains("3.  PASS   4"));
+    const auto& durations = touca::load_durations(history);
+    CHECK(durations.size() == 3u);
+    CHECK(durations.count("42"));
+    touca::reset_test_runner();
+  }
+
+  SECTION("input") {
+    touca::workflow("simple_workflow", simple_workflow);
+    MainCaller caller;
+    TmpFile outputDir;
+    const auto& history = outputDir.path / "some-suite" / "durations.json";
+    touca::filesystem::create_directories(history.parent_path());
+    std::ofstream(history.string()) << R"({"4": 1, "15": 100})";
+    caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                      "--team", "some-team", "--suite", "some-suite",
+                      "--testcase", "4,42", "--colored-output=false"});
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("1.  PASS   4"));
+    const auto& durations = touca::load_durations(history);
+    CHECK(durations.size() == 3u);
+    CHECK(durations.count("15"));
+    CHECK(durations.count("42"));
+    touca::reset_test_runner();
+  }
+}
+
+TEST_CASE("framework-repeat") {
+  auto calls = 0u;
+  touca::workflow("repeated_workflow", [&calls](const std::string& testcase) {
+    ++calls;
+    touca::check("some-number", 1024);
+    touca::add_metric("some-metric", calls);
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                    "--team", "some-team", "--suite", "some-suite",
+                    "--testcase", "4", "--repeat", "3", "--warmup", "2",
+                    "--save-as-json", "--colored-output=false"});
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK(calls == 5u);
+  const auto& content = touca::detail::load_string_file(
+      (outputDir.path / "some-suite" / "1.0" / "4" / "touca.json").string());
+  CHECK_THAT(content, Catch::Contains("some-number"));
+  CHECK_THAT(content, Catch::Contains(R"(\"median\":4.0)"));
+  touca::reset_test_runner();
+}
+
+TEST_CASE("framework-memory-metrics") {
+  touca::workflow("allocating_workflow", [](const std::string& testcase) {
+    std::vector<std::unique_ptr<int>> numbers;
+    for (auto i = 0; i < 100; ++i) {
+      numbers.emplace_back(new int(i));
+    }
+    touca::check("some-number", static_cast<int>(numbers.size()));
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                    "--team", "some-team", "--suite", "some-suite",
+                    "--testcase", "4", "--memory-metrics", "--save-as-json",
+                    "--colored-output=false"});
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(caller.cout(), Catch::Contains(" allocations)"));
+  const auto& content = touca::detail::load_string_file(
+      (outputDir.path / "some-suite" / "1.0" / "4" / "touca.json").string());
+  CHECK_THAT(content, Catch::Contains("__allocations__"));
+  CHECK_THAT(content, Catch::Contains("__allocated_bytes__"));
+#ifdef __linux__
+  CHECK_THAT(caller.cout(), Catch::Contains("MB peak"));
+  CHECK_THAT(content, Catch::Contains("__peak_rss__"));
+#endif
+  touca::reset_test_runner();
+}
+
+TEST_CASE("framework-parallel-workflows") {
+  touca::workflow("workflow-a", [](const std::string& testcase) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    touca::check("key-a", testcase);
+  });
+  touca::workflow("workflow-b", [](const std::string& testcase) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::thread worker(
+        touca::bind_client([&testcase] { touca::check("key-b", testcase); }));
+    worker.join();
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+
+  SECTION("suite-per-workflow") {
+    caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                      "--team", "some-team", "--testcase", "4", "--testcase",
+                      "8", "--parallel-workflows", "2", "--save-as-json",
+                      "--colored-output=false"});
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("Suite: workflow-a/1.0"));
+    CHECK_THAT(caller.cout(), Catch::Contains("Suite: workflow-b/1.0"));
+    CHECK_THAT(caller.cout(), Catch::Contains("[workflow-a] 1.  PASS   4"));
+    CHECK_THAT(caller.cout(), Catch::Contains("[workflow-b] 2.  PASS   8"));
+    CHECK(caller.cerr().empty());
+    const auto& load = [&outputDir](const std::string& suite) {
+      return touca::detail::load_string_file(
+          (outputDir.path / suite / "1.0" / "8" / "touca.json").string());
+    };
+    CHECK_THAT(load("workflow-a"), Catch::Contains("key-a"));
+    CHECK_THAT(load("workflow-a"), !Catch::Contains("key-b"));
+    CHECK_THAT(load("workflow-b"), Catch::Contains("key-b"));
+    CHECK_THAT(load("workflow-b"), !Catch::Contains("key-a"));
+  }
+
+  SECTION("explicit-suite") {
+    caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                      "--team", "some-team", "--suite", "some-suite",
+                      "--testcase", "4", "--parallel-workflows", "2"});
+    CHECK(caller.exit_code() == EXIT_FAILURE);
+    CHECK_THAT(caller.cerr(), Catch::Contains("option \"--suite\" is not "
+                                              "supported when workflows run "
+                                              "in parallel"));
+  }
+
+  SECTION("sequential-without-suite") {
+    caller.call_with({"--offline", "-r", "1.0", "-o", outputDir.path.string(),
+                      "--team", "some-team", "--testcase", "4"});
+    CHECK(caller.exit_code() == EXIT_FAILURE);
+    CHECK_THAT(caller.cerr(), Catch::Contains(" - suite"));
+  }
+
+  touca::reset_test_runner();
+}